@@ -0,0 +1,92 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_accumulator.h>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Compares the speed and accuracy of accumulating a long run of small
+// increments, using a naive long double Quantity total as the baseline.
+
+constexpr int count = 50000000;
+
+template <class Summation>
+void benchmarkSummation(const char* name, const std::vector<double>& steps,
+			long double exact)
+{
+	QuantityAccumulator<Energy, Summation> total;
+	double seconds = timeSeconds([&] {
+		for (double step : steps) {
+			total += Energy(step);
+		}
+	});
+	doNotOptimize(total);
+	report(name, seconds, steps.size());
+	std::printf("%-40s %10.3Le relative error\n", "",
+		    std::fabs(total.Total().Value() - exact) / exact);
+}
+
+int main() {
+	std::vector<double> steps(count);
+	for (int i = 0; i < count; ++i) {
+		steps[i] = 0.1 * (1 + i % 7);
+	}
+
+	// Compensated long double summation is accurate far beyond what any of
+	// the double precision totals can resolve, so it serves as the reference.
+	QuantityAccumulator<Energy, NeumaierSummation<long double>> reference;
+	for (double step : steps) {
+		reference += Energy(step);
+	}
+	long double exact = reference.Total().Value();
+
+	Energy naiveLongDouble = 0_J;
+	double seconds = timeSeconds([&] {
+		for (double step : steps) {
+			naiveLongDouble += Energy(step);
+		}
+	});
+	doNotOptimize(naiveLongDouble);
+	report("naive long double", seconds, count);
+	std::printf("%-40s %10.3Le relative error\n", "",
+		    std::fabs(naiveLongDouble.Value() - exact) / exact);
+
+	double naiveDouble = 0;
+	seconds = timeSeconds([&] {
+		for (double step : steps) {
+			naiveDouble += step;
+		}
+	});
+	doNotOptimize(naiveDouble);
+	report("naive double", seconds, count);
+	std::printf("%-40s %10.3Le relative error\n", "",
+		    std::fabs(naiveDouble - exact) / exact);
+
+	benchmarkSummation<KahanSummation<>>("kahan double", steps, exact);
+	benchmarkSummation<NeumaierSummation<>>("neumaier double", steps, exact);
+	benchmarkSummation<PairwiseSummation<>>("pairwise double", steps, exact);
+}
@@ -0,0 +1,80 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_atomic.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures the cost of adding to a shared total from 1 to 64 threads, using a
+// mutex-protected Quantity as the baseline.
+
+constexpr int addsPerThread = 1000000;
+
+template <class Add>
+double contend(int threadCount, Add add) {
+	return timeSeconds([&] {
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i) {
+			threads.emplace_back([&] {
+				for (int j = 0; j < addsPerThread; ++j) {
+					add();
+				}
+			});
+		}
+		for (std::thread& t : threads) {
+			t.join();
+		}
+	});
+}
+
+int main() {
+	for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+		double operations = double(threadCount) * addsPerThread;
+		std::string suffix = " x" + std::to_string(threadCount);
+
+		std::mutex mutex;
+		Energy locked = 0_J;
+		report("mutex" + suffix, contend(threadCount, [&] {
+			std::lock_guard<std::mutex> lock(mutex);
+			locked += 1_J;
+		}), operations);
+		doNotOptimize(locked);
+
+		AtomicQuantity<Energy> atomic;
+		report("atomic" + suffix, contend(threadCount, [&] {
+			atomic.fetch_add(1_J, std::memory_order_relaxed);
+		}), operations);
+		doNotOptimize(atomic.load());
+
+		ShardedQuantityAccumulator<Energy> sharded;
+		report("sharded" + suffix, contend(threadCount, [&] {
+			sharded += 1_J;
+		}), operations);
+		doNotOptimize(sharded.Load());
+	}
+}
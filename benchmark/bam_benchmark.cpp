@@ -0,0 +1,104 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_bam.h>
+#include <btul_trig.h>
+
+#include <cmath>
+#include <vector>
+
+// Compares binary angles against double-valued Angles: advancing a set of
+// headings with wraparound, where the floating version needs an fmod, and
+// taking their sines.
+
+typedef Quantity<0, 0, 0, 0, 0, 0, 0, double, AngleFormat> FastAngle;
+
+constexpr std::size_t count = 1 << 16;
+constexpr int repetitions = 200;
+constexpr double twoPi = 6.283185307179586;
+
+int main() {
+	std::vector<FastAngle> angles(count);
+	std::vector<FastAngle> angleSteps(count);
+	std::vector<BinaryAngle32> headings(count);
+	std::vector<BinaryAngle32> headingSteps(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		angles[i] = FastAngle(twoPi * i / count);
+		angleSteps[i] = FastAngle(0.001 * (i % 100));
+		headings[i] = BinaryAngle32(angles[i]);
+		headingSteps[i] = BinaryAngle32(angleSteps[i]);
+	}
+
+	report("advance Angle with fmod", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				angles[i] = FastAngle(std::fmod((angles[i] + angleSteps[i]).Value(),
+								twoPi));
+			}
+			doNotOptimize(angles[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("advance BinaryAngle32", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				headings[i] += headingSteps[i];
+			}
+			doNotOptimize(headings[0]);
+		}
+	}), double(count) * repetitions);
+
+	std::vector<double> sines(count);
+	report("sin via Value()", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				sines[i] = std::sin(angles[i].Value());
+			}
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("sin Angle span, PreciseTrig", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			sin(QuantitySpan<const FastAngle>(angles), QuantitySpan<double>(sines));
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("sin BinaryAngle32 span, PreciseTrig", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			sin(QuantitySpan<const BinaryAngle32>(headings), QuantitySpan<double>(sines));
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("sin BinaryAngle32 span, FastTrig", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			sin<FastTrig>(QuantitySpan<const BinaryAngle32>(headings),
+				      QuantitySpan<double>(sines));
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+}
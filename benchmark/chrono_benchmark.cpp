@@ -0,0 +1,94 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_chrono.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Converts ten million nanosecond timestamps to Time with FromDuration, and
+// by way of a long double std::chrono::duration, and to TickTime; then sums
+// the intervals between them as TickTime and as Time.  Times are per
+// timestamp.
+
+constexpr int count = 10000000;
+
+int main() {
+	std::mt19937_64 engine(1);
+	std::uniform_int_distribution<std::int64_t> gaps(0, 2000000);
+	std::vector<std::chrono::nanoseconds> stamps;
+	std::int64_t stamp = 1700000000000000000;
+	for (int i = 0; i < count; ++i) {
+		stamp += gaps(engine);
+		stamps.push_back(std::chrono::nanoseconds(stamp));
+	}
+
+	// Neither Quantity initializes its value, so touch the pages first.
+	std::vector<Time> times(count, 0_s);
+	std::vector<TickTime<>> ticks(count, TickTime<>(0_s));
+	report("duration<long double> to Time", timeSeconds([&] {
+		for (int i = 0; i < count; ++i) {
+			times[i] = Time(std::chrono::duration<long double>(stamps[i]).count());
+		}
+	}), count);
+	doNotOptimize(times[count / 2]);
+
+	report("FromDuration to Time", timeSeconds([&] {
+		for (int i = 0; i < count; ++i) {
+			times[i] = FromDuration(stamps[i]);
+		}
+	}), count);
+	doNotOptimize(times[count / 2]);
+
+	report("FromDuration to TickTime", timeSeconds([&] {
+		for (int i = 0; i < count; ++i) {
+			ticks[i] = FromDuration<TickTime<>>(stamps[i]);
+		}
+	}), count);
+	doNotOptimize(ticks[count / 2]);
+
+	Time floatingTotal = 0_s;
+	report("sum intervals, Time", timeSeconds([&] {
+		for (int i = 1; i < count; ++i) {
+			floatingTotal += times[i] - times[i - 1];
+		}
+	}), count);
+	doNotOptimize(floatingTotal);
+
+	TickTime<> total;
+	report("sum intervals, TickTime", timeSeconds([&] {
+		for (int i = 1; i < count; ++i) {
+			total += ticks[i] - ticks[i - 1];
+		}
+	}), count);
+	doNotOptimize(total);
+
+	std::printf("    exact %lld ns, Time off by %lld ns\n",
+		    (long long)total.Value().Count(),
+		    (long long)(ToDuration<std::chrono::nanoseconds>(floatingTotal).count() -
+				total.Value().Count()));
+}
@@ -0,0 +1,81 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_compare.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Counts how many computed values agree with their expected values, once
+// with a loop over Within() and once with the bulk comparisons, which make a
+// single branch-free pass over the data.
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+
+constexpr std::size_t count = 1 << 16;
+constexpr int repetitions = 200;
+
+int main() {
+	std::vector<FastLength> computed(count);
+	std::vector<FastLength> expected(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		expected[i] = FastLength(1.0 + i);
+		// Roughly half of the values are off by enough to fail.
+		computed[i] = FastLength((1.0 + i) * (1 + (i * 2654435761u % 7) * 1e-16));
+	}
+	QuantitySpan<const FastLength> computedSpan(computed);
+	QuantitySpan<const FastLength> expectedSpan(expected);
+
+	report("Within loop", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			std::size_t within = 0;
+			for (std::size_t i = 0; i < count; ++i) {
+				within += computed[i].Within(2e-16, expected[i]);
+			}
+			doNotOptimize(within);
+		}
+	}), double(count) * repetitions);
+
+	report("CountWithinTolerance", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			doNotOptimize(CountWithinTolerance(computedSpan, expectedSpan, 0_m, 2e-16));
+		}
+	}), double(count) * repetitions);
+
+	report("CountWithinUlps", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			doNotOptimize(CountWithinUlps(computedSpan, expectedSpan, 1));
+		}
+	}), double(count) * repetitions);
+
+	std::vector<std::uint8_t> mask(count);
+	report("MaskWithinUlps", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			MaskWithinUlps(computedSpan, expectedSpan, 1, QuantitySpan<std::uint8_t>(mask));
+			doNotOptimize(mask[0]);
+		}
+	}), double(count) * repetitions);
+}
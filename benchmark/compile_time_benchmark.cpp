@@ -0,0 +1,67 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <btul.h>
+#include <btul_math.h>
+
+#include <cstdio>
+#include <utility>
+
+// Not a runtime benchmark: `make compile-time` times the compilation of this
+// file, which instantiates a chain of DEPTH distinct quantity types and the
+// operators between them.  Each step multiplies by a square root of a Length,
+// so half the types in the chain have fractional exponents.  Defining
+// INTEGRAL multiplies by a whole Length instead, as a baseline.
+
+#ifndef DEPTH
+#define DEPTH 200
+#endif
+
+#ifdef INTEGRAL
+typedef Length Step;
+#else
+typedef decltype(sqrt(m)) Step;
+#endif
+
+template <int N>
+struct Chain {
+	typedef decltype(std::declval<typename Chain<N - 1>::type>() *
+			 std::declval<Step>()) type;
+
+	static type Run(long double x) {
+		type q = Chain<N - 1>::Run(x) * Step(x);
+		return q + q > q ? q - q / 2 : -q;
+	}
+};
+
+template <>
+struct Chain<0> {
+	typedef Quantity<0, 0, 0, 0, 0, 0, 0> type;
+
+	static type Run(long double x) {
+		return type(x);
+	}
+};
+
+int main() {
+	std::printf("%Lg\n", Chain<DEPTH>::Run(1.0L).Value());
+}
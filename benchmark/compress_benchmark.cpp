@@ -0,0 +1,100 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_compress.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compresses a million timed samples of a few kinds of series with
+// SeriesEncoder, and decodes them again.  Times are per sample; the ratio
+// and throughput are of the uncompressed series, a double for the time and
+// one for the value of each sample.  No recorded data comes with btul, so
+// "sensor" stands in for it: a 1 kHz series of readings from a 12-bit
+// converter, with the odd late sample, as recorded telemetry looks.
+
+typedef Quantity<0, 0, 0, 0, 1, 0, 0, double> FastTemperature;
+
+constexpr int samples = 1000000;
+
+static void run(const std::string& name, const std::vector<Time>& times,
+		const std::vector<FastTemperature>& values) {
+	double bytes = 16.0 * samples;
+	SeriesEncoder<FastTemperature> encoder;
+	double encodeSeconds = timeSeconds([&] {
+		encoder.ClearData();
+		encoder.Append(QuantitySpan<const Time>(times), QuantitySpan<const FastTemperature>(values));
+		encoder.Flush();
+	});
+	const std::vector<char>& data = encoder.Data();
+
+	std::vector<Time> timesRead(samples);
+	std::vector<FastTemperature> valuesRead(samples);
+	double decodeSeconds = timeSeconds([&] {
+		SeriesDecoder<FastTemperature> decoder(data.data(), data.size());
+		doNotOptimize(decoder.Decode(0, timesRead, valuesRead));
+	});
+	std::vector<FastTemperature> valuesOnly(samples);
+	double valuesSeconds = timeSeconds([&] {
+		SeriesDecoder<FastTemperature> decoder(data.data(), data.size());
+		doNotOptimize(decoder.Decode(0, valuesOnly));
+	});
+
+	std::printf("%s: %.2f bytes per sample, ratio %.1f\n",
+		    name.c_str(), double(data.size()) / samples, bytes / double(data.size()));
+	report("    encode", encodeSeconds, samples);
+	std::printf("        %.2f GB/s\n", bytes / encodeSeconds / 1e9);
+	report("    decode", decodeSeconds, samples);
+	std::printf("        %.2f GB/s\n", bytes / decodeSeconds / 1e9);
+	report("    decode values only", valuesSeconds, samples);
+	std::printf("        %.2f GB/s\n", 8.0 * samples / valuesSeconds / 1e9);
+}
+
+int main() {
+	std::mt19937_64 engine(1);
+	std::normal_distribution<double> noise(0, 1);
+	std::vector<Time> regular, jittered;
+	for (int i = 0; i < samples; ++i) {
+		regular.push_back(Time(1e9L + i * 1e-3L));
+		long late = engine() % 100 == 0 ? long(engine() % 200000) : 0;
+		jittered.push_back(Time(1e9L + i * 1e-3L + late * 1e-9L));
+	}
+
+	std::vector<FastTemperature> sensor, smooth, steps;
+	double level = 2000;
+	for (int i = 0; i < samples; ++i) {
+		level = std::max(0.0, std::min(4095.0, level + std::round(noise(engine))));
+		sensor.push_back(FastTemperature(273.15 + level * 0.025));
+		smooth.push_back(FastTemperature(293.15 + 5 * std::sin(i * 1e-4)));
+		steps.push_back(FastTemperature(293.15 + (i / 5000) % 7));
+	}
+
+	run("sensor", jittered, sensor);
+	run("smooth", regular, smooth);
+	run("steps", regular, steps);
+}
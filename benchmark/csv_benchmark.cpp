@@ -0,0 +1,150 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_csv.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// Reads a CSV file of three unit-annotated columns, about 100 MB, with
+// CsvReader on one thread and on every hardware thread, and with the usual
+// getline and strtod loop.  Times are per byte of the file, and the
+// throughput is printed as well.  The file is written to /tmp and is in the
+// page cache when it is read.
+//
+// Then writes the first million rows back out to /tmp with CsvWriter, and
+// with operator<< on each quantity.  Those times are per value.
+
+typedef Quantity<0, 0, 1, 0, 0, 0, 0, double> FastTime;
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, double> FastMass;
+
+constexpr int rows = 4000000;
+constexpr int writtenRows = 1000000;
+
+static void reportThroughput(const char* name, double seconds, double bytes) {
+	report(name, seconds, bytes);
+	std::printf("    %.2f GB/s\n", bytes / seconds / 1e9);
+}
+
+int main() {
+	char name[] = "/tmp/btul_csv_benchmark_XXXXXX";
+	int descriptor = mkstemp(name);
+	if (descriptor < 0) {
+		return 1;
+	}
+	close(descriptor);
+
+	{
+		std::mt19937_64 engine(1);
+		std::uniform_real_distribution<double> speeds(0, 130);
+		std::uniform_real_distribution<double> masses(500, 3000);
+		std::ofstream file(name);
+		file << "time [s],speed [km/h],mass [g]\n";
+		char line[128];
+		for (int i = 0; i < rows; ++i) {
+			int length = std::snprintf(line, sizeof(line), "%.3f,%.6g,%.8g\n",
+						   0.01 * i, speeds(engine), masses(engine));
+			file.write(line, length);
+		}
+	}
+	std::ifstream sizeStream(name, std::ios::binary | std::ios::ate);
+	double bytes = double(sizeStream.tellg());
+
+	std::vector<FastTime> times;
+	std::vector<FastSpeed> speeds;
+	std::vector<FastMass> masses;
+	auto readWith = [&](unsigned threads) {
+		CsvReader csv(name);
+		csv.Bind("time", times);
+		csv.Bind("speed", speeds);
+		csv.Bind("mass", masses);
+		doNotOptimize(csv.Read(threads));
+	};
+	readWith(1);
+
+	reportThroughput("CsvReader, 1 thread", timeSeconds([&] {
+		readWith(1);
+	}), bytes);
+
+	unsigned threads = std::thread::hardware_concurrency();
+	threads = threads == 0 ? 1 : threads;
+	std::string threadsName = "CsvReader, " + std::to_string(threads) + " threads";
+	reportThroughput(threadsName.c_str(), timeSeconds([&] {
+		readWith(threads);
+	}), bytes);
+
+	reportThroughput("getline and strtod", timeSeconds([&] {
+		std::ifstream file(name);
+		std::string line;
+		std::getline(file, line);
+		times.clear();
+		speeds.clear();
+		masses.clear();
+		while (std::getline(file, line)) {
+			char* p;
+			times.push_back(FastTime(std::strtod(line.c_str(), &p)));
+			speeds.push_back(FastSpeed(std::strtod(p + 1, &p) / 3.6));
+			masses.push_back(FastMass(std::strtod(p + 1, &p) / 1000));
+		}
+		doNotOptimize(times[0]);
+	}), bytes);
+
+	auto writeWith = [&](unsigned threads) {
+		std::ofstream file(name);
+		CsvWriter csv(file);
+		csv.Add("time", QuantitySpan<const FastTime>(times.data(), writtenRows));
+		csv.Add("speed", QuantitySpan<const FastSpeed>(speeds.data(), writtenRows));
+		csv.Add("mass", QuantitySpan<const FastMass>(masses.data(), writtenRows));
+		csv.Write(threads);
+	};
+
+	report("CsvWriter, 1 thread", timeSeconds([&] {
+		writeWith(1);
+	}), 3.0 * writtenRows);
+
+	threadsName = "CsvWriter, " + std::to_string(threads) + " threads";
+	report(threadsName.c_str(), timeSeconds([&] {
+		writeWith(threads);
+	}), 3.0 * writtenRows);
+
+	report("operator<<", timeSeconds([&] {
+		std::ofstream file(name);
+		file << "time,speed,mass\n";
+		for (int i = 0; i < writtenRows; ++i) {
+			file << times[i] << ',' << speeds[i] << ',' << masses[i] << '\n';
+		}
+	}), 3.0 * writtenRows);
+
+	std::remove(name);
+}
@@ -0,0 +1,96 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_dual.h>
+
+#include <array>
+#include <vector>
+
+// Computes the gradient of the potential energy of a chain of springs with
+// respect to the displacement of each of its masses, by central finite
+// differences (two evaluations per displacement) and in a single evaluation
+// with dual numbers carrying one tangent per displacement.
+
+constexpr std::size_t masses = 8;
+constexpr std::size_t count = 1 << 12;
+constexpr int repetitions = 100;
+
+template <class Number>
+using Displacement = Quantity<1, 0, 0, 0, 0, 0, 0, Number>;
+
+template <class Number>
+Quantity<2, 1, -2, 0, 0, 0, 0, Number>
+potential(const std::array<Displacement<Number>, masses>& x) {
+	auto stiffness = 250_N / m;
+	Quantity<2, 1, -2, 0, 0, 0, 0, Number> energy(0);
+	for (std::size_t i = 0; i + 1 < masses; ++i) {
+		energy += 0.5 * stiffness * (x[i + 1] - x[i]).p2();
+	}
+	return energy + 0.5 * stiffness * x[0].p2();
+}
+
+int main() {
+	std::vector<std::array<Displacement<double>, masses>> states(count);
+	for (std::size_t s = 0; s < count; ++s) {
+		for (std::size_t i = 0; i < masses; ++i) {
+			states[s][i] = Displacement<double>(0.001 * ((s * 7 + i * 13) % 101));
+		}
+	}
+	std::vector<std::array<Force, masses>> gradients(count);
+
+	report("gradient by finite differences", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t s = 0; s < count; ++s) {
+				std::array<Displacement<double>, masses> x = states[s];
+				for (std::size_t i = 0; i < masses; ++i) {
+					auto h = 1e-6_m;
+					x[i] += h;
+					auto above = potential(x);
+					x[i] -= 2 * h;
+					auto below = potential(x);
+					x[i] = states[s][i];
+					gradients[s][i] = Force((above - below) / (2 * h));
+				}
+			}
+			doNotOptimize(gradients[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("gradient with Dual<double, 8>", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t s = 0; s < count; ++s) {
+				std::array<Displacement<Dual<double, masses>>, masses> x;
+				for (std::size_t i = 0; i < masses; ++i) {
+					x[i] = Variable<masses>(states[s][i], i);
+				}
+				auto energy = potential(x);
+				for (std::size_t i = 0; i < masses; ++i) {
+					gradients[s][i] = Force(Derivative(energy, x[i]));
+				}
+			}
+			doNotOptimize(gradients[0]);
+		}
+	}), double(count) * repetitions);
+}
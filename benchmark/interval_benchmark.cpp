@@ -0,0 +1,98 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_interval.h>
+
+#include <cfenv>
+#include <vector>
+
+// Compares interval multiplication over spans of quantities against plain
+// doubles, and against the textbook implementation which switches the
+// rounding mode around every bound.
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, double> FastMass;
+typedef Quantity<1, 1, 0, 0, 0, 0, 0, double> FastProduct;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, Interval<double>> BoundedLength;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, Interval<double>> BoundedMass;
+typedef Quantity<1, 1, 0, 0, 0, 0, 0, Interval<double>> BoundedProduct;
+
+constexpr std::size_t count = 1 << 14;
+constexpr int repetitions = 1000;
+
+// Volatile, so that the compiler can't move the products across the mode
+// switches.
+static Interval<double> roundingModeProduct(Interval<double> x, Interval<double> y) {
+	volatile double a = x.Lower(), b = x.Upper(), c = y.Lower(), d = y.Upper();
+	std::fesetround(FE_DOWNWARD);
+	double lower = std::min(std::min(a * c, a * d), std::min(b * c, b * d));
+	std::fesetround(FE_UPWARD);
+	double upper = std::max(std::max(a * c, a * d), std::max(b * c, b * d));
+	std::fesetround(FE_TONEAREST);
+	return Interval<double>(lower, upper);
+}
+
+int main() {
+	std::vector<FastLength> x(count);
+	std::vector<FastMass> y(count);
+	std::vector<FastProduct> product(count);
+	std::vector<BoundedLength> boundedX(count);
+	std::vector<BoundedMass> boundedY(count);
+	std::vector<BoundedProduct> boundedProduct(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		x[i] = FastLength(0.5 + i % 97);
+		y[i] = FastMass(i % 89 - 40.25);
+		boundedX[i] = BoundedLength(Interval<double>(x[i].Value(), x[i].Value() + 0.125));
+		boundedY[i] = BoundedMass(Interval<double>(y[i].Value(), y[i].Value() + 0.5));
+	}
+
+	report("double product", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				product[i] = x[i] * y[i];
+			}
+			doNotOptimize(product[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("Interval product span", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			Multiply(QuantitySpan<const BoundedLength>(boundedX),
+				 QuantitySpan<const BoundedMass>(boundedY),
+				 QuantitySpan<BoundedProduct>(boundedProduct));
+			doNotOptimize(boundedProduct[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("product with rounding mode switches", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				boundedProduct[i] = BoundedProduct(
+					roundingModeProduct(boundedX[i].Value(), boundedY[i].Value()));
+			}
+			doNotOptimize(boundedProduct[0]);
+		}
+	}), double(count) * repetitions);
+}
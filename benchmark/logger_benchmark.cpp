@@ -0,0 +1,65 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_logger.h>
+
+#include <sstream>
+
+// Logs a million speeds with QuantityLogger, a buffer at a time, timing only
+// the calls to Log, and then writes them with operator<< to a string
+// stream, as logging them directly would.  Times are per value.
+
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+
+constexpr int count = 1 << 20;
+constexpr int batch = 4096;
+
+int main() {
+	std::ostringstream stream;
+	QuantityLogger logger(stream, false);
+	double seconds = 0;
+	double drainSeconds = 0;
+	for (int first = 0; first < count; first += batch) {
+		seconds += timeSeconds([&] {
+			for (int i = first; i < first + batch; ++i) {
+				logger.Log("speed", FastSpeed(i));
+			}
+		});
+		drainSeconds += timeSeconds([&] {
+			logger.Drain();
+		});
+	}
+	doNotOptimize(stream.str().size());
+	report("QuantityLogger::Log", seconds, count);
+	report("QuantityLogger::Drain", drainSeconds, count);
+
+	std::ostringstream direct;
+	report("operator<<", timeSeconds([&] {
+		for (int i = 0; i < count; ++i) {
+			direct << "speed " << FastSpeed(i) << '\n';
+		}
+	}), count);
+	doNotOptimize(direct.str().size());
+}
@@ -0,0 +1,81 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_math.h>
+
+#include <cmath>
+#include <vector>
+
+// Compares the span overloads of the math functions against the scalar idiom
+// they replace, Length(std::sqrt(area.Value())), over double-valued quantities.
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<2, 0, 0, 0, 0, 0, 0, double> FastArea;
+
+constexpr std::size_t count = 1 << 20;
+constexpr int repetitions = 100;
+
+int main() {
+	std::vector<FastArea> areas(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		areas[i] = FastArea(1.0 + i);
+	}
+	std::vector<FastLength> sides(count);
+	std::vector<FastLength> others(count, FastLength(0.5));
+
+	report("sqrt via Value()", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				sides[i] = FastLength(std::sqrt(areas[i].Value()));
+			}
+			doNotOptimize(sides[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("sqrt span", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			sqrt(QuantitySpan<const FastArea>(areas), QuantitySpan<FastLength>(sides));
+			doNotOptimize(sides[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("max via Value()", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				sides[i] = FastLength(std::fmax(sides[i].Value(), others[i].Value()));
+			}
+			doNotOptimize(sides[0]);
+		}
+	}), double(count) * repetitions);
+
+	report("max span", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			max(QuantitySpan<const FastLength>(sides),
+			    QuantitySpan<const FastLength>(others),
+			    QuantitySpan<FastLength>(sides));
+			doNotOptimize(sides[0]);
+		}
+	}), double(count) * repetitions);
+}
@@ -0,0 +1,85 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_quantized.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Quantizes ten million double pressures to 16 and 8 bit codes, and
+// dequantizes them again, in bulk and one at a time, into memory that has
+// already been touched.  Times are per value.
+
+typedef Quantity<-1, 1, -2, 0, 0, 0, 0, double> FastPressure;
+
+constexpr int count = 10000000;
+
+template <class Array>
+static void run(const char* name, const std::vector<FastPressure>& pressures) {
+	Array array;
+	report(std::string(name) + " quantize", timeSeconds([&] {
+		array.Assign(QuantitySpan<const FastPressure>(pressures));
+	}), count);
+	std::printf("    %.3f bytes per value, max error %g Pa\n",
+		    double(array.Bytes()) / count, double(array.MaxError().Value()));
+	std::printf("    %.1f times smaller than long double\n",
+		    double(count) * sizeof(long double) / double(array.Bytes()));
+
+	std::vector<FastPressure> out(count);
+	array.Decode(0, QuantitySpan<FastPressure>(out));
+	report(std::string(name) + " bulk decode", timeSeconds([&] {
+		array.Decode(0, QuantitySpan<FastPressure>(out));
+	}), count);
+	doNotOptimize(out[count / 2]);
+
+	report(std::string(name) + " operator[]", timeSeconds([&] {
+		for (int i = 0; i < count; ++i) {
+			out[i] = array[i];
+		}
+	}), count);
+	doNotOptimize(out[count / 2]);
+}
+
+int main() {
+	std::mt19937_64 engine(1);
+	std::normal_distribution<double> noise(0, 5);
+	std::vector<FastPressure> pressures;
+	double p = 101325;
+	for (int i = 0; i < count; ++i) {
+		p += noise(engine);
+		pressures.push_back(FastPressure(p));
+	}
+
+	std::vector<FastPressure> copy(pressures);
+	report("copy doubles", timeSeconds([&] {
+		std::copy(pressures.begin(), pressures.end(), copy.begin());
+	}), count);
+	doNotOptimize(copy[count / 2]);
+
+	run<QuantizedArray<FastPressure>>("16 bit", pressures);
+	run<QuantizedArray<FastPressure, std::uint8_t>>("8 bit", pressures);
+}
@@ -0,0 +1,139 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_queue.h>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures the throughput of handing samples from a producer thread to a
+// consumer thread at several batch sizes, and the one-way latency of a single
+// sample, using a mutex-protected std::deque as the baseline.
+
+constexpr std::size_t itemCount = 10000000;
+constexpr std::size_t capacity = 4096;
+constexpr int roundTrips = 100000;
+
+// The baseline: what everyone writes first.
+class MutexQueue {
+public:
+	std::size_t PushBatch(QuantitySpan<const Time> items) {
+		std::lock_guard<std::mutex> lock(mutex);
+		std::size_t n = std::min(items.size(), capacity - queue.size());
+		queue.insert(queue.end(), items.begin(), items.begin() + n);
+		return n;
+	}
+
+	std::size_t PopBatch(QuantitySpan<Time> items) {
+		std::lock_guard<std::mutex> lock(mutex);
+		std::size_t n = std::min(items.size(), queue.size());
+		std::copy(queue.begin(), queue.begin() + n, items.begin());
+		queue.erase(queue.begin(), queue.begin() + n);
+		return n;
+	}
+
+private:
+	std::mutex mutex;
+	std::deque<Time> queue;
+};
+
+template <class Queue>
+void pushAll(Queue& queue, std::size_t batchSize) {
+	std::vector<Time> batch(batchSize, 1_s);
+	for (std::size_t sent = 0; sent < itemCount; ) {
+		std::size_t n = std::min(batchSize, itemCount - sent);
+		std::size_t pushed = queue.PushBatch(QuantitySpan<const Time>(batch.data(), n));
+		sent += pushed;
+		if (pushed == 0) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+template <class Queue>
+void popAll(Queue& queue, std::size_t batchSize) {
+	std::vector<Time> batch(batchSize);
+	for (std::size_t received = 0; received < itemCount; ) {
+		std::size_t popped = queue.PopBatch(batch);
+		received += popped;
+		if (popped == 0) {
+			std::this_thread::yield();
+		}
+	}
+	doNotOptimize(batch[0]);
+}
+
+template <class Queue>
+void benchmarkThroughput(const std::string& name, std::size_t batchSize) {
+	Queue queue;
+	double seconds = timeSeconds([&] {
+		std::thread producer([&] { pushAll(queue, batchSize); });
+		popAll(queue, batchSize);
+		producer.join();
+	});
+	report(name + " batch " + std::to_string(batchSize), seconds, itemCount);
+}
+
+template <class Queue>
+void benchmarkLatency(const std::string& name) {
+	Queue ping;
+	Queue pong;
+	double seconds = timeSeconds([&] {
+		std::thread echo([&] {
+			Time item;
+			for (int i = 0; i < roundTrips; ++i) {
+				while (ping.PopBatch(QuantitySpan<Time>(&item, 1)) == 0) {
+					std::this_thread::yield();
+				}
+				pong.PushBatch(QuantitySpan<const Time>(&item, 1));
+			}
+		});
+		Time item = 1_s;
+		for (int i = 0; i < roundTrips; ++i) {
+			ping.PushBatch(QuantitySpan<const Time>(&item, 1));
+			while (pong.PopBatch(QuantitySpan<Time>(&item, 1)) == 0) {
+				std::this_thread::yield();
+			}
+		}
+		echo.join();
+	});
+	report(name + " one-way latency", seconds, 2.0 * roundTrips);
+}
+
+int main() {
+	for (std::size_t batchSize : {1, 4, 16, 64, 256}) {
+		benchmarkThroughput<MutexQueue>("mutex", batchSize);
+		benchmarkThroughput<SpscQuantityQueue<Time, capacity>>("spsc", batchSize);
+		benchmarkThroughput<MpscQuantityQueue<Time, capacity>>("mpsc", batchSize);
+	}
+
+	benchmarkLatency<MutexQueue>("mutex");
+	benchmarkLatency<SpscQuantityQueue<Time, capacity>>("spsc");
+	benchmarkLatency<MpscQuantityQueue<Time, capacity>>("mpsc");
+}
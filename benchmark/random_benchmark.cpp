@@ -0,0 +1,122 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_random.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+// Compares filling arrays of double-valued quantities with the Philox
+// distributions against std::mt19937_64 with the standard distributions,
+// multiplied by the unit by hand.
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+
+constexpr std::size_t count = 1 << 16;
+constexpr int repetitions = 100;
+
+int main() {
+	std::vector<FastLength> lengths(count);
+	std::mt19937_64 engine(1);
+	Philox4x32 generator(1);
+
+	std::uniform_real_distribution<double> stdUniform(2, 5);
+	report("std uniform", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (FastLength& length : lengths) {
+				length = stdUniform(engine) * FastLength(1);
+			}
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	UniformQuantityDistribution<FastLength> uniform(FastLength(2), FastLength(5));
+	report("Philox uniform Fill", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			uniform.Fill(generator, lengths, r * count);
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	std::normal_distribution<double> stdNormal(10, 2);
+	report("std normal", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (FastLength& length : lengths) {
+				length = stdNormal(engine) * FastLength(1);
+			}
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	NormalQuantityDistribution<FastLength> normal(FastLength(10), FastLength(2));
+	report("Philox normal Fill", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			normal.Fill(generator, lengths, r * count);
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	std::lognormal_distribution<double> stdLognormal(0, 0.25);
+	report("std lognormal", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (FastLength& length : lengths) {
+				length = 3 * stdLognormal(engine) * FastLength(1);
+			}
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	LognormalQuantityDistribution<FastLength> lognormal(FastLength(3), 0.25);
+	report("Philox lognormal Fill", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			lognormal.Fill(generator, lengths, r * count);
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+
+	// The same normal fill split across threads; the result is identical
+	// to the single-threaded fill.
+	unsigned threads = std::thread::hardware_concurrency();
+	threads = threads == 0 ? 1 : threads;
+	report("Philox normal Fill, all threads", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			std::vector<std::thread> workers;
+			for (unsigned t = 0; t < threads; ++t) {
+				workers.emplace_back([&, t] {
+					std::size_t begin = count * t / threads;
+					std::size_t end = count * (t + 1) / threads;
+					normal.Fill(generator,
+						    QuantitySpan<FastLength>(lengths).subspan(begin, end - begin),
+						    r * count + begin);
+				});
+			}
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+			doNotOptimize(lengths[0]);
+		}
+	}), double(count) * repetitions);
+}
@@ -0,0 +1,100 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_trig.h>
+
+#include <cmath>
+#include <vector>
+
+// Compares the span overloads of sin and atan2, at both accuracies, against
+// libm called on Value(), over double-valued quantities.
+
+typedef Quantity<0, 0, 0, 0, 0, 0, 0, double, AngleFormat> FastAngle;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+
+constexpr std::size_t count = 1 << 16;
+constexpr int repetitions = 200;
+
+template <class Accuracy>
+void benchmarkSpans(const char* sinName, const char* atan2Name,
+		    const std::vector<FastAngle>& angles,
+		    const std::vector<FastLength>& ys,
+		    const std::vector<FastLength>& xs)
+{
+	std::vector<double> sines(count);
+	report(sinName, timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			sin<Accuracy>(QuantitySpan<const FastAngle>(angles),
+				      QuantitySpan<double>(sines));
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+
+	std::vector<FastAngle> headings(count);
+	report(atan2Name, timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			atan2<Accuracy>(QuantitySpan<const FastLength>(ys),
+					QuantitySpan<const FastLength>(xs),
+					QuantitySpan<FastAngle>(headings));
+			doNotOptimize(headings[0]);
+		}
+	}), double(count) * repetitions);
+}
+
+int main() {
+	std::vector<FastAngle> angles(count);
+	std::vector<FastLength> ys(count);
+	std::vector<FastLength> xs(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		angles[i] = FastAngle(-100.0 + 200.0 * i / count);
+		ys[i] = FastLength(std::sin(0.37 * i));
+		xs[i] = FastLength(std::cos(0.23 * i));
+	}
+
+	std::vector<double> sines(count);
+	report("sin via Value()", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				sines[i] = std::sin(angles[i].Value());
+			}
+			doNotOptimize(sines[0]);
+		}
+	}), double(count) * repetitions);
+
+	std::vector<FastAngle> headings(count);
+	report("atan2 via Value()", timeSeconds([&] {
+		for (int r = 0; r < repetitions; ++r) {
+			for (std::size_t i = 0; i < count; ++i) {
+				headings[i] = FastAngle(std::atan2(ys[i].Value(), xs[i].Value()));
+			}
+			doNotOptimize(headings[0]);
+		}
+	}), double(count) * repetitions);
+
+	benchmarkSpans<PreciseTrig>("sin span, PreciseTrig", "atan2 span, PreciseTrig",
+				    angles, ys, xs);
+	benchmarkSpans<FastTrig>("sin span, FastTrig", "atan2 span, FastTrig",
+				 angles, ys, xs);
+}
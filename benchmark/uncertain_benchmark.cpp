@@ -0,0 +1,102 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_uncertain.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Propagates the uncertainty of a mass and a speed measurement to the kinetic
+// energy and momentum they imply, by Monte Carlo sampling and by linear
+// propagation with Uncertain and CorrelatedUncertain.  Times are per result,
+// i.e. per pair of measurements.
+
+constexpr std::size_t count = 1 << 10;
+constexpr int samples = 1000;
+
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, double> FastMass;
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+
+template <class MassNumber, class SpeedNumber>
+auto energyPerMomentum(const Quantity<0, 1, 0, 0, 0, 0, 0, MassNumber>& mass,
+		       const Quantity<1, 0, -1, 0, 0, 0, 0, SpeedNumber>& speed)
+	-> decltype(0.5 * mass * speed.p2() / (mass * speed))
+{
+	return 0.5 * mass * speed.p2() / (mass * speed);
+}
+
+int main() {
+	std::vector<double> masses(count);
+	std::vector<double> speeds(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		masses[i] = 1 + i % 17;
+		speeds[i] = 2 + i % 13;
+	}
+	const double massDeviation = 0.05;
+	const double speedDeviation = 0.1;
+	std::vector<double> deviations(count);
+
+	std::mt19937_64 generator(1);
+	std::normal_distribution<double> normal;
+	report("Monte Carlo, 1000 samples", timeSeconds([&] {
+		for (std::size_t i = 0; i < count; ++i) {
+			double sum = 0;
+			double sumOfSquares = 0;
+			for (int s = 0; s < samples; ++s) {
+				FastMass mass(masses[i] + massDeviation * normal(generator));
+				FastSpeed speed(speeds[i] + speedDeviation * normal(generator));
+				double result = energyPerMomentum(mass, speed).Value();
+				sum += result;
+				sumOfSquares += result * result;
+			}
+			double mean = sum / samples;
+			deviations[i] = std::sqrt(sumOfSquares / samples - mean * mean);
+		}
+		doNotOptimize(deviations[0]);
+	}), double(count));
+
+	report("Uncertain", timeSeconds([&] {
+		for (std::size_t i = 0; i < count; ++i) {
+			Quantity<0, 1, 0, 0, 0, 0, 0, Uncertain<double>>
+				mass(Uncertain<double>(masses[i], massDeviation));
+			Quantity<1, 0, -1, 0, 0, 0, 0, Uncertain<double>>
+				speed(Uncertain<double>(speeds[i], speedDeviation));
+			deviations[i] = DeviationOf(energyPerMomentum(mass, speed)).Value();
+		}
+		doNotOptimize(deviations[0]);
+	}), double(count));
+
+	report("CorrelatedUncertain", timeSeconds([&] {
+		for (std::size_t i = 0; i < count; ++i) {
+			Quantity<0, 1, 0, 0, 0, 0, 0, CorrelatedUncertain<double>>
+				mass(CorrelatedUncertain<double>(masses[i], massDeviation));
+			Quantity<1, 0, -1, 0, 0, 0, 0, CorrelatedUncertain<double>>
+				speed(CorrelatedUncertain<double>(speeds[i], speedDeviation));
+			deviations[i] = DeviationOf(energyPerMomentum(mass, speed)).Value();
+		}
+		doNotOptimize(deviations[0]);
+	}), double(count));
+}
@@ -0,0 +1,119 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <Benchmark.h>
+
+#include <btul.h>
+#include <btul_units.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Resolves every unit symbol, with and without each prefix, through the
+// perfect hash, and by scanning the symbol and prefix tables in order, as
+// ParseUnit used to.  Then parses a handful of typical column units, with and
+// without the per-thread cache.  Times are per symbol or expression.
+
+constexpr int rounds = 20000;
+
+static bool linearResolve(const char* name, std::size_t length, ParsedUnit& unit) {
+	using namespace detail::units;
+	for (const Symbol& symbol : SYMBOLS) {
+		if (std::strlen(symbol.name) == length && std::memcmp(symbol.name, name, length) == 0) {
+			unit = unpacked(symbol);
+			return true;
+		}
+	}
+	for (const Prefix& prefix : PREFIXES) {
+		std::size_t prefixLength = std::strlen(prefix.name);
+		if (prefixLength < length && std::memcmp(prefix.name, name, prefixLength) == 0) {
+			for (const Symbol& symbol : SYMBOLS) {
+				if (symbol.prefixable &&
+				    std::strlen(symbol.name) == length - prefixLength &&
+				    std::memcmp(symbol.name, name + prefixLength, length - prefixLength) == 0) {
+					unit = unpacked(symbol);
+					unit.scale *= prefix.scale;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+template <class Resolve>
+static void runResolve(const char* name, const std::vector<std::string>& names, Resolve resolve) {
+	long double total = 0;
+	report(name, timeSeconds([&] {
+		for (int r = 0; r < rounds; ++r) {
+			for (const std::string& symbol : names) {
+				ParsedUnit unit = {{0, 0, 0, 0, 0, 0, 0}, 1};
+				resolve(symbol.data(), symbol.size(), unit);
+				total += unit.scale;
+			}
+		}
+	}), double(rounds) * names.size());
+	doNotOptimize(total);
+}
+
+int main() {
+	std::vector<std::string> names;
+	for (const detail::units::Symbol& symbol : detail::units::SYMBOLS) {
+		names.push_back(symbol.name);
+		if (symbol.prefixable) {
+			for (const detail::units::Prefix& prefix : detail::units::PREFIXES) {
+				names.push_back(std::string(prefix.name) + symbol.name);
+			}
+		}
+	}
+
+	runResolve("linear resolve", names,
+		   [](const char* name, std::size_t length, ParsedUnit& unit) {
+			   return linearResolve(name, length, unit);
+		   });
+	runResolve("perfect hash resolve", names,
+		   [](const char* name, std::size_t length, ParsedUnit& unit) {
+			   return detail::units::resolve(name, length, unit);
+		   });
+
+	const std::vector<std::string> expressions = {
+		"m", "km/h", "m/s^2", "kg", "J/(kg\xc2\xb7K)", "kPa", "mL/min", "N\xc2\xb7m",
+	};
+	long double total = 0;
+	report("parse", timeSeconds([&] {
+		for (int r = 0; r < rounds; ++r) {
+			for (const std::string& text : expressions) {
+				total += detail::units::Parser(text).Parse().scale;
+			}
+		}
+	}), double(rounds) * expressions.size());
+	report("ParseUnit, cached", timeSeconds([&] {
+		for (int r = 0; r < rounds; ++r) {
+			for (const std::string& text : expressions) {
+				total += ParseUnit(text).scale;
+			}
+		}
+	}), double(rounds) * expressions.size());
+	doNotOptimize(total);
+}
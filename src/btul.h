@@ -25,8 +25,10 @@ SOFTWARE. */
 
 #include <utility>
 #include <cmath>
+#include <cstddef>
 #include <string>
 #include <sstream>
+#include <type_traits>
 
 
 #define BASE_QUANTITIES_DECLARATION	\
@@ -104,6 +106,24 @@ SOFTWARE. */
 
 #define BASE_QUANTITIES_1_MUL(VALUE) BASE_QUANTITIES_N_MUL(1, VALUE)
 
+#define BASE_QUANTITIES_ROOT_OP(OP)				\
+	Length1 * Root2 OP Length2 * Root1,			\
+	Mass1 * Root2 OP Mass2 * Root1,				\
+	Time1 * Root2 OP Time2 * Root1,				\
+	Current1 * Root2 OP Current2 * Root1,			\
+	Temperature1 * Root2 OP Temperature2 * Root1,		\
+	Amount1 * Root2 OP Amount2 * Root1,			\
+	Luminosity1 * Root2 OP Luminosity2 * Root1
+
+#define BASE_QUANTITIES_DIV(VALUE)	\
+	Length / VALUE,			\
+	Mass / VALUE,			\
+	Time / VALUE,			\
+	Current / VALUE,		\
+	Temperature / VALUE,		\
+	Amount / VALUE,			\
+	Luminosity / VALUE
+
 namespace detail {
 	const char* super(char c) {
 		switch (c) {
@@ -145,6 +165,14 @@ namespace detail {
 		return result.str();
 	}
 
+	constexpr int gcd(int a, int b) {
+		return b == 0 ? (a < 0 ? -a : a) : gcd(b, a % b);
+	}
+
+	// Large enough to keep independently written data off each other's cache
+	// lines on all mainstream x86 and ARM parts.
+	constexpr std::size_t CACHE_LINE_SIZE = 64;
+
 #ifdef MATHEMATICAL_SPACE
 	const char* SPACE = "\xe2\x81\x9f";
 #else
@@ -153,9 +181,11 @@ namespace detail {
 }
 
 
-template <BASE_QUANTITIES_DECLARATION>
+/// Exponents are Length / Root, Mass / Root, etc.  Fractional exponents are
+/// printed as superscript fractions, e.g. "s⁻¹⁄²".
+template <BASE_QUANTITIES_DECLARATION, int Root = 1>
 class DefaultQuantityFormat {
-	static void print_power(std::ostringstream& stream, int i) {
+	static void print_superscript(std::ostringstream& stream, int i) {
 		std::ostringstream power_stream;
 		power_stream << i;
 		std::string str = power_stream.str();
@@ -164,6 +194,15 @@ class DefaultQuantityFormat {
 		}
 	}
 
+	static void print_power(std::ostringstream& stream, int i) {
+		int divisor = detail::gcd(i, Root);
+		print_superscript(stream, i / divisor);
+		if (Root / divisor != 1) {
+			stream << "\xe2\x81\x84";
+			print_superscript(stream, Root / divisor);
+		}
+	}
+
 	static inline void print_positive(std::ostringstream& stream,
 					  int power,
 					  const char* unit,
@@ -174,7 +213,7 @@ class DefaultQuantityFormat {
 				stream << "·";
 			}
 			stream << unit;
-			if (power > 1) {
+			if (power != Root) {
 				print_power(stream, power);
 			}
 			first = false;
@@ -230,8 +269,8 @@ class DefaultQuantityFormat {
 		print_positive(stream, -Time, "s", first);
 		print_positive(stream, -Current, "A", first);
 		print_positive(stream, -Temperature, "K", first);
-		print_positive(stream, -Amount, "mole", first);
-		print_positive(stream, Luminosity, "cd", first);
+		print_positive(stream, -Amount, "mol", first);
+		print_positive(stream, -Luminosity, "cd", first);
 	}
 public:
 	template <class Number>
@@ -265,13 +304,73 @@ public:
 };
 
 
+namespace detail {
+	// pow is called unqualified, so that it is found by argument-dependent
+	// lookup for custom Number types, and in std for the built-in ones.
+	namespace power {
+		using std::pow;
+
+		template <class T>
+		constexpr auto raise(const T& x, int n) -> decltype(pow(x, n)) {
+			return pow(x, n);
+		}
+	}
+}
+
 #define OP_RESULT_TYPE(T1, OP, T2) decltype(std::declval<T1>() OP std::declval<T2>())
 #define POW_TYPE(T1, T2) decltype(std::pow(std::declval<T1>(), std::declval<T2>()))
 
 template <BASE_QUANTITIES_DECLARATION_1,
 	  class Number = long double,
-	  class Format = DefaultQuantityFormat<BASE_QUANTITIES_1>>
+	  class Format = DefaultQuantityFormat<BASE_QUANTITIES_1>,
+	  int Root = 1>
+class Quantity;
+
+namespace detail {
+	/// Stands in for the default format of whatever dimensions a
+	/// NormalizedQuantity ends up with.
+	struct DefaultFormat {};
+
+	template <class Format, class Default>
+	struct SelectFormat {
+		typedef Format type;
+	};
+
+	template <class Default>
+	struct SelectFormat<DefaultFormat, Default> {
+		typedef Default type;
+	};
+
+	/// Reduces the exponents Length / Root, Mass / Root, etc. to lowest
+	/// terms, so that every dimension has exactly one Quantity type.
+	template <class Number, class Format, int Root, BASE_QUANTITIES_DECLARATION>
+	class NormalizedQuantity {
+		static constexpr int divisor =
+			gcd(gcd(gcd(gcd(gcd(gcd(gcd(Root, Length), Mass), Time),
+					Current), Temperature), Amount), Luminosity);
+
+	public:
+		typedef Quantity<BASE_QUANTITIES_DIV(divisor),
+				 Number,
+				 typename SelectFormat<
+					Format,
+					DefaultQuantityFormat<BASE_QUANTITIES_DIV(divisor),
+							      Root / divisor>
+				 >::type,
+				 Root / divisor> type;
+	};
+}
+
+#define NORMALIZED_QUANTITY(NUMBER, FORMAT, ROOT, ...)				\
+	typename detail::NormalizedQuantity<NUMBER, FORMAT, ROOT, __VA_ARGS__>::type
+
+/// Exponents are Length1 / Root, Mass1 / Root, etc., always in lowest terms.
+/// Root is 1 for every quantity with integral exponents, so it only needs to
+/// be spelled out by code that deals with things like sqrt(Hz).
+template <BASE_QUANTITIES_DECLARATION_1, class Number, class Format, int Root>
 class Quantity {
+	static_assert(Root > 0, "Quantity root must be positive");
+
 public:
 	constexpr Quantity() {}
 	explicit constexpr Quantity(Number value)
@@ -279,7 +378,7 @@ public:
 	{}
 
 	template <class T, class F>
-	constexpr Quantity(Quantity<BASE_QUANTITIES_1, T, F> other)
+	constexpr Quantity(Quantity<BASE_QUANTITIES_1, T, F, Root> other)
 		: value(other.Value())
 	{}
 
@@ -288,27 +387,35 @@ public:
 	// since C++11 only supports single statements as constexpr function bodies.
 
 	template <class T, class F>
-	constexpr Quantity& operator =(Quantity<BASE_QUANTITIES_1, T, F> other) {
+	constexpr Quantity& operator =(Quantity<BASE_QUANTITIES_1, T, F, Root> other) {
 		return (this->value = other.Value(), *this);
 	}
 
+	// The powers are templates only so that their return types are not
+	// instantiated along with every Quantity, which keeps compile times down.
+
 	#define DECLARE_POWER(N)						\
-	constexpr Quantity<BASE_QUANTITIES_1_MUL(N),				\
-			   Number,						\
-			   DefaultQuantityFormat<BASE_QUANTITIES_1_MUL(N)>>	\
+	template <int Power = N>						\
+	constexpr NORMALIZED_QUANTITY(Number, detail::DefaultFormat, Root,	\
+				      BASE_QUANTITIES_1_MUL(Power))		\
 		 p##N()								\
 	{									\
-		return Quantity<BASE_QUANTITIES_1_MUL(N),			\
-				Number,						\
-				DefaultQuantityFormat<BASE_QUANTITIES_1_MUL(N)>>\
+		return NORMALIZED_QUANTITY(Number, detail::DefaultFormat, Root,	\
+					   BASE_QUANTITIES_1_MUL(Power))	\
 		(								\
-			std::pow(value, N)					\
+			detail::power::raise(value, Power)		\
 		);								\
 	}									\
 										\
-	constexpr Quantity<BASE_QUANTITIES_1_MUL(-N), Number, Format> n##N() {	\
-		return Quantity<BASE_QUANTITIES_1_MUL(-N), Number, Format>(	\
-			std::pow(value, -N)					\
+	template <int Power = -N>						\
+	constexpr NORMALIZED_QUANTITY(Number, detail::DefaultFormat, Root,	\
+				      BASE_QUANTITIES_1_MUL(Power))		\
+		 n##N()								\
+	{									\
+		return NORMALIZED_QUANTITY(Number, detail::DefaultFormat, Root,	\
+					   BASE_QUANTITIES_1_MUL(Power))	\
+		(								\
+			detail::power::raise(value, Power)		\
 		);								\
 	}
 
@@ -326,19 +433,22 @@ public:
 	#undef DECLARE_POWER
 
 	template <class NewFormat>
-	constexpr Quantity<BASE_QUANTITIES_1, Number, NewFormat> withFormat() const {
-		return Quantity<BASE_QUANTITIES_1, Number, NewFormat>(value);
+	constexpr Quantity<BASE_QUANTITIES_1, Number, NewFormat, Root> withFormat() const {
+		return Quantity<BASE_QUANTITIES_1, Number, NewFormat, Root>(value);
 	}
 
 	template <class T1, class T2, class F>
 	constexpr bool Within(T1 epsilon,
-			      const Quantity<BASE_QUANTITIES_1, T2, F>& other) const
+			      const Quantity<BASE_QUANTITIES_1, T2, F, Root>& other) const
 	{
-		return (this->Value() == other.Value()) ||
-		       (this->Value() < other.Value() &&
-			this->Value() + epsilon >= other.Value()) ||
-		       (other.Value() < this->Value() &&
-			other.Value() + epsilon >= this->Value());
+		// Bitwise rather than logical operators, so that this compiles
+		// to straight-line code.  See btul_compare.h for comparisons that
+		// don't depend on the scale of the values.
+		return (this->Value() == other.Value()) |
+		       ((this->Value() < other.Value()) &
+			(this->Value() + epsilon >= other.Value())) |
+		       ((other.Value() < this->Value()) &
+			(other.Value() + epsilon >= this->Value()));
 	}
 
 	constexpr Number Value() const {
@@ -352,6 +462,7 @@ public:
 	static constexpr int current = Current1;
 	static constexpr int amount = Amount1;
 	static constexpr int luminosity = Luminosity1;
+	static constexpr int root = Root;
 
 	typedef Number type;
 	typedef Format format;
@@ -360,80 +471,89 @@ protected:
 	Number value;
 
 private:
-	template <BASE_QUANTITIES_DECLARATION,
+	template <BASE_QUANTITIES_DECLARATION, int R,
 		  class T1, class F1,
 		  class T2, class F2>
-	friend constexpr Quantity<BASE_QUANTITIES, T1, F1>& operator +=(
-		Quantity<BASE_QUANTITIES, T1, F1>&,
-		const Quantity<BASE_QUANTITIES, T2, F2>&
+	friend constexpr Quantity<BASE_QUANTITIES, T1, F1, R>& operator +=(
+		Quantity<BASE_QUANTITIES, T1, F1, R>&,
+		const Quantity<BASE_QUANTITIES, T2, F2, R>&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION,
+	template <BASE_QUANTITIES_DECLARATION, int R,
 		  class T1, class F1,
 		  class T2, class F2>
-	friend constexpr Quantity<BASE_QUANTITIES, T1, F1>& operator -=(
-		Quantity<BASE_QUANTITIES, T1, F1>&,
-		const Quantity<BASE_QUANTITIES, T2, F2>&
+	friend constexpr Quantity<BASE_QUANTITIES, T1, F1, R>& operator -=(
+		Quantity<BASE_QUANTITIES, T1, F1, R>&,
+		const Quantity<BASE_QUANTITIES, T2, F2, R>&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>
-	friend constexpr Quantity<BASE_QUANTITIES, T1, F>& operator *=(
-		Quantity<BASE_QUANTITIES, T1, F>&,
+	template <BASE_QUANTITIES_DECLARATION, int R, class T1, class F, class T2>
+	friend constexpr Quantity<BASE_QUANTITIES, T1, F, R>& operator *=(
+		Quantity<BASE_QUANTITIES, T1, F, R>&,
 		const T2&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>
-	friend constexpr Quantity<BASE_QUANTITIES, T1, F>& operator /=(
-		Quantity<BASE_QUANTITIES, T1, F>&,
+	template <BASE_QUANTITIES_DECLARATION, int R, class T1, class F, class T2>
+	friend constexpr Quantity<BASE_QUANTITIES, T1, F, R>& operator /=(
+		Quantity<BASE_QUANTITIES, T1, F, R>&,
 		const T2&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>
-	friend constexpr Quantity<BASE_QUANTITIES, T1, F>& operator %=(
-		Quantity<BASE_QUANTITIES, T1, F>&,
+	template <BASE_QUANTITIES_DECLARATION, int R, class T1, class F, class T2>
+	friend constexpr Quantity<BASE_QUANTITIES, T1, F, R>& operator %=(
+		Quantity<BASE_QUANTITIES, T1, F, R>&,
 		const T2&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T, class F>
-	friend constexpr Quantity<BASE_QUANTITIES, T, F>& operator ++(
-		Quantity<BASE_QUANTITIES, T, F>&
+	template <BASE_QUANTITIES_DECLARATION, int R, class T, class F>
+	friend constexpr Quantity<BASE_QUANTITIES, T, F, R>& operator ++(
+		Quantity<BASE_QUANTITIES, T, F, R>&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T, class F>
-	friend constexpr Quantity<BASE_QUANTITIES, T, F>& operator --(
-		Quantity<BASE_QUANTITIES, T, F>&
+	template <BASE_QUANTITIES_DECLARATION, int R, class T, class F>
+	friend constexpr Quantity<BASE_QUANTITIES, T, F, R>& operator --(
+		Quantity<BASE_QUANTITIES, T, F, R>&
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T, class F>
-	friend constexpr Quantity<BASE_QUANTITIES, T, F> operator ++(
-		Quantity<BASE_QUANTITIES, T, F>&,
+	template <BASE_QUANTITIES_DECLARATION, int R, class T, class F>
+	friend constexpr Quantity<BASE_QUANTITIES, T, F, R> operator ++(
+		Quantity<BASE_QUANTITIES, T, F, R>&,
 		int
 	);
 
-	template <BASE_QUANTITIES_DECLARATION, class T, class F>
-	friend constexpr Quantity<BASE_QUANTITIES, T, F> operator --(
-		Quantity<BASE_QUANTITIES, T, F>&,
+	template <BASE_QUANTITIES_DECLARATION, int R, class T, class F>
+	friend constexpr Quantity<BASE_QUANTITIES, T, F, R> operator --(
+		Quantity<BASE_QUANTITIES, T, F, R>&,
 		int
 	);
 };
 
 #define DECLARE_ADDITIVE_QUANTITY_OPERATOR(OP)					\
-template <BASE_QUANTITIES_DECLARATION,						\
+template <BASE_QUANTITIES_DECLARATION, int Root,				\
 	  class T1, class F1,							\
 	  class T2, class F2>							\
-constexpr Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2)>			\
-operator OP(const Quantity<BASE_QUANTITIES, T1, F1>& x,				\
-	    const Quantity<BASE_QUANTITIES, T2, F2>& y) 			\
+constexpr Quantity<BASE_QUANTITIES,						\
+		   OP_RESULT_TYPE(T1, OP, T2),					\
+		   DefaultQuantityFormat<BASE_QUANTITIES, Root>,		\
+		   Root>							\
+operator OP(const Quantity<BASE_QUANTITIES, T1, F1, Root>& x,			\
+	    const Quantity<BASE_QUANTITIES, T2, F2, Root>& y) 			\
 {										\
-	return Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2)>(		\
-		x.Value() OP y.Value()						\
-	);									\
+	return Quantity<BASE_QUANTITIES,					\
+			OP_RESULT_TYPE(T1, OP, T2),				\
+			DefaultQuantityFormat<BASE_QUANTITIES, Root>,		\
+			Root>							\
+	       (								\
+			x.Value() OP y.Value()					\
+	       );								\
 }										\
 										\
-template <BASE_QUANTITIES_DECLARATION, class T1, class F1, class T2, class F2>	\
-constexpr Quantity<BASE_QUANTITIES, T1, F1>&					\
-operator OP##=(Quantity<BASE_QUANTITIES, T1, F1>& x,				\
-	       const Quantity<BASE_QUANTITIES, T2, F2>& y)			\
+template <BASE_QUANTITIES_DECLARATION, int Root,				\
+	  class T1, class F1,							\
+	  class T2, class F2>							\
+constexpr Quantity<BASE_QUANTITIES, T1, F1, Root>&				\
+operator OP##=(Quantity<BASE_QUANTITIES, T1, F1, Root>& x,			\
+	       const Quantity<BASE_QUANTITIES, T2, F2, Root>& y)		\
 {										\
 	return (x.value OP##= y.Value(), x);					\
 }
@@ -441,81 +561,104 @@ operator OP##=(Quantity<BASE_QUANTITIES, T1, F1>& x,				\
 DECLARE_ADDITIVE_QUANTITY_OPERATOR(+)
 DECLARE_ADDITIVE_QUANTITY_OPERATOR(-)
 
+// A scalar times a quantity keeps the quantity's format, but a scalar divided
+// by one has the inverse dimensions, and gets the default format for them.
+#define SCALAR_OP_FORMAT(UNIT_OP, F, Root)						\
+	typename std::conditional<(0 UNIT_OP 1) == 1,					\
+				  F,							\
+				  DefaultQuantityFormat<BASE_QUANTITIES_UNARY_OP(UNIT_OP), Root>\
+				 >::type
+
 #define DECLARE_MULTIPLICATIVE_QUANTITY_OPERATOR(OP, UNIT_OP)				\
-template <BASE_QUANTITIES_DECLARATION_1, class T1, class F1,				\
-	  BASE_QUANTITIES_DECLARATION_2, class T2, class F2>				\
-constexpr Quantity<BASE_QUANTITIES_OP(UNIT_OP), OP_RESULT_TYPE(T1, OP, T2)>		\
-operator OP(const Quantity<BASE_QUANTITIES_1, T1, F1>& x,				\
-	    const Quantity<BASE_QUANTITIES_2, T2, F2>& y)				\
+template <BASE_QUANTITIES_DECLARATION_1, class T1, class F1, int Root1,			\
+	  BASE_QUANTITIES_DECLARATION_2, class T2, class F2, int Root2>			\
+constexpr NORMALIZED_QUANTITY(OP_RESULT_TYPE(T1, OP, T2),				\
+			      detail::DefaultFormat,					\
+			      Root1 * Root2,						\
+			      BASE_QUANTITIES_ROOT_OP(UNIT_OP))				\
+operator OP(const Quantity<BASE_QUANTITIES_1, T1, F1, Root1>& x,			\
+	    const Quantity<BASE_QUANTITIES_2, T2, F2, Root2>& y)			\
 {											\
-	return Quantity<BASE_QUANTITIES_OP(UNIT_OP), OP_RESULT_TYPE(T1, OP, T2)>(	\
-		x.Value() OP y.Value()							\
-	);										\
+	return NORMALIZED_QUANTITY(OP_RESULT_TYPE(T1, OP, T2),				\
+				   detail::DefaultFormat,				\
+				   Root1 * Root2,					\
+				   BASE_QUANTITIES_ROOT_OP(UNIT_OP))			\
+	       (									\
+			x.Value() OP y.Value()						\
+	       );									\
 }											\
 											\
-template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>			\
-constexpr Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2), F>			\
-operator OP(const Quantity<BASE_QUANTITIES, T1, F>& x, const T2& y) {			\
-	return Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2), F>(		\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T1, class F, class T2>		\
+constexpr Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2), F, Root>		\
+operator OP(const Quantity<BASE_QUANTITIES, T1, F, Root>& x, const T2& y) {		\
+	return Quantity<BASE_QUANTITIES, OP_RESULT_TYPE(T1, OP, T2), F, Root>(		\
 		x.Value() OP y								\
 	);										\
 }											\
 											\
-template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>			\
-constexpr Quantity<BASE_QUANTITIES_UNARY_OP(UNIT_OP), OP_RESULT_TYPE(T2, OP, T1), F>	\
-operator OP(const T2& x, const Quantity<BASE_QUANTITIES, T1, F>& y) {			\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T1, class F, class T2>		\
+constexpr Quantity<BASE_QUANTITIES_UNARY_OP(UNIT_OP),					\
+		   OP_RESULT_TYPE(T2, OP, T1),						\
+		   SCALAR_OP_FORMAT(UNIT_OP, F, Root),					\
+		   Root>								\
+operator OP(const T2& x, const Quantity<BASE_QUANTITIES, T1, F, Root>& y) {		\
 	return Quantity<BASE_QUANTITIES_UNARY_OP(UNIT_OP),				\
 			OP_RESULT_TYPE(T2, OP, T1),					\
-			F>								\
+			SCALAR_OP_FORMAT(UNIT_OP, F, Root),				\
+			Root>								\
 	       (									\
 			x OP y.Value()							\
 	       );									\
 }											\
 											\
-template <BASE_QUANTITIES_DECLARATION, class T1, class F, class T2>			\
-constexpr Quantity<BASE_QUANTITIES, T1, F>&						\
-operator OP##=(Quantity<BASE_QUANTITIES, T1, F>& x, const T2& y) {			\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T1, class F, class T2>		\
+constexpr Quantity<BASE_QUANTITIES, T1, F, Root>&					\
+operator OP##=(Quantity<BASE_QUANTITIES, T1, F, Root>& x, const T2& y) {		\
 	return (x.value OP##= y, x);							\
 }
 
 DECLARE_MULTIPLICATIVE_QUANTITY_OPERATOR(*, +)
 DECLARE_MULTIPLICATIVE_QUANTITY_OPERATOR(/, -)
 
-#define DECLARE_UNARY_QUANTITY_OPERATOR(OP)			\
-template <BASE_QUANTITIES_DECLARATION, class T, class F>	\
-constexpr Quantity<BASE_QUANTITIES, T, F>			\
-operator OP(Quantity<BASE_QUANTITIES, T, F> x) {		\
-	return Quantity<BASE_QUANTITIES, T, F>(OP x.Value());	\
+#define DECLARE_UNARY_QUANTITY_OPERATOR(OP)				\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>	\
+constexpr Quantity<BASE_QUANTITIES, T, F, Root>				\
+operator OP(Quantity<BASE_QUANTITIES, T, F, Root> x) {			\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(OP x.Value());	\
 }
 
 DECLARE_UNARY_QUANTITY_OPERATOR(+)
 DECLARE_UNARY_QUANTITY_OPERATOR(-)
 
-#define DECLARE_PREFIX_QUANTITY_OPERATOR(OP)			\
-template <BASE_QUANTITIES_DECLARATION, class T, class F>	\
-constexpr Quantity<BASE_QUANTITIES, T, F>&			\
-operator OP(Quantity<BASE_QUANTITIES, T, F>& x) {		\
-	return (OP x.value, x);					\
+#define DECLARE_PREFIX_QUANTITY_OPERATOR(OP)				\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>	\
+constexpr Quantity<BASE_QUANTITIES, T, F, Root>&			\
+operator OP(Quantity<BASE_QUANTITIES, T, F, Root>& x) {			\
+	return (OP x.value, x);						\
 }
 
 DECLARE_PREFIX_QUANTITY_OPERATOR(++)
 DECLARE_PREFIX_QUANTITY_OPERATOR(--)
 
-#define DECLARE_POSTFIX_QUANTITY_OPERATOR(OP)			\
-template <BASE_QUANTITIES_DECLARATION, class T, class F>	\
-constexpr Quantity<BASE_QUANTITIES, T, F>			\
-operator OP(Quantity<BASE_QUANTITIES, T, F>& x, int) {		\
-	return Quantity<BASE_QUANTITIES, T, F>(x.value OP);	\
+#define DECLARE_POSTFIX_QUANTITY_OPERATOR(OP)				\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>	\
+constexpr Quantity<BASE_QUANTITIES, T, F, Root>				\
+operator OP(Quantity<BASE_QUANTITIES, T, F, Root>& x, int) {		\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(x.value OP);	\
 }
 
 DECLARE_POSTFIX_QUANTITY_OPERATOR(++)
 DECLARE_POSTFIX_QUANTITY_OPERATOR(--)
 
-#define DECLARE_QUANTITY_COMPARISON_OPERATOR(OP)					\
-template <BASE_QUANTITIES_DECLARATION, class T1, class F1, class T2, class F2>		\
-constexpr bool										\
-operator OP(Quantity<BASE_QUANTITIES, T1, F1> x, Quantity<BASE_QUANTITIES, T2, F2> y) {	\
-	return x.Value() OP y.Value();							\
+#define DECLARE_QUANTITY_COMPARISON_OPERATOR(OP)				\
+template <BASE_QUANTITIES_DECLARATION, int Root,				\
+	  class T1, class F1,							\
+	  class T2, class F2>							\
+constexpr bool									\
+operator OP(Quantity<BASE_QUANTITIES, T1, F1, Root> x,				\
+	    Quantity<BASE_QUANTITIES, T2, F2, Root> y)				\
+{										\
+	return x.Value() OP y.Value();						\
 }
 
 DECLARE_QUANTITY_COMPARISON_OPERATOR(==)
@@ -525,9 +668,9 @@ DECLARE_QUANTITY_COMPARISON_OPERATOR(>=)
 DECLARE_QUANTITY_COMPARISON_OPERATOR(<)
 DECLARE_QUANTITY_COMPARISON_OPERATOR(<=)
 
-template <BASE_QUANTITIES_DECLARATION, class T, class Format>
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class Format>
 std::ostream& operator <<(std::ostream& stream,
-			  const Quantity<BASE_QUANTITIES, T, Format>& quantity)
+			  const Quantity<BASE_QUANTITIES, T, Format, Root>& quantity)
 {
 	return stream << Format::Format(quantity.Value());
 }
@@ -621,6 +764,12 @@ constexpr decltype(UNIT.n##N()) UNIT##_n##N = 1.0_##UNIT##_n##N;	\
 									\
 DECLARE_MULTIPLIER_POWERS(QUANTITY, UNIT, N)
 
+// The _pN and _nN literals make up most of what the compiler has to chew
+// through in this file.  Code that spells powers as .pN(), or with UNIT from
+// btul_unit_literal.h, can define NO_POWER_LITERALS to leave them out.
+#ifdef NO_POWER_LITERALS
+#define DECLARE_POWERS(QUANTITY, UNIT)
+#else
 #define DECLARE_POWERS(QUANTITY, UNIT)	\
 DECLARE_POWER(QUANTITY, UNIT, 0);	\
 DECLARE_POWER(QUANTITY, UNIT, 1);	\
@@ -632,6 +781,7 @@ DECLARE_POWER(QUANTITY, UNIT, 6);	\
 DECLARE_POWER(QUANTITY, UNIT, 7);	\
 DECLARE_POWER(QUANTITY, UNIT, 8);	\
 DECLARE_POWER(QUANTITY, UNIT, 9)
+#endif
 
 #define DECLARE_QUANTITY_IMPL(QUANTITY, UNIT, MULTIPLIER)		\
 constexpr QUANTITY operator "" _##UNIT(long double value) {		\
@@ -698,13 +848,19 @@ typedef Quantity<0, 0, 0, 0, 0, 0, 1> Luminosity;
 DECLARE_BASE_QUANTITY(Luminosity, cd, 1.0L);
 
 
-DECLARE_DERIVED_QUANTITY(Force, N, kg*m/s_p2);
+DECLARE_DERIVED_QUANTITY(Force, N, kg*m/s.p2());
 DECLARE_DERIVED_QUANTITY(Energy, J, N*m);
-DECLARE_DERIVED_QUANTITY(Frequency, Hz, s_n1);
+DECLARE_DERIVED_QUANTITY(Frequency, Hz, s.n1());
 DECLARE_DERIVED_QUANTITY(Angle, rad, m/m);
 
+// These print the expression that defines them.
+#ifdef NO_POWER_LITERALS
+DECLARE_DERIVED_QUANTITY_NO_SYMBOL(Area, m.p2());
+DECLARE_DERIVED_QUANTITY_NO_SYMBOL(Volume, m.p3());
+#else
 DECLARE_DERIVED_QUANTITY_NO_SYMBOL(Area, m_p2);
 DECLARE_DERIVED_QUANTITY_NO_SYMBOL(Volume, m_p3);
+#endif
 DECLARE_DERIVED_QUANTITY_NO_SYMBOL(Moment, N*m);
 
 #endif // BTUL_H
@@ -0,0 +1,190 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_ACCUMULATOR_H
+#define BTUL_ACCUMULATOR_H
+
+#include <btul.h>
+
+#include <cmath>
+#include <cstdint>
+
+
+/// Kahan's compensated summation.  Carries the rounding error of each
+/// addition forward in a second register, giving close to twice the working
+/// precision for the cost of four flops per addition.
+template <class Number = double>
+class KahanSummation {
+public:
+	void Add(Number x) {
+		Number y = x - compensation;
+		Number t = sum + y;
+		compensation = (t - sum) - y;
+		sum = t;
+	}
+
+	void Merge(const KahanSummation& other) {
+		Add(other.sum);
+		compensation += other.compensation;
+	}
+
+	/// The total, with the compensation folded in in \a Result, which
+	/// can be wider than Number.
+	template <class Result = Number>
+	Result Total() const {
+		return Result(sum) - Result(compensation);
+	}
+
+private:
+	Number sum = 0;
+	Number compensation = 0;
+};
+
+/// Neumaier's variant of compensated summation.  Unlike plain Kahan, it
+/// remains accurate when an addend is larger in magnitude than the running
+/// sum, which makes it the safer default.
+template <class Number = double>
+class NeumaierSummation {
+public:
+	void Add(Number x) {
+		Number t = sum + x;
+		compensation += std::fabs(sum) >= std::fabs(x) ?
+				(sum - t) + x :
+				(x - t) + sum;
+		sum = t;
+	}
+
+	void Merge(const NeumaierSummation& other) {
+		Add(other.sum);
+		compensation += other.compensation;
+	}
+
+	template <class Result = Number>
+	Result Total() const {
+		return Result(sum) + Result(compensation);
+	}
+
+private:
+	Number sum = 0;
+	Number compensation = 0;
+};
+
+/// Streaming pairwise summation.  Partial sums are kept on a binary carry
+/// chain, so every addition combines two sums of (nearly) equal size and the
+/// error grows with log(n) rather than n.  No allocation is performed; the
+/// chain is bounded by the width of the counter.
+template <class Number = double>
+class PairwiseSummation {
+public:
+	void Add(Number x) {
+		Insert(x, 0);
+	}
+
+	void Merge(const PairwiseSummation& other) {
+		for (int level = 0; level < LEVELS; ++level) {
+			if (other.count & (std::uint64_t(1) << level)) {
+				Insert(other.partials[level], level);
+			}
+		}
+	}
+
+	template <class Result = Number>
+	Result Total() const {
+		Result total = 0;
+		for (int level = 0; level < LEVELS; ++level) {
+			if (count & (std::uint64_t(1) << level)) {
+				total += Result(partials[level]);
+			}
+		}
+		return total;
+	}
+
+private:
+	static constexpr int LEVELS = 64;
+
+	// Adds a partial sum of 2^level values, propagating carries upward
+	// exactly like incrementing a binary counter.
+	void Insert(Number carry, int level) {
+		while (level < LEVELS - 1 && (count & (std::uint64_t(1) << level))) {
+			carry += partials[level];
+			count -= std::uint64_t(1) << level;
+			++level;
+		}
+		partials[level] = (count & (std::uint64_t(1) << level)) ?
+				  partials[level] + carry :
+				  carry;
+		count |= std::uint64_t(1) << level;
+	}
+
+	std::uint64_t count = 0;
+	Number partials[LEVELS] = {};
+};
+
+
+/// Accumulates a running total of a quantity using a compensated summation
+/// policy.  The policy's working type is usually double, so long totals can
+/// be kept at double speed without paying for long double arithmetic on every
+/// addition, while still being accurate to well beyond double precision.
+///
+/// \code
+/// QuantityAccumulator<Energy> consumed;
+/// for (...) {
+/// 	consumed += step;
+/// }
+/// Energy total = consumed.Total();
+/// \endcode
+template <class Q, class Summation = NeumaierSummation<double>>
+class QuantityAccumulator {
+public:
+	QuantityAccumulator& operator +=(const Q& x) {
+		summation.Add(x.Value());
+		return *this;
+	}
+
+	QuantityAccumulator& operator -=(const Q& x) {
+		summation.Add(-x.Value());
+		return *this;
+	}
+
+	/// Folds another accumulator's total into this one, e.g. to combine
+	/// partial sums computed on separate threads.
+	QuantityAccumulator& Merge(const QuantityAccumulator& other) {
+		summation.Merge(other.summation);
+		return *this;
+	}
+
+	/// The total, with the policy's parts combined in the Number type of
+	/// Q, so that a long double quantity gets the extra precision that
+	/// the compensation carries.
+	Q Total() const {
+		return Q(summation.template Total<typename Q::type>());
+	}
+
+	void Reset() {
+		summation = Summation();
+	}
+
+private:
+	Summation summation;
+};
+
+#endif // BTUL_ACCUMULATOR_H
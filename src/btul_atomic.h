@@ -0,0 +1,189 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_ATOMIC_H
+#define BTUL_ATOMIC_H
+
+#include <btul.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace detail {
+	// Hands out a small, stable index to each thread the first time it asks,
+	// so that threads can be spread across shards without any coordination
+	// on the hot path.
+	inline std::size_t threadIndex() {
+		static std::atomic<std::size_t> next(0);
+		thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+		return index;
+	}
+
+	template <class Number>
+	Number fetchAdd(std::atomic<Number>& value, Number x, std::memory_order order) {
+		Number expected = value.load(std::memory_order_relaxed);
+		while (!value.compare_exchange_weak(expected, expected + x,
+						    order, std::memory_order_relaxed)) {}
+		return expected;
+	}
+}
+
+
+/// An atomic total of a physical quantity.  The interface mirrors
+/// std::atomic, but takes and returns quantities of the keyed dimension.
+///
+/// The value is stored as \a Number rather than the quantity's own number type,
+/// since the default long double is not lock-free on most platforms.
+/// Arithmetic is implemented with compare-and-swap loops on the underlying
+/// representation.
+template <class Q, class Number = double>
+class AtomicQuantity {
+public:
+	AtomicQuantity()
+		: value(0)
+	{}
+
+	explicit AtomicQuantity(Q initial)
+		: value(initial.Value())
+	{}
+
+	AtomicQuantity(const AtomicQuantity&) = delete;
+	AtomicQuantity& operator =(const AtomicQuantity&) = delete;
+
+	bool is_lock_free() const {
+		return value.is_lock_free();
+	}
+
+	Q load(std::memory_order order = std::memory_order_seq_cst) const {
+		return Q(value.load(order));
+	}
+
+	void store(Q x, std::memory_order order = std::memory_order_seq_cst) {
+		value.store(x.Value(), order);
+	}
+
+	Q exchange(Q x, std::memory_order order = std::memory_order_seq_cst) {
+		return Q(value.exchange(x.Value(), order));
+	}
+
+	bool compare_exchange_weak(Q& expected, Q desired,
+				   std::memory_order order = std::memory_order_seq_cst)
+	{
+		Number raw = expected.Value();
+		bool exchanged = value.compare_exchange_weak(raw, desired.Value(), order);
+		expected = Q(raw);
+		return exchanged;
+	}
+
+	bool compare_exchange_strong(Q& expected, Q desired,
+				     std::memory_order order = std::memory_order_seq_cst)
+	{
+		Number raw = expected.Value();
+		bool exchanged = value.compare_exchange_strong(raw, desired.Value(), order);
+		expected = Q(raw);
+		return exchanged;
+	}
+
+	/// Adds \a x, returning the value held immediately before.
+	Q fetch_add(Q x, std::memory_order order = std::memory_order_seq_cst) {
+		return Q(detail::fetchAdd<Number>(value, x.Value(), order));
+	}
+
+	/// Subtracts \a x, returning the value held immediately before.
+	Q fetch_sub(Q x, std::memory_order order = std::memory_order_seq_cst) {
+		return Q(detail::fetchAdd<Number>(value, -x.Value(), order));
+	}
+
+	Q operator +=(Q x) {
+		return fetch_add(x) + x;
+	}
+
+	Q operator -=(Q x) {
+		return fetch_sub(x) - x;
+	}
+
+	operator Q() const {
+		return load();
+	}
+
+private:
+	std::atomic<Number> value;
+};
+
+
+/// A total of a physical quantity which is written by many threads and read
+/// rarely.  Each thread adds into its own cache-line sized shard, so writers
+/// never contend unless there are more threads than shards; reads pay for
+/// this by summing every shard.
+///
+/// Shards are assigned per thread rather than per core, as there is no
+/// portable way to ask which core a thread is running on.  With threads
+/// pinned to cores the two are equivalent.
+template <class Q, class Number = double, std::size_t Shards = 64>
+class ShardedQuantityAccumulator {
+public:
+	ShardedQuantityAccumulator() {
+		Reset();
+	}
+
+	ShardedQuantityAccumulator(const ShardedQuantityAccumulator&) = delete;
+	ShardedQuantityAccumulator& operator =(const ShardedQuantityAccumulator&) = delete;
+
+	ShardedQuantityAccumulator& operator +=(Q x) {
+		detail::fetchAdd<Number>(shard().value, x.Value(), std::memory_order_relaxed);
+		return *this;
+	}
+
+	ShardedQuantityAccumulator& operator -=(Q x) {
+		detail::fetchAdd<Number>(shard().value, -x.Value(), std::memory_order_relaxed);
+		return *this;
+	}
+
+	/// Sums all shards.  Additions which happen concurrently with the call
+	/// may or may not be included.
+	Q Load() const {
+		Number total = 0;
+		for (const Shard& s : shards) {
+			total += s.value.load(std::memory_order_relaxed);
+		}
+		return Q(total);
+	}
+
+	void Reset() {
+		for (Shard& s : shards) {
+			s.value.store(0, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	struct alignas(detail::CACHE_LINE_SIZE) Shard {
+		std::atomic<Number> value;
+	};
+
+	Shard& shard() {
+		return shards[detail::threadIndex() % Shards];
+	}
+
+	Shard shards[Shards];
+};
+
+#endif // BTUL_ATOMIC_H
@@ -0,0 +1,287 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_BAM_H
+#define BTUL_BAM_H
+
+#include <btul.h>
+#include <btul_span.h>
+#include <btul_trig.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+
+namespace detail {
+	namespace bam {
+		constexpr long double PI = 3.14159265358979323846264338327950288L;
+
+		/// 2^bits, the number of steps in a turn.
+		template <class Word>
+		constexpr double steps() {
+			return 2.0 * (Word(1) << (std::numeric_limits<Word>::digits - 1));
+		}
+	}
+}
+
+/// An angle stored as an unsigned binary fraction of a full turn (a binary
+/// angular measurement).  Wrapping around the circle is ordinary unsigned
+/// overflow, so sums and differences of headings or phases are exact and
+/// never need an fmod.  The trigonometric functions reduce the argument
+/// exactly, by splitting off the top two bits as the quadrant.
+///
+/// \code
+/// BinaryAngle32 heading(1.5_rad);
+/// heading += BinaryAngle32::FromTurns(0.75);	// Wraps around.
+/// double north = cos(heading);
+/// Angle bearing = heading.ToSignedAngle();
+/// \endcode
+template <class Word>
+class BinaryAngle {
+	static_assert(std::is_unsigned<Word>::value,
+		      "Binary angles must be stored in an unsigned type");
+
+public:
+	static constexpr int BITS = std::numeric_limits<Word>::digits;
+
+	constexpr BinaryAngle() : value(0) {}
+
+	/// Converts from radians, wrapping into [0, 2pi).
+	template <class T, class F>
+	explicit BinaryAngle(const Quantity<0, 0, 0, 0, 0, 0, 0, T, F>& angle)
+		: value(FromTurns(double(angle.Value() / (2 * detail::bam::PI))).value)
+	{}
+
+	/// Takes the raw fraction of a turn, in units of 2^-BITS turns.
+	static constexpr BinaryAngle FromBits(Word bits) {
+		return BinaryAngle(bits, 0);
+	}
+
+	/// Converts from a number of turns, wrapping into [0, 1).
+	static BinaryAngle FromTurns(double turns) {
+		double fraction = turns - std::floor(turns);
+		// The fraction may round up to a whole turn.
+		fraction = fraction < 1 ? fraction : 0;
+		return BinaryAngle(Word(std::uint64_t(fraction * detail::bam::steps<Word>() +
+						      ROUNDING)),
+				   0);
+	}
+
+	constexpr Word Value() const {
+		return value;
+	}
+
+	/// The angle as a fraction of a turn, in [0, 1).
+	constexpr double Turns() const {
+		return value / detail::bam::steps<Word>();
+	}
+
+	/// The angle in [0, 2pi).
+	constexpr Angle ToAngle() const {
+		return Angle(value * (2 * detail::bam::PI / detail::bam::steps<Word>()));
+	}
+
+	/// The angle in [-pi, pi).
+	constexpr Angle ToSignedAngle() const {
+		return Angle(typename std::make_signed<Word>::type(value) *
+			     (2 * detail::bam::PI / detail::bam::steps<Word>()));
+	}
+
+	BinaryAngle& operator +=(BinaryAngle other) {
+		value += other.value;
+		return *this;
+	}
+
+	BinaryAngle& operator -=(BinaryAngle other) {
+		value -= other.value;
+		return *this;
+	}
+
+	BinaryAngle& operator *=(Word factor) {
+		value *= factor;
+		return *this;
+	}
+
+	friend constexpr BinaryAngle operator +(BinaryAngle x, BinaryAngle y) {
+		return BinaryAngle(Word(x.value + y.value), 0);
+	}
+
+	friend constexpr BinaryAngle operator -(BinaryAngle x, BinaryAngle y) {
+		return BinaryAngle(Word(x.value - y.value), 0);
+	}
+
+	friend constexpr BinaryAngle operator -(BinaryAngle x) {
+		return BinaryAngle(Word(-x.value), 0);
+	}
+
+	friend constexpr BinaryAngle operator *(BinaryAngle x, Word factor) {
+		return BinaryAngle(Word(x.value * factor), 0);
+	}
+
+	friend constexpr BinaryAngle operator *(Word factor, BinaryAngle x) {
+		return BinaryAngle(Word(factor * x.value), 0);
+	}
+
+	// Angles on a circle have no order, so only equality is provided.
+
+	friend constexpr bool operator ==(BinaryAngle x, BinaryAngle y) {
+		return x.value == y.value;
+	}
+
+	friend constexpr bool operator !=(BinaryAngle x, BinaryAngle y) {
+		return x.value != y.value;
+	}
+
+private:
+	// Conversions from turns round to the nearest step, except in 64 bits,
+	// where a double has no fractional bits to round.
+	static constexpr double ROUNDING = BITS < 64 ? 0.5 : 0;
+
+	constexpr BinaryAngle(Word value, int) : value(value) {}
+
+	Word value;
+};
+
+typedef BinaryAngle<std::uint32_t> BinaryAngle32;
+typedef BinaryAngle<std::uint64_t> BinaryAngle64;
+
+namespace detail {
+	namespace bam {
+		// Pi, split into its leading 24 bits and the remainder.
+		constexpr double PI_HI = 3.1415927410125732;
+		constexpr double PI_LO = -8.74227800037248512729e-08;
+
+		/// Splits the angle into the nearest multiple of a quarter turn
+		/// and the remainder in radians, in [-pi/4, pi/4).  Unlike the
+		/// reduction of a floating point angle, this is exact; only the
+		/// conversion of the remainder to radians rounds.
+		template <class Word>
+		inline double reduce(BinaryAngle<Word> x, int& quadrant) {
+			typedef typename std::make_signed<Word>::type Signed;
+			const int bits = BinaryAngle<Word>::BITS;
+			Word q = Word(x.Value() + (Word(1) << (bits - 3))) >> (bits - 2);
+			quadrant = int(q);
+			Signed remainder = Signed(Word(x.Value() - (q << (bits - 2))));
+
+			// Both halves of the remainder convert to double exactly,
+			// and the product of the high half with the leading bits
+			// of pi is exact too.  In 32 bits the high half is zero,
+			// and the low half has few enough bits for its product
+			// to be exact instead.
+			Signed low = remainder & Signed(0xFFFFFFFFu);
+			double high = double(remainder - low);
+			double scale = 2 / steps<Word>();
+			return high * (PI_HI * scale) +
+			       (double(low) * (PI_HI * scale) +
+				(high + double(low)) * (PI_LO * scale));
+		}
+
+		template <class Accuracy, class Word>
+		inline void sincos(BinaryAngle<Word> x, double& sine, double& cosine) {
+			int quadrant;
+			double r = reduce(x, quadrant);
+			trig::unreduce<Accuracy>(r, 0.0, quadrant, sine, cosine);
+		}
+	}
+}
+
+
+// Scalar overloads.  These need no range checking, and so have no fallback to
+// libm.
+
+template <class Accuracy = PreciseTrig, class Word>
+double sin(BinaryAngle<Word> x) {
+	double sine, cosine;
+	detail::bam::sincos<Accuracy>(x, sine, cosine);
+	return sine;
+}
+
+template <class Accuracy = PreciseTrig, class Word>
+double cos(BinaryAngle<Word> x) {
+	double sine, cosine;
+	detail::bam::sincos<Accuracy>(x, sine, cosine);
+	return cosine;
+}
+
+template <class Accuracy = PreciseTrig, class Word>
+std::pair<double, double> sincos(BinaryAngle<Word> x) {
+	std::pair<double, double> result;
+	detail::bam::sincos<Accuracy>(x, result.first, result.second);
+	return result;
+}
+
+
+// Span overloads.  The std::array overloads in btul_trig.h find these too.
+
+template <class Accuracy = PreciseTrig, class Word>
+void sin(QuantitySpan<const BinaryAngle<Word>> in, QuantitySpan<double> out) {
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		double cosine;
+		detail::bam::sincos<Accuracy>(in[i], out[i], cosine);
+	}
+}
+
+template <class Accuracy = PreciseTrig, class Word>
+void cos(QuantitySpan<const BinaryAngle<Word>> in, QuantitySpan<double> out) {
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		double sine;
+		detail::bam::sincos<Accuracy>(in[i], sine, out[i]);
+	}
+}
+
+template <class Accuracy = PreciseTrig, class Word>
+void sincos(QuantitySpan<const BinaryAngle<Word>> in,
+	    QuantitySpan<double> sines,
+	    QuantitySpan<double> cosines)
+{
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		detail::bam::sincos<Accuracy>(in[i], sines[i], cosines[i]);
+	}
+}
+
+/// Converts each angle in \a in to radians, in [-pi, pi).
+template <class Word, class R>
+void ToSignedAngles(QuantitySpan<const BinaryAngle<Word>> in, QuantitySpan<R> out) {
+	static_assert(detail::trig::dimensionless<R>(),
+		      "Output span has the wrong dimensions");
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		out[i] = R(typename std::make_signed<Word>::type(in[i].Value()) *
+			   double(2 * detail::bam::PI / detail::bam::steps<Word>()));
+	}
+}
+
+/// Converts each angle in \a in from radians, wrapping into [0, 2pi).
+template <class Q, class Word>
+void FromAngles(QuantitySpan<Q> in, QuantitySpan<BinaryAngle<Word>> out) {
+	static_assert(detail::trig::dimensionless<Q>(),
+		      "Input span has the wrong dimensions");
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		out[i] = BinaryAngle<Word>(in[i]);
+	}
+}
+
+#endif // BTUL_BAM_H
@@ -0,0 +1,296 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_BINARY_H
+#define BTUL_BINARY_H
+
+#include <btul.h>
+#include <btul_span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// A compact binary format for arrays of quantities: a 32-byte header giving
+// the dimensions, the Number type and the byte order, followed by the raw
+// values.  Writing is a single bulk write, and reading checks the header
+// once and then copies the values straight into place, or, for a buffer
+// that is already in memory (e.g. a mapped file), does not copy them at all:
+//
+//	WriteQuantities(file, QuantitySpan<const Length>(lengths));
+//	std::vector<Length> copy = ReadQuantities<Length>(file);
+//	QuantitySpan<const Length> view = ViewQuantities<Length>(mapped, size);
+//
+// Reading throws a SerializationError if the data is not in this format, and
+// a DimensionMismatch if it holds some other quantity or Number type.
+
+/// The data being read is not a valid array of quantities.
+class SerializationError : public std::runtime_error {
+public:
+	explicit SerializationError(const std::string& what)
+		: std::runtime_error(what)
+	{}
+};
+
+/// The data being read is a valid array of some other type of quantity.
+class DimensionMismatch : public SerializationError {
+public:
+	explicit DimensionMismatch(const std::string& what)
+		: SerializationError(what)
+	{}
+};
+
+/// The header that precedes the values.  All fields are single bytes except
+/// count, which is in the byte order given by endianness.  The size is a
+/// multiple of 16, so that the values that follow it are aligned in a
+/// mapped file.
+struct QuantityHeader {
+	static constexpr std::uint8_t LITTLE_ENDIAN_ORDER = 1;
+	static constexpr std::uint8_t BIG_ENDIAN_ORDER = 2;
+
+	char magic[4];
+	std::uint8_t version;
+	std::uint8_t endianness;
+	/// One of the codes in detail::binary::numberCode.
+	std::uint8_t number;
+	/// sizeof the Number type, which for long double varies by platform.
+	std::uint8_t numberSize;
+	/// length, mass, time, current, temperature, amount, luminosity and
+	/// root, as in the Quantity's static members.
+	std::int8_t exponents[8];
+	std::uint64_t count;
+	std::uint8_t reserved[8];
+};
+
+static_assert(sizeof(QuantityHeader) == 32, "QuantityHeader must be packed");
+
+namespace detail {
+	namespace binary {
+		constexpr char MAGIC[4] = {'B', 'T', 'U', 'L'};
+		constexpr std::uint8_t VERSION = 1;
+
+		/// How much ReadQuantities reads at a time, bounding what a corrupt
+		/// count can make it allocate before the data runs out.
+		constexpr std::size_t READ_CHUNK_BYTES = 1 << 20;
+
+		constexpr std::uint8_t nativeEndianness() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			return QuantityHeader::BIG_ENDIAN_ORDER;
+#else
+			return QuantityHeader::LITTLE_ENDIAN_ORDER;
+#endif
+		}
+
+		/// A code for each Number type that can be stored; 0 for the
+		/// rest.
+		template <class T>
+		constexpr std::uint8_t numberCode() {
+			return std::is_same<T, float>::value ? 1 :
+			       std::is_same<T, double>::value ? 2 :
+			       std::is_same<T, long double>::value ? 3 :
+			       std::is_integral<T>::value && std::is_signed<T>::value ? 4 :
+			       std::is_integral<T>::value ? 5 :
+			       0;
+		}
+
+		inline const char* numberName(std::uint8_t code) {
+			switch (code) {
+				case 1: return "float";
+				case 2: return "double";
+				case 3: return "long double";
+				case 4: return "signed integer";
+				case 5: return "unsigned integer";
+				default: return "unknown";
+			}
+		}
+
+		inline void reverseBytes(char* begin, std::size_t size) {
+			for (std::size_t i = 0; i < size / 2; ++i) {
+				std::swap(begin[i], begin[size - 1 - i]);
+			}
+		}
+
+		inline std::string dimensions(const std::int8_t (&exponents)[8]) {
+			std::string result = "(";
+			for (int i = 0; i < 8; ++i) {
+				result += std::to_string(int(exponents[i]));
+				result += i < 7 ? (i < 6 ? ", " : ") / ") : "";
+			}
+			return result;
+		}
+
+		template <class Q>
+		void checkLayout() {
+			static_assert(sizeof(Q) == sizeof(typename Q::type),
+				      "Quantity must wrap a bare Number");
+			static_assert(numberCode<typename Q::type>() != 0,
+				      "Only arithmetic Number types can be serialized");
+		}
+	}
+}
+
+/// The header for an array of \a count values of Q, in native byte order.
+template <class Q>
+QuantityHeader HeaderFor(std::uint64_t count) {
+	detail::binary::checkLayout<Q>();
+	QuantityHeader header = {};
+	std::memcpy(header.magic, detail::binary::MAGIC, sizeof(header.magic));
+	header.version = detail::binary::VERSION;
+	header.endianness = detail::binary::nativeEndianness();
+	header.number = detail::binary::numberCode<typename Q::type>();
+	header.numberSize = sizeof(typename Q::type);
+	header.exponents[0] = Q::length;
+	header.exponents[1] = Q::mass;
+	header.exponents[2] = Q::time;
+	header.exponents[3] = Q::current;
+	header.exponents[4] = Q::temperature;
+	header.exponents[5] = Q::amount;
+	header.exponents[6] = Q::luminosity;
+	header.exponents[7] = Q::root;
+	header.count = count;
+	return header;
+}
+
+namespace detail {
+	namespace binary {
+		/// Checks that \a header describes an array of Q, and returns
+		/// whether its values are in the opposite byte order, with the
+		/// count converted to native order.
+		template <class Q>
+		bool validate(QuantityHeader& header) {
+			if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+				throw SerializationError("Not a btul quantity array");
+			}
+			if (header.version != VERSION) {
+				throw SerializationError("Unsupported quantity array version " +
+							 std::to_string(int(header.version)));
+			}
+			if (header.endianness != QuantityHeader::LITTLE_ENDIAN_ORDER &&
+			    header.endianness != QuantityHeader::BIG_ENDIAN_ORDER) {
+				throw SerializationError("Invalid byte order in quantity array");
+			}
+
+			QuantityHeader expected = HeaderFor<Q>(0);
+			if (std::memcmp(header.exponents, expected.exponents, sizeof(expected.exponents)) != 0) {
+				throw DimensionMismatch("Expected quantities of dimensions " +
+							dimensions(expected.exponents) + ", found " +
+							dimensions(header.exponents));
+			}
+			if (header.number != expected.number || header.numberSize != expected.numberSize) {
+				throw DimensionMismatch(std::string("Expected values of type ") +
+							numberName(expected.number) + " (" +
+							std::to_string(int(expected.numberSize)) +
+							" bytes), found " + numberName(header.number) +
+							" (" + std::to_string(int(header.numberSize)) +
+							" bytes)");
+			}
+
+			bool swapped = header.endianness != nativeEndianness();
+			if (swapped) {
+				reverseBytes(reinterpret_cast<char*>(&header.count), sizeof(header.count));
+			}
+			return swapped;
+		}
+	}
+}
+
+/// Writes a header and the values of \a values to \a stream.
+template <class Q>
+void WriteQuantities(std::ostream& stream, QuantitySpan<const Q> values) {
+	QuantityHeader header = HeaderFor<Q>(values.size());
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(values.data()),
+		     std::streamsize(values.size() * sizeof(Q)));
+}
+
+/// Reads an array written by WriteQuantities, byte-swapping it if it was
+/// written on a machine of the opposite endianness.
+template <class Q>
+std::vector<Q> ReadQuantities(std::istream& stream) {
+	QuantityHeader header;
+	if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		throw SerializationError("Truncated quantity array header");
+	}
+	bool swapped = detail::binary::validate<Q>(header);
+	if (swapped && header.number == detail::binary::numberCode<long double>()) {
+		throw SerializationError("Cannot convert the byte order of long double");
+	}
+
+	// The count is untrusted until the values behind it have been read, so
+	// grow the array a chunk at a time rather than allocating it up front.
+	std::vector<Q> values;
+	if (header.count > values.max_size()) {
+		throw SerializationError("Truncated quantity array");
+	}
+	const std::size_t count = std::size_t(header.count);
+	const std::size_t chunk = detail::binary::READ_CHUNK_BYTES / sizeof(Q) + 1;
+	values.reserve(std::min(count, chunk));
+	while (values.size() < count) {
+		std::size_t offset = values.size();
+		std::size_t n = std::min(count - offset, chunk);
+		values.resize(offset + n);
+		if (!stream.read(reinterpret_cast<char*>(values.data() + offset),
+				 std::streamsize(n * sizeof(Q)))) {
+			throw SerializationError("Truncated quantity array");
+		}
+	}
+	if (swapped) {
+		for (Q& value : values) {
+			detail::binary::reverseBytes(reinterpret_cast<char*>(&value), sizeof(Q));
+		}
+	}
+	return values;
+}
+
+/// A view of the values of an array written by WriteQuantities, in a buffer
+/// of \a size bytes at \a data that holds the whole array, without copying
+/// them.  \a data must be aligned for Q, as the start of a mapped file is.
+/// The array must be in native byte order; use ReadQuantities for the
+/// others.
+template <class Q>
+QuantitySpan<const Q> ViewQuantities(const void* data, std::size_t size) {
+	QuantityHeader header;
+	if (size < sizeof(header)) {
+		throw SerializationError("Truncated quantity array header");
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (detail::binary::validate<Q>(header)) {
+		throw SerializationError("Quantity array is not in native byte order");
+	}
+	if (header.count > (size - sizeof(header)) / sizeof(Q)) {
+		throw SerializationError("Truncated quantity array");
+	}
+	return QuantitySpan<const Q>(
+		reinterpret_cast<const Q*>(static_cast<const char*>(data) + sizeof(header)),
+		std::size_t(header.count));
+}
+
+#endif // BTUL_BINARY_H
@@ -0,0 +1,281 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_CHAIN_H
+#define BTUL_CHAIN_H
+
+#include <cmath>
+#include <type_traits>
+
+
+// Arithmetic and math functions for number types that carry first order
+// derivative information along with their value, such as Dual and Uncertain.
+// Each of these is written once here in terms of the chain rule, and a type
+// opts in by specializing detail::chain::Enabled and providing
+//
+//	typedef ... value_type;
+//	D(value_type constant);
+//	value_type Value() const;
+//	D Chain(value_type result, value_type derivative) const;
+//	static D Chain(value_type result,
+//		       value_type dx, const D& x,
+//		       value_type dy, const D& y);
+//
+// where the Chain functions give the result of a function with the given
+// value and partial derivatives.  The math functions are found by argument-
+// dependent lookup from the Quantity overloads in btul_math.h and from the
+// p##N() and n##N() powers.
+
+namespace detail {
+	namespace chain {
+		template <class D>
+		struct Enabled : std::false_type {};
+
+		template <class D, class R = D>
+		using If = typename std::enable_if<Enabled<D>::value, R>::type;
+
+		template <class D, class U, class R = D>
+		using IfMixed = typename std::enable_if<
+			Enabled<D>::value && std::is_arithmetic<U>::value, R
+		>::type;
+	}
+}
+
+template <class D>
+inline detail::chain::If<D> operator +(const D& x, const D& y) {
+	return D::Chain(x.Value() + y.Value(), 1, x, 1, y);
+}
+
+template <class D>
+inline detail::chain::If<D> operator -(const D& x, const D& y) {
+	return D::Chain(x.Value() - y.Value(), 1, x, -1, y);
+}
+
+template <class D>
+inline detail::chain::If<D> operator *(const D& x, const D& y) {
+	return D::Chain(x.Value() * y.Value(), y.Value(), x, x.Value(), y);
+}
+
+template <class D>
+inline detail::chain::If<D> operator /(const D& x, const D& y) {
+	auto quotient = x.Value() / y.Value();
+	return D::Chain(quotient, 1 / y.Value(), x, -quotient / y.Value(), y);
+}
+
+// Plain numbers are constants, so they only shift or scale the derivatives.
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator +(const D& x, const U& y) {
+	return x.Chain(x.Value() + y, 1);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator +(const U& x, const D& y) {
+	return y.Chain(x + y.Value(), 1);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator -(const D& x, const U& y) {
+	return x.Chain(x.Value() - y, 1);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator -(const U& x, const D& y) {
+	return y.Chain(x - y.Value(), -1);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator *(const D& x, const U& y) {
+	typename D::value_type factor(y);
+	return x.Chain(x.Value() * factor, factor);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator *(const U& x, const D& y) {
+	typename D::value_type factor(x);
+	return y.Chain(factor * y.Value(), factor);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator /(const D& x, const U& y) {
+	typename D::value_type divisor(y);
+	return x.Chain(x.Value() / divisor, 1 / divisor);
+}
+
+template <class D, class U>
+inline detail::chain::IfMixed<D, U> operator /(const U& x, const D& y) {
+	auto quotient = typename D::value_type(x) / y.Value();
+	return y.Chain(quotient, -quotient / y.Value());
+}
+
+#define DECLARE_CHAIN_ASSIGNMENT_OPERATOR(OP)					\
+template <class D>								\
+inline detail::chain::If<D, D&> operator OP##=(D& x, const D& y) {		\
+	return x = x OP y;							\
+}										\
+										\
+template <class D, class U>							\
+inline detail::chain::IfMixed<D, U, D&> operator OP##=(D& x, const U& y) {	\
+	return x = x OP y;							\
+}
+
+DECLARE_CHAIN_ASSIGNMENT_OPERATOR(+)
+DECLARE_CHAIN_ASSIGNMENT_OPERATOR(-)
+DECLARE_CHAIN_ASSIGNMENT_OPERATOR(*)
+DECLARE_CHAIN_ASSIGNMENT_OPERATOR(/)
+
+#undef DECLARE_CHAIN_ASSIGNMENT_OPERATOR
+
+template <class D>
+inline detail::chain::If<D> operator +(const D& x) {
+	return x;
+}
+
+template <class D>
+inline detail::chain::If<D> operator -(const D& x) {
+	return x.Chain(-x.Value(), -1);
+}
+
+template <class D>
+inline detail::chain::If<D, D&> operator ++(D& x) {
+	return x += 1;
+}
+
+template <class D>
+inline detail::chain::If<D, D&> operator --(D& x) {
+	return x -= 1;
+}
+
+template <class D>
+inline detail::chain::If<D> operator ++(D& x, int) {
+	D result = x;
+	x += 1;
+	return result;
+}
+
+template <class D>
+inline detail::chain::If<D> operator --(D& x, int) {
+	D result = x;
+	x -= 1;
+	return result;
+}
+
+// Comparisons compare only the values.
+
+#define DECLARE_CHAIN_COMPARISON_OPERATOR(OP)					\
+template <class D>								\
+constexpr detail::chain::If<D, bool> operator OP(const D& x, const D& y) {	\
+	return x.Value() OP y.Value();						\
+}
+
+DECLARE_CHAIN_COMPARISON_OPERATOR(==)
+DECLARE_CHAIN_COMPARISON_OPERATOR(!=)
+DECLARE_CHAIN_COMPARISON_OPERATOR(>)
+DECLARE_CHAIN_COMPARISON_OPERATOR(>=)
+DECLARE_CHAIN_COMPARISON_OPERATOR(<)
+DECLARE_CHAIN_COMPARISON_OPERATOR(<=)
+
+#undef DECLARE_CHAIN_COMPARISON_OPERATOR
+
+
+template <class D>
+detail::chain::If<D> pow(const D& x, int n) {
+	if (n == 0) {
+		return D(1);
+	}
+	auto power = std::pow(x.Value(), n - 1);
+	return x.Chain(power * x.Value(), n * power);
+}
+
+template <class D>
+detail::chain::If<D> sqrt(const D& x) {
+	auto root = std::sqrt(x.Value());
+	return x.Chain(root, 1 / (2 * root));
+}
+
+template <class D>
+detail::chain::If<D> cbrt(const D& x) {
+	auto root = std::cbrt(x.Value());
+	return x.Chain(root, 1 / (3 * root * root));
+}
+
+/// Odd roots of negative numbers are real, as with cbrt.
+template <int N, class D>
+detail::chain::If<D> root(const D& x) {
+	typedef typename D::value_type T;
+	T root = N == 2 ? std::sqrt(x.Value()) :
+		 N == 3 ? std::cbrt(x.Value()) :
+		 N % 2 == 1 && x.Value() < 0 ? -std::pow(-x.Value(), T(1) / N) :
+		 std::pow(x.Value(), T(1) / N);
+	return x.Chain(root, root / (N * x.Value()));
+}
+
+template <class D>
+detail::chain::If<D> abs(const D& x) {
+	return x.Chain(std::fabs(x.Value()), x.Value() < 0 ? -1 : 1);
+}
+
+// Step functions have a derivative of zero.
+
+#define DECLARE_STEP_CHAIN_FUNCTION(NAME)				\
+template <class D>							\
+detail::chain::If<D> NAME(const D& x) {					\
+	return D(std::NAME(x.Value()));					\
+}
+
+DECLARE_STEP_CHAIN_FUNCTION(floor)
+DECLARE_STEP_CHAIN_FUNCTION(ceil)
+DECLARE_STEP_CHAIN_FUNCTION(round)
+
+#undef DECLARE_STEP_CHAIN_FUNCTION
+
+template <class D>
+detail::chain::If<D> hypot(const D& x, const D& y) {
+	auto h = std::hypot(x.Value(), y.Value());
+	return D::Chain(h, x.Value() / h, x, y.Value() / h, y);
+}
+
+template <class D>
+detail::chain::If<D> fmod(const D& x, const D& y) {
+	return D::Chain(std::fmod(x.Value(), y.Value()),
+			1, x,
+			-std::trunc(x.Value() / y.Value()), y);
+}
+
+template <class D>
+detail::chain::If<D> fma(const D& x, const D& y, const D& z) {
+	return (x * y + z).Chain(std::fma(x.Value(), y.Value(), z.Value()), 1);
+}
+
+// NaNs are ignored, as with std::fmin and std::fmax.
+
+template <class D>
+detail::chain::If<D> fmin(const D& x, const D& y) {
+	return y.Value() < x.Value() || x.Value() != x.Value() ? y : x;
+}
+
+template <class D>
+detail::chain::If<D> fmax(const D& x, const D& y) {
+	return y.Value() > x.Value() || x.Value() != x.Value() ? y : x;
+}
+
+#endif // BTUL_CHAIN_H
@@ -0,0 +1,349 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_CHRONO_H
+#define BTUL_CHRONO_H
+
+#include <btul.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <ratio>
+#include <type_traits>
+
+
+// Conversions between Time and std::chrono::duration, and Ticks, a Number
+// type holding a whole number of ticks of a fixed period, for timestamps that
+// must add and subtract exactly:
+//
+//	Time t = FromDuration(std::chrono::milliseconds(1500));	// 1.5 s
+//	auto d = ToDuration<std::chrono::microseconds>(t);	// 1500000 us
+//
+//	TickTime<> start = FromDuration<TickTime<>>(steady_clock::now().time_since_epoch());
+//	TickTime<> elapsed = stop - start;			// exact
+//	Speed v = 3_m / elapsed;				// floating point
+//
+// Every conversion is a single multiplication or division by a constant, or
+// none at all between a duration and Ticks of the same period.  Conversions
+// that cannot be exact round to the nearest tick, halves away from zero.
+
+template <class Period>
+class Ticks;
+
+namespace detail {
+	namespace chrono {
+		struct CountTag {};
+
+		/// \a x rounded to the nearest integer for integral T.
+		template <class T>
+		constexpr T roundTo(long double x) {
+			return std::is_floating_point<T>::value ? T(x) :
+			       T(x < 0 ? x - 0.5L : x + 0.5L);
+		}
+
+		/// a / b for b > 0, rounded to the nearest integer.
+		constexpr std::int64_t roundDivide(std::int64_t a, std::int64_t b) {
+			return (a < 0 ? a - b / 2 : a + b / 2) / b;
+		}
+
+		/// A count of ticks of period From, in ticks of period To.
+		template <class From, class To>
+		constexpr std::int64_t convertCount(std::int64_t count) {
+			return std::ratio_divide<From, To>::den == 1 ?
+				       count * std::ratio_divide<From, To>::num :
+			       roundDivide(count * std::ratio_divide<From, To>::num,
+					   std::ratio_divide<From, To>::den);
+		}
+
+		template <class Period, class Rep>
+		constexpr long double toSeconds(Rep count) {
+			return static_cast<long double>(count) * Period::num / Period::den;
+		}
+
+		template <class Period>
+		constexpr long double fromSeconds(long double seconds) {
+			return seconds * Period::den / Period::num;
+		}
+
+		/// Conversions between durations and a Number of seconds.
+		template <class Number>
+		struct Convert {
+			template <class Rep, class Period>
+			static constexpr Number From(const std::chrono::duration<Rep, Period>& d) {
+				return Number(toSeconds<Period>(d.count()));
+			}
+
+			template <class Duration>
+			static constexpr Duration To(const Number& seconds) {
+				return Duration(roundTo<typename Duration::rep>(
+					fromSeconds<typename Duration::period>(
+						static_cast<long double>(seconds))));
+			}
+		};
+
+		template <class P>
+		struct Convert<Ticks<P>> {
+			template <class Rep, class Period>
+			static constexpr Ticks<P> From(const std::chrono::duration<Rep, Period>& d) {
+				return std::is_floating_point<Rep>::value ?
+					       Ticks<P>(toSeconds<Period>(d.count())) :
+				       Ticks<P>::FromCount(
+					       convertCount<Period, P>(static_cast<std::int64_t>(d.count())));
+			}
+
+			template <class Duration>
+			static constexpr Duration To(const Ticks<P>& ticks) {
+				return std::is_floating_point<typename Duration::rep>::value ?
+					       Duration(static_cast<typename Duration::rep>(
+						       fromSeconds<typename Duration::period>(
+							       static_cast<long double>(ticks)))) :
+				       Duration(static_cast<typename Duration::rep>(
+					       convertCount<P, typename Duration::period>(ticks.Count())));
+			}
+		};
+
+		template <class U, class T = long double>
+		using IfFloating = typename std::enable_if<std::is_floating_point<U>::value, T>::type;
+
+		template <class U, class T>
+		using IfIntegral = typename std::enable_if<std::is_integral<U>::value, T>::type;
+
+		template <class U, class T = long double>
+		using IfArithmetic = typename std::enable_if<std::is_arithmetic<U>::value, T>::type;
+	}
+}
+
+
+/// A time in whole ticks of Period, as a signed 64 bit count; nanoseconds by
+/// default, which covers almost 300 years either way.  Ticks is a Number type
+/// for Quantity, and TickTime below is the Time that uses it.
+///
+/// Sums and differences of Ticks, and their products and quotients with
+/// integers, are Ticks, and exact, other than division, which rounds toward
+/// zero as with std::chrono.  Everything else, such as mixing in floating
+/// point numbers or multiplying Ticks together, gives seconds as a long
+/// double, so TickTime works with the rest of btul, and a TickTime plus a
+/// Time is a Time.  Ticks convert to and from seconds explicitly, so a
+/// TickTime and a Time convert to each other like any two Times.
+template <class Period = std::nano>
+class Ticks {
+	static_assert(Period::num > 0, "Ticks period must be positive");
+
+public:
+	typedef Period period;
+
+	constexpr Ticks()
+		: count(0)
+	{}
+
+	/// \a seconds, rounded to the nearest tick.
+	explicit constexpr Ticks(long double seconds)
+		: count(detail::chrono::roundTo<std::int64_t>(
+			detail::chrono::fromSeconds<Period>(seconds)))
+	{}
+
+	static constexpr Ticks FromCount(std::int64_t count) {
+		return Ticks(count, detail::chrono::CountTag());
+	}
+
+	constexpr std::int64_t Count() const {
+		return count;
+	}
+
+	/// In seconds.
+	explicit constexpr operator long double() const {
+		return detail::chrono::toSeconds<Period>(count);
+	}
+
+	Ticks& operator +=(const Ticks& other) {
+		count += other.count;
+		return *this;
+	}
+
+	Ticks& operator -=(const Ticks& other) {
+		count -= other.count;
+		return *this;
+	}
+
+	template <class I>
+	detail::chrono::IfIntegral<I, Ticks&> operator *=(I factor) {
+		count *= factor;
+		return *this;
+	}
+
+	template <class I>
+	detail::chrono::IfIntegral<I, Ticks&> operator /=(I divisor) {
+		count /= divisor;
+		return *this;
+	}
+
+private:
+	constexpr Ticks(std::int64_t count, detail::chrono::CountTag)
+		: count(count)
+	{}
+
+	std::int64_t count;
+};
+
+template <class Period = std::nano>
+using TickTime = Quantity<0, 0, 1, 0, 0, 0, 0, Ticks<Period>>;
+
+
+template <class P>
+constexpr Ticks<P> operator +(const Ticks<P>& x, const Ticks<P>& y) {
+	return Ticks<P>::FromCount(x.Count() + y.Count());
+}
+
+template <class P>
+constexpr Ticks<P> operator -(const Ticks<P>& x, const Ticks<P>& y) {
+	return Ticks<P>::FromCount(x.Count() - y.Count());
+}
+
+template <class P>
+constexpr Ticks<P> operator +(const Ticks<P>& x) {
+	return x;
+}
+
+template <class P>
+constexpr Ticks<P> operator -(const Ticks<P>& x) {
+	return Ticks<P>::FromCount(-x.Count());
+}
+
+template <class P, class I>
+constexpr detail::chrono::IfIntegral<I, Ticks<P>> operator *(const Ticks<P>& x, I y) {
+	return Ticks<P>::FromCount(x.Count() * y);
+}
+
+template <class P, class I>
+constexpr detail::chrono::IfIntegral<I, Ticks<P>> operator *(I x, const Ticks<P>& y) {
+	return Ticks<P>::FromCount(x * y.Count());
+}
+
+template <class P, class I>
+constexpr detail::chrono::IfIntegral<I, Ticks<P>> operator /(const Ticks<P>& x, I y) {
+	return Ticks<P>::FromCount(x.Count() / y);
+}
+
+/// The ratio of two times, computed from their counts.
+template <class P>
+constexpr long double operator /(const Ticks<P>& x, const Ticks<P>& y) {
+	return static_cast<long double>(x.Count()) / y.Count();
+}
+
+template <class P>
+constexpr long double operator *(const Ticks<P>& x, const Ticks<P>& y) {
+	return static_cast<long double>(x) * static_cast<long double>(y);
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator *(const Ticks<P>& x, F y) {
+	return static_cast<long double>(x) * y;
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator *(F x, const Ticks<P>& y) {
+	return x * static_cast<long double>(y);
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator /(const Ticks<P>& x, F y) {
+	return static_cast<long double>(x) / y;
+}
+
+template <class P, class U>
+constexpr detail::chrono::IfArithmetic<U> operator /(U x, const Ticks<P>& y) {
+	return x / static_cast<long double>(y);
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator +(const Ticks<P>& x, F y) {
+	return static_cast<long double>(x) + y;
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator +(F x, const Ticks<P>& y) {
+	return x + static_cast<long double>(y);
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator -(const Ticks<P>& x, F y) {
+	return static_cast<long double>(x) - y;
+}
+
+template <class P, class F>
+constexpr detail::chrono::IfFloating<F> operator -(F x, const Ticks<P>& y) {
+	return x - static_cast<long double>(y);
+}
+
+#define DECLARE_TICKS_COMPARISON_OPERATOR(OP)					\
+template <class P>								\
+constexpr bool operator OP(const Ticks<P>& x, const Ticks<P>& y) {		\
+	return x.Count() OP y.Count();						\
+}										\
+										\
+template <class P, class F>							\
+constexpr detail::chrono::IfFloating<F, bool>					\
+operator OP(const Ticks<P>& x, F y) {						\
+	return static_cast<long double>(x) OP y;				\
+}										\
+										\
+template <class P, class F>							\
+constexpr detail::chrono::IfFloating<F, bool>					\
+operator OP(F x, const Ticks<P>& y) {						\
+	return x OP static_cast<long double>(y);				\
+}
+
+DECLARE_TICKS_COMPARISON_OPERATOR(==)
+DECLARE_TICKS_COMPARISON_OPERATOR(!=)
+DECLARE_TICKS_COMPARISON_OPERATOR(<)
+DECLARE_TICKS_COMPARISON_OPERATOR(<=)
+DECLARE_TICKS_COMPARISON_OPERATOR(>)
+DECLARE_TICKS_COMPARISON_OPERATOR(>=)
+
+#undef DECLARE_TICKS_COMPARISON_OPERATOR
+
+/// Prints the time in seconds.
+template <class P>
+std::ostream& operator <<(std::ostream& stream, const Ticks<P>& x) {
+	return stream << static_cast<long double>(x);
+}
+
+
+/// \a duration as a time Q; a Time unless given otherwise.
+template <class Q = Time, class Rep, class Period>
+constexpr Q FromDuration(const std::chrono::duration<Rep, Period>& duration) {
+	static_assert(Q::time == 1 && Q::length == 0 && Q::mass == 0 && Q::current == 0 &&
+		      Q::temperature == 0 && Q::amount == 0 && Q::luminosity == 0 &&
+		      Q::root == 1,
+		      "FromDuration needs a Quantity of time");
+	return Q(detail::chrono::Convert<typename Q::type>::From(duration));
+}
+
+/// \a time as a std::chrono::duration.  Integer durations are rounded to the
+/// nearest tick.
+template <class Duration, class T, class F>
+constexpr Duration ToDuration(const Quantity<0, 0, 1, 0, 0, 0, 0, T, F>& time) {
+	return detail::chrono::Convert<T>::template To<Duration>(time.Value());
+}
+
+#endif // BTUL_CHRONO_H
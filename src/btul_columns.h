@@ -0,0 +1,288 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_COLUMNS_H
+#define BTUL_COLUMNS_H
+
+#include <btul.h>
+#include <btul_binary.h>
+#include <btul_mapped.h>
+#include <btul_span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// A columnar file of quantities, for recordings too large to read into
+// memory.  Each column is an array in the format of btul_binary.h, with its
+// values starting on a cache line boundary, and a footer at the end of the file indexes the
+// columns by name:
+//
+//	ColumnWriter writer("run.cols");
+//	writer.Add("position", QuantitySpan<const Length>(positions));
+//	writer.Add("speed", QuantitySpan<const Speed>(speeds));
+//	writer.Close();
+//
+//	ColumnFile file("run.cols");
+//	QuantitySpan<const Length> position = file.Column<Length>("position");
+//
+// ColumnFile maps the file rather than reading it, so a column costs nothing
+// until it is touched, and then only the pages touched are read.  The
+// columns are views of the mapping, valid for the lifetime of the ColumnFile.
+// Files are written in native byte order, and must be read on a machine of
+// the same byte order.
+//
+// Errors in the file are reported with SerializationError and
+// DimensionMismatch, and errors from the operating system with
+// std::system_error.  POSIX only.
+
+namespace detail {
+	namespace columns {
+		constexpr char MAGIC[8] = {'B', 'T', 'U', 'L', 'C', 'O', 'L', 'S'};
+
+		/// Ends the file, after the index entries.
+		struct Trailer {
+			std::uint64_t indexOffset;
+			std::uint64_t columns;
+			char magic[8];
+		};
+
+		/// Precedes each name in the index.
+		struct Entry {
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint64_t nameLength;
+		};
+	}
+}
+
+/// Writes a columnar file.  The columns are written as they are added; the
+/// index is written by Close, or by the destructor.
+class ColumnWriter {
+public:
+	explicit ColumnWriter(const std::string& path)
+		: stream(path, std::ios::binary | std::ios::trunc), offset(0), closed(false)
+	{
+		if (!stream) {
+			throw detail::mapped::systemError("Cannot create " + path);
+		}
+	}
+
+	ColumnWriter(const ColumnWriter&) = delete;
+	ColumnWriter& operator =(const ColumnWriter&) = delete;
+
+	~ColumnWriter() {
+		if (!closed) {
+			try {
+				Close();
+			}
+			catch (...) {}
+		}
+	}
+
+	/// Appends a column.  \a name must not already be in use.
+	template <class Q>
+	void Add(const std::string& name, QuantitySpan<const Q> values) {
+		for (const Entry& entry : entries) {
+			if (entry.name == name) {
+				throw SerializationError("Duplicate column " + name);
+			}
+		}
+		Pad(sizeof(QuantityHeader));
+		std::uint64_t start = offset;
+		WriteQuantities(stream, values);
+		offset += sizeof(QuantityHeader) + values.size() * sizeof(Q);
+		entries.push_back(Entry{name, start, offset - start});
+		Check();
+	}
+
+	/// Writes the index and closes the file.
+	void Close() {
+		closed = true;
+		Pad(0);
+		detail::columns::Trailer trailer = {offset, entries.size(), {}};
+		std::memcpy(trailer.magic, detail::columns::MAGIC, sizeof(trailer.magic));
+		for (const Entry& entry : entries) {
+			detail::columns::Entry header = {entry.offset, entry.size, entry.name.size()};
+			Write(&header, sizeof(header));
+			Write(entry.name.data(), entry.name.size());
+		}
+		Write(&trailer, sizeof(trailer));
+		stream.close();
+		Check();
+	}
+
+private:
+	struct Entry {
+		std::string name;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	void Write(const void* data, std::size_t size) {
+		stream.write(static_cast<const char*>(data), std::streamsize(size));
+		offset += size;
+	}
+
+	// Pads the file so that \a size bytes from now is a cache line
+	// boundary.
+	void Pad(std::size_t size) {
+		static const char zeros[detail::CACHE_LINE_SIZE] = {};
+		Write(zeros, -(offset + size) % detail::CACHE_LINE_SIZE);
+	}
+
+	void Check() {
+		if (!stream) {
+			throw detail::mapped::systemError("Cannot write column file");
+		}
+	}
+
+	std::ofstream stream;
+	std::uint64_t offset;
+	std::vector<Entry> entries;
+	bool closed;
+};
+
+/// A columnar file, mapped read-only into memory.
+class ColumnFile {
+public:
+	/// Maps the file at \a path.  \a pattern is the default for every
+	/// column, and can be changed per column with Advise.  See MappedFile
+	/// for \a hugePages.
+	explicit ColumnFile(const std::string& path,
+			    AccessPattern pattern = AccessPattern::Normal,
+			    bool hugePages = false)
+		: file(path, pattern, hugePages)
+	{
+		ReadIndex(path);
+	}
+
+	std::size_t Columns() const {
+		return entries.size();
+	}
+
+	const std::string& Name(std::size_t column) const {
+		return entries[column].name;
+	}
+
+	bool Contains(const std::string& name) const {
+		return Find(name) != nullptr;
+	}
+
+	/// A view of the column \a name, which must hold quantities of type Q.
+	template <class Q>
+	QuantitySpan<const Q> Column(const std::string& name) const {
+		const Entry& entry = Get(name);
+		return ViewQuantities<Q>(file.Data() + entry.offset, entry.size);
+	}
+
+	/// The header of the column \a name, for inspecting a file of
+	/// unknown layout.
+	QuantityHeader Header(const std::string& name) const {
+		const Entry& entry = Get(name);
+		QuantityHeader header;
+		if (entry.size < sizeof(header)) {
+			throw SerializationError("Truncated quantity array header");
+		}
+		std::memcpy(&header, file.Data() + entry.offset, sizeof(header));
+		return header;
+	}
+
+	/// Changes the readahead for the column \a name.
+	void Advise(const std::string& name, AccessPattern pattern) const {
+		const Entry& entry = Get(name);
+		file.Advise(entry.offset, entry.size, pattern);
+	}
+
+	/// Starts reading the column \a name in the background.
+	void Prefetch(const std::string& name) const {
+		const Entry& entry = Get(name);
+		file.Prefetch(entry.offset, entry.size);
+	}
+
+private:
+	struct Entry {
+		std::string name;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	void ReadIndex(const std::string& path) {
+		const char* data = file.Data();
+		std::size_t size = file.Size();
+		detail::columns::Trailer trailer;
+		if (size < sizeof(trailer)) {
+			throw SerializationError(path + " is not a column file");
+		}
+		std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+		if (std::memcmp(trailer.magic, detail::columns::MAGIC, sizeof(trailer.magic)) != 0 ||
+		    trailer.indexOffset > size - sizeof(trailer)) {
+			throw SerializationError(path + " is not a column file");
+		}
+
+		std::uint64_t position = trailer.indexOffset;
+		std::uint64_t end = size - sizeof(trailer);
+		for (std::uint64_t i = 0; i < trailer.columns; ++i) {
+			detail::columns::Entry entry;
+			if (end - position < sizeof(entry)) {
+				throw SerializationError("Truncated index in " + path);
+			}
+			std::memcpy(&entry, data + position, sizeof(entry));
+			position += sizeof(entry);
+			if (end - position < entry.nameLength ||
+			    entry.offset > trailer.indexOffset ||
+			    entry.size > trailer.indexOffset - entry.offset) {
+				throw SerializationError("Corrupt index in " + path);
+			}
+			entries.push_back(Entry{std::string(data + position, entry.nameLength),
+						entry.offset, entry.size});
+			position += entry.nameLength;
+		}
+	}
+
+	const Entry* Find(const std::string& name) const {
+		for (const Entry& entry : entries) {
+			if (entry.name == name) {
+				return &entry;
+			}
+		}
+		return nullptr;
+	}
+
+	const Entry& Get(const std::string& name) const {
+		const Entry* entry = Find(name);
+		if (!entry) {
+			throw SerializationError("No column " + name);
+		}
+		return *entry;
+	}
+
+	MappedFile file;
+	std::vector<Entry> entries;
+};
+
+#endif // BTUL_COLUMNS_H
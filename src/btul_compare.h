@@ -0,0 +1,248 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_COMPARE_H
+#define BTUL_COMPARE_H
+
+#include <btul.h>
+#include <btul_math.h>
+#include <btul_span.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+
+// Scale-aware comparisons of quantities.  Quantity::Within takes an absolute
+// epsilon, which is meaningless unless the magnitude of the values is known;
+// these compare either by the number of representable values between the
+// two (ULPs), or by a tolerance that is relative to their magnitude with an
+// absolute floor for values near zero.
+//
+//	WithinUlps(computed, expected, 4)
+//	WithinTolerance(computed, expected, 1e-9_m, 1e-12)
+//
+// The bulk versions compare whole spans without branching, so that spans of
+// double-valued quantities vectorize.
+
+namespace detail {
+	namespace compare {
+		// Maps a floating point value to an integer such that adjacent
+		// values map to adjacent integers, and both zeros map to zero.
+
+		inline std::int32_t ordered(float x) {
+			std::int32_t i;
+			std::memcpy(&i, &x, sizeof(i));
+			return i < 0 ? std::numeric_limits<std::int32_t>::min() - i : i;
+		}
+
+		inline std::int64_t ordered(double x) {
+			std::int64_t i;
+			std::memcpy(&i, &x, sizeof(i));
+			return i < 0 ? std::numeric_limits<std::int64_t>::min() - i : i;
+		}
+
+		template <class Integer>
+		inline std::uint64_t distance(Integer x, Integer y) {
+			return x < y ? std::uint64_t(y) - std::uint64_t(x) :
+				       std::uint64_t(x) - std::uint64_t(y);
+		}
+
+		inline std::uint64_t ulpDistance(float x, float y) {
+			return distance(ordered(x), ordered(y));
+		}
+
+		inline std::uint64_t ulpDistance(double x, double y) {
+			return distance(ordered(x), ordered(y));
+		}
+
+#if defined(__SIZEOF_INT128__) && LDBL_MANT_DIG == 64
+		// The x87 extended format has an explicit integer bit, which is
+		// dropped so that subnormals and normals are contiguous.
+		inline __int128 ordered(long double x) {
+			std::uint64_t mantissa;
+			std::uint16_t signAndExponent;
+			std::memcpy(&mantissa, &x, sizeof(mantissa));
+			std::memcpy(&signAndExponent,
+				    reinterpret_cast<const char*>(&x) + sizeof(mantissa),
+				    sizeof(signAndExponent));
+			__int128 magnitude =
+				(__int128(signAndExponent & 0x7FFF) << 63) |
+				(mantissa & 0x7FFFFFFFFFFFFFFFull);
+			return signAndExponent & 0x8000 ? -magnitude : magnitude;
+		}
+#elif defined(__SIZEOF_INT128__) && LDBL_MANT_DIG == 113
+		// IEEE binary128 is laid out like double, only wider.
+		inline __int128 ordered(long double x) {
+			typedef unsigned __int128 Bits;
+			Bits bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			__int128 magnitude = __int128(bits & ~(Bits(1) << 127));
+			return bits >> 127 ? -magnitude : magnitude;
+		}
+#endif
+
+#if defined(__SIZEOF_INT128__) && (LDBL_MANT_DIG == 64 || LDBL_MANT_DIG == 113)
+		inline std::uint64_t ulpDistance(long double x, long double y) {
+			__int128 d = ordered(x) - ordered(y);
+			d = d < 0 ? -d : d;
+			return d > __int128(std::numeric_limits<std::uint64_t>::max()) ?
+			       std::numeric_limits<std::uint64_t>::max() :
+			       std::uint64_t(d);
+		}
+#else
+		// Where long double is double this is exact; for any other
+		// format it is measured in the ULPs of double.
+		inline std::uint64_t ulpDistance(long double x, long double y) {
+			return ulpDistance(double(x), double(y));
+		}
+#endif
+	}
+}
+
+
+/// The number of representable values of the Number type between \a x and
+/// \a y, so that 0 means equal, and 1 means adjacent.  The distance between
+/// a NaN and anything is the largest possible.
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F1, class F2>
+std::uint64_t UlpDistance(const Quantity<BASE_QUANTITIES, T, F1, Root>& x,
+			  const Quantity<BASE_QUANTITIES, T, F2, Root>& y)
+{
+	return std::isnan(x.Value()) || std::isnan(y.Value()) ?
+	       std::numeric_limits<std::uint64_t>::max() :
+	       detail::compare::ulpDistance(x.Value(), y.Value());
+}
+
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F1, class F2>
+bool WithinUlps(const Quantity<BASE_QUANTITIES, T, F1, Root>& x,
+		const Quantity<BASE_QUANTITIES, T, F2, Root>& y,
+		std::uint64_t ulps)
+{
+	return UlpDistance(x, y) <= ulps;
+}
+
+/// True if |x - y| <= max(absolute, relative * max(|x|, |y|)).  The absolute
+/// tolerance is needed for values near zero, where any relative tolerance
+/// vanishes.
+template <BASE_QUANTITIES_DECLARATION, int Root,
+	  class T1, class F1, class T2, class F2, class T3, class F3>
+bool WithinTolerance(const Quantity<BASE_QUANTITIES, T1, F1, Root>& x,
+		     const Quantity<BASE_QUANTITIES, T2, F2, Root>& y,
+		     const Quantity<BASE_QUANTITIES, T3, F3, Root>& absolute,
+		     double relative)
+{
+	auto difference = std::fabs(x.Value() - y.Value());
+	return (difference <= absolute.Value()) |
+	       (difference <= relative * std::fabs(x.Value())) |
+	       (difference <= relative * std::fabs(y.Value()));
+}
+
+
+// Bulk versions.  The Mask functions write 1 into \a mask where the
+// comparison holds and 0 elsewhere; the Count functions return the number
+// of elements where it holds.  Both operate on the first x.size() elements.
+
+namespace detail {
+	namespace compare {
+		template <class T>
+		inline bool withinUlps(T x, T y, std::uint64_t ulps) {
+			// |d| <= ulps, in modular arithmetic.
+			std::uint64_t d = std::uint64_t(ordered(x)) - std::uint64_t(ordered(y));
+			return (x == x) & (y == y) & (d + ulps <= 2 * ulps);
+		}
+
+		inline bool withinUlps(long double x, long double y, std::uint64_t ulps) {
+			return (x == x) & (y == y) & (ulpDistance(x, y) <= ulps);
+		}
+
+		template <class T>
+		inline bool withinTolerance(T x, T y, T absolute, T relative) {
+			// Comparing against each magnitude rather than their
+			// fmax, which is a library call unless NaNs are ruled out.
+			T difference = std::fabs(x - y);
+			return (difference <= absolute) |
+			       (difference <= relative * std::fabs(x)) |
+			       (difference <= relative * std::fabs(y));
+		}
+	}
+}
+
+/// \a ulps must be less than 2^63.
+template <class Q1, class Q2>
+void MaskWithinUlps(QuantitySpan<Q1> x, QuantitySpan<Q2> y, std::uint64_t ulps,
+		    QuantitySpan<std::uint8_t> mask)
+{
+	static_assert(detail::sameDimensions<Q1, Q2>(),
+		      "Compared spans must have the same dimensions");
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		mask[i] = detail::compare::withinUlps(x[i].Value(), y[i].Value(), ulps);
+	}
+}
+
+template <class Q1, class Q2>
+std::size_t CountWithinUlps(QuantitySpan<Q1> x, QuantitySpan<Q2> y, std::uint64_t ulps) {
+	static_assert(detail::sameDimensions<Q1, Q2>(),
+		      "Compared spans must have the same dimensions");
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		count += detail::compare::withinUlps(x[i].Value(), y[i].Value(), ulps);
+	}
+	return count;
+}
+
+template <class Q1, class Q2, class Q3>
+void MaskWithinTolerance(QuantitySpan<Q1> x, QuantitySpan<Q2> y,
+			 const Q3& absolute, double relative,
+			 QuantitySpan<std::uint8_t> mask)
+{
+	static_assert(detail::sameDimensions<Q1, Q2>() && detail::sameDimensions<Q1, Q3>(),
+		      "Compared spans and tolerance must have the same dimensions");
+	typedef typename Q1::type T;
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		mask[i] = detail::compare::withinTolerance<T>(x[i].Value(),
+							      y[i].Value(),
+							      absolute.Value(),
+							      relative);
+	}
+}
+
+template <class Q1, class Q2, class Q3>
+std::size_t CountWithinTolerance(QuantitySpan<Q1> x, QuantitySpan<Q2> y,
+				 const Q3& absolute, double relative)
+{
+	static_assert(detail::sameDimensions<Q1, Q2>() && detail::sameDimensions<Q1, Q3>(),
+		      "Compared spans and tolerance must have the same dimensions");
+	typedef typename Q1::type T;
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		count += detail::compare::withinTolerance<T>(x[i].Value(),
+							     y[i].Value(),
+							     absolute.Value(),
+							     relative);
+	}
+	return count;
+}
+
+#endif // BTUL_COMPARE_H
@@ -0,0 +1,751 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_COMPRESS_H
+#define BTUL_COMPRESS_H
+
+#include <btul.h>
+#include <btul_binary.h>
+#include <btul_span.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+// Lossless compression of slowly varying series of quantities, after
+// Facebook's Gorilla: each value is stored as the XOR of its bits with the
+// previous value's, which for a slowly varying series has long runs of zeros
+// at both ends, and each time stamp as the change in the interval between
+// samples, which for a regularly sampled series is almost always zero:
+//
+//	SeriesEncoder<Pressure> encoder;
+//	for (...) {
+//		encoder.Append(time, pressure);
+//	}
+//	SeriesDecoder<Pressure> decoder(encoder.Data().data(), encoder.Data().size());
+//	decoder.Decode(first, times, pressures);
+//
+// The series is cut into blocks of a fixed number of samples, each of which
+// starts from scratch behind a header giving the dimensions and Number type
+// of the quantity, so decoding can start at any block, and blocks can be
+// appended to a file as they fill.  Values must be float or double.  Times
+// are optional, and are stored as whole ticks of a resolution, one
+// nanosecond by default; times between ticks are rounded to the nearest.
+
+/// The header of each block of a compressed series.  Fields are in the
+/// byte order given by endianness; the bits that follow are in a fixed
+/// order.
+struct SeriesBlockHeader {
+	static constexpr std::uint8_t HAS_TIMES = 1;
+
+	char magic[4];
+	std::uint8_t version;
+	/// QuantityHeader::LITTLE_ENDIAN_ORDER or BIG_ENDIAN_ORDER.
+	std::uint8_t endianness;
+	/// One of the codes in detail::binary::numberCode.
+	std::uint8_t number;
+	std::uint8_t flags;
+	/// As in QuantityHeader.
+	std::int8_t exponents[8];
+	/// The number of samples in the block.
+	std::uint32_t count;
+	/// The sizes of the time and value bit streams that follow, in that
+	/// order.
+	std::uint32_t timeBytes;
+	std::uint32_t valueBytes;
+	std::uint32_t reserved;
+	/// The index in the series of the block's first sample.
+	std::uint64_t first;
+	/// The time of the first sample, in ticks.
+	std::int64_t firstTick;
+	/// The length of a tick in seconds.
+	double resolution;
+};
+
+static_assert(sizeof(SeriesBlockHeader) == 56, "SeriesBlockHeader must be packed");
+
+namespace detail {
+	namespace compress {
+		constexpr char MAGIC[4] = {'B', 'T', 'G', 'S'};
+		constexpr std::uint8_t VERSION = 1;
+
+		inline unsigned leadingZeros(std::uint64_t x) {
+#if defined(__GNUC__)
+			return x == 0 ? 64 : unsigned(__builtin_clzll(x));
+#else
+			unsigned n = 0;
+			for (std::uint64_t bit = std::uint64_t(1) << 63; bit != 0 && !(x & bit); bit >>= 1) {
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		inline unsigned trailingZeros(std::uint64_t x) {
+#if defined(__GNUC__)
+			return x == 0 ? 64 : unsigned(__builtin_ctzll(x));
+#else
+			unsigned n = 0;
+			for (std::uint64_t bit = 1; bit != 0 && !(x & bit); bit <<= 1) {
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		inline std::uint64_t fromBigEndian(std::uint64_t word) {
+			if (binary::nativeEndianness() == QuantityHeader::BIG_ENDIAN_ORDER) {
+				return word;
+			}
+#if defined(__GNUC__)
+			return __builtin_bswap64(word);
+#else
+			binary::reverseBytes(reinterpret_cast<char*>(&word), sizeof(word));
+			return word;
+#endif
+		}
+
+		/// Collects bits, most significant first, into bytes.
+		class BitWriter {
+		public:
+			/// Appends the low \a n bits of \a value, for n <= 64.
+			void Write(std::uint64_t value, unsigned n) {
+				if (n == 0) {
+					return;
+				}
+				value &= ~std::uint64_t(0) >> (64 - n);
+				unsigned free = 64 - used;
+				if (n < free) {
+					buffer |= value << (free - n);
+					used += n;
+					return;
+				}
+				buffer |= value >> (n - free);
+				Store(8);
+				used = n - free;
+				buffer = used == 0 ? 0 : value << (64 - used);
+			}
+
+			/// Appends the bytes written, the last padded with zeros, to
+			/// \a out.
+			void AppendTo(std::vector<char>& out) {
+				out.insert(out.end(), bytes.begin(), bytes.end());
+				for (unsigned i = 0; i < (used + 7) / 8; ++i) {
+					out.push_back(char(buffer >> (56 - 8 * i)));
+				}
+			}
+
+			/// The number of bytes the bits written take.
+			std::size_t Size() const {
+				return bytes.size() + (used + 7) / 8;
+			}
+
+			void Clear() {
+				bytes.clear();
+				buffer = 0;
+				used = 0;
+			}
+
+		private:
+			/// Appends the first \a count bytes of the buffer.
+			void Store(unsigned count) {
+				std::size_t size = bytes.size();
+				bytes.resize(size + count);
+				for (unsigned i = 0; i < count; ++i) {
+					bytes[size + i] = char(buffer >> (56 - 8 * i));
+				}
+			}
+
+			std::vector<char> bytes;
+			std::uint64_t buffer = 0;
+			unsigned used = 0;
+		};
+
+		/// Reads bits written by a BitWriter.  Reading past the end
+		/// gives zeros.
+		class BitReader {
+		public:
+			BitReader(const char* begin, const char* end)
+				: begin(reinterpret_cast<const unsigned char*>(begin)),
+				  end(reinterpret_cast<const unsigned char*>(end))
+			{}
+
+			/// Reads \a n bits, for n <= 64.
+			std::uint64_t Read(unsigned n) {
+				if (n > 56) {
+					std::uint64_t high = Read(n - 32);
+					return high << 32 | Read(32);
+				}
+				if (n == 0) {
+					return 0;
+				}
+				std::uint64_t word = Window() << (position & 7);
+				position += n;
+				return word >> (64 - n);
+			}
+
+			/// The next \a n bits, for 0 < n <= 56, without reading them.
+			std::uint64_t Peek(unsigned n) const {
+				return Window() << (position & 7) >> (64 - n);
+			}
+
+			void Skip(unsigned n) {
+				position += n;
+			}
+
+		private:
+			/// The eight bytes from the one holding the next bit.
+			std::uint64_t Window() const {
+				const unsigned char* p = begin + position / 8;
+				std::uint64_t word = 0;
+				if (end - p >= 8) {
+					std::memcpy(&word, p, sizeof(word));
+					return fromBigEndian(word);
+				}
+				else {
+					for (int i = 0; i < 8; ++i) {
+						word = word << 8 | (p + i < end ? p[i] : 0);
+					}
+				}
+				return word;
+			}
+
+			const unsigned char* begin;
+			const unsigned char* end;
+			std::size_t position = 0;
+		};
+
+		/// The unsigned integer with the bits of T.
+		template <class T>
+		struct Bits {
+			typedef typename std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t>::type type;
+			static constexpr unsigned SIZE = 8 * sizeof(T);
+			/// The width of the field giving the number of meaningful
+			/// bits.
+			static constexpr unsigned LENGTH_BITS = sizeof(T) == 4 ? 5 : 6;
+		};
+
+		template <class T>
+		typename Bits<T>::type toBits(T value) {
+			typename Bits<T>::type bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		template <class T>
+		T fromBits(typename Bits<T>::type bits) {
+			T value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		/// The state of the value stream, shared by the encoder and the
+		/// decoder: the previous value's bits, and the window of
+		/// meaningful bits of the previous XOR, from its leading zeros
+		/// to its trailing zeros.
+		struct ValueState {
+			std::uint64_t previous = 0;
+			unsigned leading = ~0u;
+			unsigned trailing = 0;
+		};
+
+		/// Appends a value.  The first value of a block is written
+		/// whole; each one after it as a 0 bit if it repeats the
+		/// previous value, otherwise as a 1 bit and its XOR with the
+		/// previous value: a 0 bit and the bits in the previous window
+		/// if the XOR fits in it, or a 1 bit, the number of leading
+		/// zeros (5 bits) and of meaningful bits, and the meaningful
+		/// bits.
+		template <class T>
+		void writeValue(BitWriter& writer, ValueState& state, std::uint64_t bits, bool first) {
+			const unsigned size = Bits<T>::SIZE;
+			if (first) {
+				writer.Write(bits, size);
+				state.previous = bits;
+				state.leading = ~0u;
+				return;
+			}
+			std::uint64_t difference = bits ^ state.previous;
+			state.previous = bits;
+			if (difference == 0) {
+				writer.Write(0, 1);
+				return;
+			}
+
+			unsigned leading = leadingZeros(difference) - (64 - size);
+			unsigned trailing = trailingZeros(difference);
+			if (leading >= state.leading && trailing >= state.trailing) {
+				writer.Write(2, 2);
+				writer.Write(difference >> state.trailing, size - state.leading - state.trailing);
+				return;
+			}
+			leading = std::min(leading, 31u);
+			unsigned meaningful = size - leading - trailing;
+			writer.Write(3, 2);
+			writer.Write(leading, 5);
+			writer.Write(meaningful - 1, Bits<T>::LENGTH_BITS);
+			writer.Write(difference >> trailing, meaningful);
+			state.leading = leading;
+			state.trailing = trailing;
+		}
+
+		template <class T>
+		std::uint64_t readValue(BitReader& reader, ValueState& state, bool first) {
+			const unsigned size = Bits<T>::SIZE;
+			if (first) {
+				state.previous = reader.Read(size);
+				state.leading = ~0u;
+				return state.previous;
+			}
+			unsigned control = unsigned(reader.Peek(2));
+			if (control < 2) {
+				reader.Skip(1);
+				return state.previous;
+			}
+			reader.Skip(2);
+			if (control == 3) {
+				state.leading = unsigned(reader.Read(5));
+				unsigned meaningful = unsigned(reader.Read(Bits<T>::LENGTH_BITS)) + 1;
+				state.trailing = size - state.leading - meaningful;
+			}
+			unsigned meaningful = size - state.leading - state.trailing;
+			state.previous ^= reader.Read(meaningful) << state.trailing;
+			return state.previous;
+		}
+
+		/// The state of the time stream: the previous tick, and the
+		/// interval before it.
+		struct TimeState {
+			std::int64_t previous = 0;
+			std::int64_t interval = 0;
+		};
+
+		/// Appends a time after the first of a block, which is in the
+		/// header, as the change in interval: 0 for none, then 10, 110,
+		/// 1110 and 11110 followed by 7, 9, 12 and 32 bit changes, and
+		/// 11111 followed by the whole 64 bit interval.
+		inline void writeTime(BitWriter& writer, TimeState& state, std::int64_t tick) {
+			std::int64_t interval = std::int64_t(std::uint64_t(tick) - std::uint64_t(state.previous));
+			std::int64_t change = std::int64_t(std::uint64_t(interval) - std::uint64_t(state.interval));
+			state.previous = tick;
+			state.interval = interval;
+
+			if (change == 0) {
+				writer.Write(0, 1);
+			}
+			else if (change >= -63 && change <= 64) {
+				writer.Write(2, 2);
+				writer.Write(std::uint64_t(change + 63), 7);
+			}
+			else if (change >= -255 && change <= 256) {
+				writer.Write(6, 3);
+				writer.Write(std::uint64_t(change + 255), 9);
+			}
+			else if (change >= -2047 && change <= 2048) {
+				writer.Write(14, 4);
+				writer.Write(std::uint64_t(change + 2047), 12);
+			}
+			else if (change >= -2147483647ll && change <= 2147483648ll) {
+				writer.Write(30, 5);
+				writer.Write(std::uint64_t(change + 2147483647ll), 32);
+			}
+			else {
+				writer.Write(31, 5);
+				writer.Write(std::uint64_t(interval), 64);
+			}
+		}
+
+		inline std::int64_t readTime(BitReader& reader, TimeState& state) {
+			// The prefix is read all at once: the number of leading
+			// ones in the next five bits.
+			static const unsigned char ONES[32] = {
+				0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+				1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4, 5,
+			};
+			static const unsigned WIDTHS[] = {0, 7, 9, 12, 32};
+			static const std::int64_t OFFSETS[] = {0, 63, 255, 2047, 2147483647ll};
+			unsigned ones = ONES[reader.Peek(5)];
+			reader.Skip(ones == 5 ? 5 : ones + 1);
+			if (ones == 5) {
+				state.interval = std::int64_t(reader.Read(64));
+			}
+			else if (ones > 0) {
+				std::int64_t change = std::int64_t(reader.Read(WIDTHS[ones])) - OFFSETS[ones];
+				state.interval = std::int64_t(std::uint64_t(state.interval) + std::uint64_t(change));
+			}
+			state.previous = std::int64_t(std::uint64_t(state.previous) + std::uint64_t(state.interval));
+			return state.previous;
+		}
+
+		template <class T>
+		void swap(T& field) {
+			binary::reverseBytes(reinterpret_cast<char*>(&field), sizeof(field));
+		}
+
+		/// Checks that \a header starts a block of a series of Q, and
+		/// converts it to native byte order.
+		template <class Q>
+		void validate(SeriesBlockHeader& header) {
+			if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+				throw SerializationError("Not a compressed quantity series");
+			}
+			if (header.version != VERSION) {
+				throw SerializationError("Unsupported compressed series version " +
+							 std::to_string(int(header.version)));
+			}
+			if (header.endianness != QuantityHeader::LITTLE_ENDIAN_ORDER &&
+			    header.endianness != QuantityHeader::BIG_ENDIAN_ORDER) {
+				throw SerializationError("Invalid byte order in compressed series");
+			}
+
+			QuantityHeader expected = HeaderFor<Q>(0);
+			if (std::memcmp(header.exponents, expected.exponents, sizeof(expected.exponents)) != 0) {
+				throw DimensionMismatch("Expected quantities of dimensions " +
+							binary::dimensions(expected.exponents) + ", found " +
+							binary::dimensions(header.exponents));
+			}
+			if (header.number != expected.number) {
+				throw DimensionMismatch(std::string("Expected values of type ") +
+							binary::numberName(expected.number) + ", found " +
+							binary::numberName(header.number));
+			}
+
+			if (header.endianness != binary::nativeEndianness()) {
+				swap(header.count);
+				swap(header.timeBytes);
+				swap(header.valueBytes);
+				swap(header.first);
+				swap(header.firstTick);
+				swap(header.resolution);
+				header.endianness = binary::nativeEndianness();
+			}
+		}
+	}
+}
+
+/// Compresses a series of quantities, optionally with times, into blocks of
+/// a fixed number of samples.  See the top of this file.
+template <class Q>
+class SeriesEncoder {
+	typedef typename Q::type T;
+	static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+		      "Only float and double quantities can be compressed");
+	static_assert(sizeof(Q) == sizeof(T), "Quantity must wrap a bare Number");
+
+public:
+	/// Each block holds \a blockSize samples, the last perhaps fewer.
+	/// Times are stored in ticks of \a resolution.
+	explicit SeriesEncoder(std::size_t blockSize = 1024, Time resolution = ns)
+		: blockSize(std::max<std::size_t>(blockSize, 1)), resolution(double(resolution.Value()))
+	{}
+
+	/// Appends a sample without a time.  A series has times for all of
+	/// its samples or none; otherwise this throws a SerializationError.
+	void Append(Q value) {
+		Start(false);
+		AppendValue(value);
+	}
+
+	/// Appends a sample taken at \a time.
+	void Append(Time time, Q value) {
+		Start(true);
+		std::int64_t tick = std::llround(time.Value() / resolution);
+		if (count == 0) {
+			firstTick = tick;
+			timeState.previous = tick;
+			timeState.interval = 0;
+		}
+		else {
+			detail::compress::writeTime(timeBits, timeState, tick);
+		}
+		AppendValue(value);
+	}
+
+	/// Appends \a values.
+	void Append(QuantitySpan<const Q> values) {
+		for (Q value : values) {
+			Append(value);
+		}
+	}
+
+	/// Appends \a values, taken at \a times, which must be as many;
+	/// otherwise this throws a std::invalid_argument and appends nothing.
+	void Append(QuantitySpan<const Time> times, QuantitySpan<const Q> values) {
+		if (times.size() != values.size()) {
+			throw std::invalid_argument("Compressed series needs a time for every value");
+		}
+		for (std::size_t i = 0; i < values.size(); ++i) {
+			Append(times[i], values[i]);
+		}
+	}
+
+	/// Ends the current block, if it has any samples, so that the next
+	/// sample starts a new one.
+	void Flush() {
+		if (count == 0) {
+			return;
+		}
+		QuantityHeader quantity = HeaderFor<Q>(0);
+		SeriesBlockHeader header = {};
+		std::memcpy(header.magic, detail::compress::MAGIC, sizeof(header.magic));
+		header.version = detail::compress::VERSION;
+		header.endianness = quantity.endianness;
+		header.number = quantity.number;
+		header.flags = timed == 1 ? SeriesBlockHeader::HAS_TIMES : 0;
+		std::memcpy(header.exponents, quantity.exponents, sizeof(header.exponents));
+		header.count = std::uint32_t(count);
+		header.timeBytes = std::uint32_t(timeBits.Size());
+		header.valueBytes = std::uint32_t(valueBits.Size());
+		header.first = first;
+		header.firstTick = firstTick;
+		header.resolution = resolution;
+
+		const char* bytes = reinterpret_cast<const char*>(&header);
+		data.insert(data.end(), bytes, bytes + sizeof(header));
+		timeBits.AppendTo(data);
+		valueBits.AppendTo(data);
+		timeBits.Clear();
+		valueBits.Clear();
+		first += count;
+		count = 0;
+	}
+
+	/// The blocks finished so far.  The current block is not among them
+	/// until it fills or is flushed.
+	const std::vector<char>& Data() const {
+		return data;
+	}
+
+	/// Discards the blocks finished so far, for instance once they have
+	/// been saved.  The series carries on where it was, and later blocks
+	/// can be appended to the saved ones.
+	void ClearData() {
+		data.clear();
+	}
+
+	/// The number of samples appended.
+	std::uint64_t Size() const {
+		return first + count;
+	}
+
+private:
+	void Start(bool withTime) {
+		if (timed == -1) {
+			timed = withTime;
+		}
+		else if (timed != int(withTime)) {
+			throw SerializationError("Either every sample of a series has a time, or none does");
+		}
+	}
+
+	void AppendValue(Q value) {
+		detail::compress::writeValue<T>(valueBits, valueState,
+						detail::compress::toBits(T(value.Value())), count == 0);
+		if (++count == blockSize) {
+			Flush();
+		}
+	}
+
+	std::size_t blockSize;
+	double resolution;
+	std::vector<char> data;
+	detail::compress::BitWriter timeBits;
+	detail::compress::BitWriter valueBits;
+	detail::compress::ValueState valueState;
+	detail::compress::TimeState timeState;
+	std::int64_t firstTick = 0;
+	std::uint64_t first = 0;
+	std::size_t count = 0;
+	int timed = -1;
+};
+
+/// Decodes a series written by SeriesEncoder, which may be several
+/// encoders' blocks one after another.  Only the block headers are read up
+/// front, so decoding can start anywhere.
+template <class Q>
+class SeriesDecoder {
+	typedef typename Q::type T;
+
+public:
+	/// Reads the block headers of the \a size bytes at \a data, which must
+	/// outlive the decoder.  Throws a SerializationError if they are not
+	/// a compressed series, and a DimensionMismatch if it is a series of
+	/// some other quantity or Number type.
+	SeriesDecoder(const char* data, std::size_t size) {
+		std::size_t offset = 0;
+		while (offset < size) {
+			if (size - offset < sizeof(SeriesBlockHeader)) {
+				throw SerializationError("Truncated compressed series block header");
+			}
+			Block block;
+			std::memcpy(&block.header, data + offset, sizeof(block.header));
+			detail::compress::validate<Q>(block.header);
+			const SeriesBlockHeader& header = block.header;
+			std::size_t bytes = std::size_t(header.timeBytes) + header.valueBytes;
+			if (size - offset - sizeof(header) < bytes) {
+				throw SerializationError("Truncated compressed series block");
+			}
+			if (header.count == 0 || header.first != samples) {
+				throw SerializationError("Compressed series block out of sequence");
+			}
+			bool hasTimes = (header.flags & SeriesBlockHeader::HAS_TIMES) != 0;
+			if (!blocks.empty() && hasTimes != timed) {
+				throw SerializationError("Compressed series blocks with and without times");
+			}
+			timed = hasTimes;
+			block.times = data + offset + sizeof(header);
+			block.values = block.times + header.timeBytes;
+			blocks.push_back(block);
+			samples += header.count;
+			offset += sizeof(header) + bytes;
+		}
+	}
+
+	/// The number of samples in the series.
+	std::uint64_t Size() const {
+		return samples;
+	}
+
+	std::size_t Blocks() const {
+		return blocks.size();
+	}
+
+	bool HasTimes() const {
+		return timed;
+	}
+
+	/// Decodes samples from index \a first into \a values, as many as fit
+	/// or are left, and returns how many.  Decoding starts at the block
+	/// holding the first sample.
+	std::size_t Decode(std::uint64_t first, QuantitySpan<Q> values) const {
+		return Decode(first, QuantitySpan<Time>(), values, false);
+	}
+
+	/// Decodes samples from index \a first into \a times and \a values,
+	/// as many as fit in both or are left, and returns how many.  The
+	/// series must have times.
+	std::size_t Decode(std::uint64_t first, QuantitySpan<Time> times, QuantitySpan<Q> values) const {
+		if (!timed) {
+			throw SerializationError("The compressed series has no times");
+		}
+		std::size_t size = std::min(times.size(), values.size());
+		return Decode(first, times.subspan(0, size), values.subspan(0, size), true);
+	}
+
+	/// The index of the first sample taken at or after \a time, or Size()
+	/// if there is none.  Only the block that holds it is decoded.  The
+	/// series must have times, in increasing order.
+	std::uint64_t Find(Time time) const {
+		if (!timed) {
+			throw SerializationError("The compressed series has no times");
+		}
+		// The last block that starts at or before the time holds the
+		// sample, unless it comes after all of that block's.
+		auto after = std::upper_bound(blocks.begin(), blocks.end(), time,
+					      [](Time t, const Block& block) {
+			return t < TimeOf(block.header, block.header.firstTick);
+		});
+		if (after == blocks.begin()) {
+			return 0;
+		}
+		const Block& block = *(after - 1);
+		detail::compress::BitReader reader(block.times, block.values);
+		detail::compress::TimeState state;
+		state.previous = block.header.firstTick;
+		for (std::uint32_t i = 0; i < block.header.count; ++i) {
+			std::int64_t tick = i == 0 ? state.previous :
+					    detail::compress::readTime(reader, state);
+			if (!(TimeOf(block.header, tick) < time)) {
+				return block.header.first + i;
+			}
+		}
+		return block.header.first + block.header.count;
+	}
+
+private:
+	struct Block {
+		SeriesBlockHeader header;
+		const char* times;
+		const char* values;
+	};
+
+	static Time TimeOf(const SeriesBlockHeader& header, std::int64_t tick) {
+		return Time(tick * (long double)(header.resolution));
+	}
+
+	std::size_t Decode(std::uint64_t first, QuantitySpan<Time> times, QuantitySpan<Q> values,
+			   bool withTimes) const {
+		if (first >= samples) {
+			return 0;
+		}
+		std::size_t count = std::size_t(std::min<std::uint64_t>(values.size(), samples - first));
+		auto block = std::upper_bound(blocks.begin(), blocks.end(), first,
+					      [](std::uint64_t index, const Block& block) {
+			return index < block.header.first;
+		}) - 1;
+
+		std::size_t done = 0;
+		for (; done < count; ++block) {
+			const SeriesBlockHeader& header = block->header;
+			std::uint32_t skip = std::uint32_t(first + done - header.first);
+			std::uint32_t end = std::uint32_t(std::min<std::uint64_t>(header.count, skip + (count - done)));
+
+			detail::compress::BitReader valueReader(block->values, block->values + header.valueBytes);
+			detail::compress::ValueState valueState;
+			for (std::uint32_t i = 0; i < end; ++i) {
+				std::uint64_t bits = detail::compress::readValue<T>(valueReader, valueState, i == 0);
+				if (i >= skip) {
+					values[done + i - skip] = Q(detail::compress::fromBits<T>(
+						typename detail::compress::Bits<T>::type(bits)));
+				}
+			}
+
+			if (withTimes) {
+				detail::compress::BitReader timeReader(block->times, block->values);
+				detail::compress::TimeState timeState;
+				timeState.previous = header.firstTick;
+				for (std::uint32_t i = 0; i < end; ++i) {
+					std::int64_t tick = i == 0 ? timeState.previous :
+							    detail::compress::readTime(timeReader, timeState);
+					if (i >= skip) {
+						times[done + i - skip] = TimeOf(header, tick);
+					}
+				}
+			}
+			done += end - skip;
+		}
+		return count;
+	}
+
+	std::vector<Block> blocks;
+	std::uint64_t samples = 0;
+	bool timed = false;
+};
+
+#endif // BTUL_COMPRESS_H
@@ -0,0 +1,110 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_CONSTANTS_H
+#define BTUL_CONSTANTS_H
+
+#include <btul.h>
+
+
+// Physical constants as constexpr quantities, built from the units in btul.h
+// so that each has the right dimensions.  Every value, and every product of
+// values, is a constant expression:
+//
+//	constexpr auto photonEnergy = constants::h * constants::c / 500_nm;
+//	static_assert(photonEnergy.Value() > 0, "Folded at compile time");
+//
+// The exact values are those fixed by the 2019 redefinition of the SI; the
+// measured values are the CODATA 2018 recommendations.
+namespace detail {
+	namespace constants {
+		constexpr long double PI = 3.14159265358979323846264338327950288L;
+		constexpr long double PI_5 = PI * PI * PI * PI * PI;
+	}
+}
+
+namespace constants {
+	// Defining constants of the SI, exact.
+
+	/// Hyperfine transition frequency of caesium 133.
+	constexpr auto Delta_nu_Cs = 9192631770.0L * Hz;
+	/// Speed of light in vacuum.
+	constexpr auto c = 299792458.0L * m / s;
+	/// Planck constant.
+	constexpr auto h = 6.62607015e-34L * J * s;
+	/// Elementary charge.
+	constexpr auto e = 1.602176634e-19L * A * s;
+	/// Boltzmann constant.
+	constexpr auto k_B = 1.380649e-23L * J / K;
+	/// Avogadro constant.
+	constexpr auto N_A = 6.02214076e23L / mol;
+	/// Luminous efficacy of 540 THz radiation, in lm/W.
+	constexpr auto K_cd = 683.0L * cd * s.p3() / (kg * m.p2());
+
+	// Exact by derivation from the above.
+
+	/// Reduced Planck constant.
+	constexpr auto hbar = h / (2 * detail::constants::PI);
+	/// Molar gas constant.
+	constexpr auto R = N_A * k_B;
+	/// Faraday constant.
+	constexpr auto F = N_A * e;
+	/// Stefan-Boltzmann constant, 2 pi^5 k^4 / (15 h^3 c^2).
+	constexpr auto sigma = 2 * detail::constants::PI_5 * (k_B * k_B * k_B * k_B) /
+			       (15 * (h * h * h) * (c * c));
+	/// Josephson constant, 2e / h.
+	constexpr auto K_J = 2 * e / h;
+	/// von Klitzing constant, h / e^2.
+	constexpr auto R_K = h / (e * e);
+
+	// Conventional values, exact.
+
+	/// Standard acceleration of gravity.
+	constexpr auto g_n = 9.80665L * m / s.p2();
+	/// Standard atmosphere.
+	constexpr auto atm = 101325.0L * N / m.p2();
+
+	// Measured, CODATA 2018.
+
+	/// Newtonian constant of gravitation.
+	constexpr auto G = 6.67430e-11L * m.p3() / (kg * s.p2());
+	/// Fine-structure constant.
+	constexpr long double alpha = 7.2973525693e-3L;
+	/// Vacuum magnetic permeability, 2 alpha h / (e^2 c).
+	constexpr auto mu_0 = 1.25663706212e-6L * N / (A * A);
+	/// Vacuum electric permittivity, 1 / (mu_0 c^2).
+	constexpr auto epsilon_0 = 1 / (mu_0 * c * c);
+	/// Electron mass.
+	constexpr auto m_e = 9.1093837015e-31L * kg;
+	/// Proton mass.
+	constexpr auto m_p = 1.67262192369e-27L * kg;
+	/// Neutron mass.
+	constexpr auto m_n = 1.67492749804e-27L * kg;
+	/// Atomic mass constant, 1/12 of the mass of carbon 12.
+	constexpr auto m_u = 1.66053906660e-27L * kg;
+	/// Rydberg constant.
+	constexpr auto R_inf = 10973731.568160L / m;
+	/// Bohr radius.
+	constexpr auto a_0 = 5.29177210903e-11L * m;
+}
+
+#endif // BTUL_CONSTANTS_H
@@ -0,0 +1,891 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_CSV_H
+#define BTUL_CSV_H
+
+#include <btul.h>
+#include <btul_mapped.h>
+#include <btul_span.h>
+#include <btul_units.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// Reading CSV files whose header cells carry units, like "speed [km/h]",
+// straight into arrays of quantities.  The header is parsed once, each unit
+// into a dimension and a scale; the rows are then parsed and scaled into the
+// vectors bound to the columns, optionally on several threads:
+//
+//	CsvReader csv("run.csv");
+//	std::vector<Speed> speeds;
+//	std::vector<Mass> masses;
+//	csv.Bind("speed", speeds);		// Throws a UnitError unless the
+//	csv.Bind("mass", masses);		// units are a speed and a mass.
+//	std::size_t rows = csv.Read(4);
+//
+// Files are mapped rather than read, with sequential readahead.  Numbers are
+// parsed in double precision, almost always on Clinger's fast path, except
+// in columns bound to long double quantities, which are read by strtold so
+// that they keep every digit; empty fields, and fields missing from the end
+// of a row, read as NaN.  Columns
+// that are not bound are skipped without being parsed, and may hold
+// anything, including quoted text, as long as no field spans lines.
+//
+// CsvWriter goes the other way.  Each header cell gets the SI unit of its
+// quantity's dimensions, which is known at compile time, and the values are
+// written in that unit, formatted block by block into reusable buffers that
+// are written out in large pieces:
+//
+//	CsvWriter csv(file);
+//	csv.Add("speed", speeds);		// Written as "speed [m/s]".
+//	csv.Add("mass", masses);
+//	csv.Write(4);
+
+/// Malformed CSV.
+class CsvError : public std::runtime_error {
+public:
+	explicit CsvError(const std::string& what)
+		: std::runtime_error(what)
+	{}
+};
+
+namespace detail {
+	namespace csv {
+		/// The powers of ten that are exact in a double.
+		constexpr double EXACT_POWERS[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		inline bool isDigit(char c) {
+			return unsigned(c - '0') < 10;
+		}
+
+		/// Reads a run of decimal digits into \a mantissa, and returns
+		/// the end of the run.
+		inline const char* digits(const char* p, const char* end, std::uint64_t& mantissa) {
+			unsigned digit;
+			while (p != end && (digit = unsigned(*p - '0')) < 10) {
+				mantissa = 10 * mantissa + digit;
+				++p;
+			}
+			return p;
+		}
+
+		/// Reads a decimal number starting at \a p, leaving \a p after
+		/// it.  A number with at most 19 significant digits is read
+		/// into an integer, and when that integer and its power of ten
+		/// are both exact in a double, one multiplication or division
+		/// gives the correctly rounded result (Clinger's fast path).
+		/// Returns false, with \a p somewhere in the number, for
+		/// anything else, including numbers off the fast path.
+		inline bool scanNumber(const char*& p, const char* end, double& value) {
+			bool negative = p != end && *p == '-';
+			p += p != end && (*p == '-' || *p == '+');
+
+			// The digits are accumulated without checking for
+			// overflow, and counted afterwards; more than 19 of
+			// them, leading zeros included, is off the fast path.
+			std::uint64_t mantissa = 0;
+			const char* start = p;
+			p = csv::digits(p, end, mantissa);
+			std::ptrdiff_t count = p - start;
+			int exponent = 0;
+			if (p != end && *p == '.') {
+				const char* fraction = ++p;
+				p = csv::digits(p, end, mantissa);
+				count += p - fraction;
+				exponent = -int(p - fraction);
+			}
+			if (count == 0) {
+				return false;
+			}
+
+			if (p != end && (*p == 'e' || *p == 'E')) {
+				++p;
+				bool negativeExponent = p != end && *p == '-';
+				p += p != end && (*p == '-' || *p == '+');
+				if (p == end || !isDigit(*p)) {
+					return false;
+				}
+				int explicitExponent = 0;
+				while (p != end && isDigit(*p)) {
+					explicitExponent = explicitExponent < 100000 ?
+							   10 * explicitExponent + (*p - '0') :
+							   explicitExponent;
+					++p;
+				}
+				exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			}
+
+			if (count > 19 || mantissa > (std::uint64_t(1) << 53) ||
+			    exponent < -22 || exponent > 22) {
+				return false;
+			}
+			double m = double(mantissa);
+			m = exponent < 0 ? m / EXACT_POWERS[-exponent] : m * EXACT_POWERS[exponent];
+			value = negative ? -m : m;
+			return true;
+		}
+
+		/// Parses the whole of [p, end) with \a convert, strtod or
+		/// strtold, which need it terminated.
+		template <class T>
+		bool convertNumber(const char* p, const char* end, T& value,
+				   T (*convert)(const char*, char**)) {
+			char buffer[128];
+			std::size_t length = std::size_t(end - p);
+			if (length == 0 || length >= sizeof(buffer)) {
+				return false;
+			}
+			std::memcpy(buffer, p, length);
+			buffer[length] = '\0';
+			char* parsed;
+			value = convert(buffer, &parsed);
+			return parsed == buffer + length;
+		}
+
+		/// Parses the whole of [p, end), which has already been trimmed,
+		/// as a number: by scanNumber if possible, otherwise by strtod,
+		/// which takes care of long mantissas, large exponents, nan and
+		/// inf.  Returns false if it is not a number.
+		inline bool parseNumber(const char* p, const char* end, double& value) {
+			const char* start = p;
+			if (scanNumber(p, end, value) && p == end) {
+				return true;
+			}
+			return convertNumber<double>(start, end, value, std::strtod);
+		}
+
+		/// Parses [p, end) in long double precision, always by strtold,
+		/// since the fast path is only exact in double.
+		inline bool parseNumber(const char* p, const char* end, long double& value) {
+			return convertNumber<long double>(p, end, value, std::strtold);
+		}
+
+		enum class Kind {
+			Float,
+			Double,
+			LongDouble
+		};
+
+		template <class T>
+		constexpr Kind kindOf() {
+			return std::is_same<T, float>::value ? Kind::Float :
+			       std::is_same<T, double>::value ? Kind::Double :
+			       Kind::LongDouble;
+		}
+
+		/// A vector bound to a column, with its type erased.
+		struct Target {
+			Kind kind;
+			void* vector;
+			void* (*resize)(void* vector, std::size_t size);
+			double scale;
+			long double longScale;
+			void* data;
+		};
+
+		inline const char* trimStart(const char* p, const char* end) {
+			while (p != end && (*p == ' ' || *p == '\t')) {
+				++p;
+			}
+			return p;
+		}
+
+		inline const char* trimEnd(const char* begin, const char* p) {
+			while (p != begin && (p[-1] == ' ' || p[-1] == '\t' || p[-1] == '\r')) {
+				--p;
+			}
+			return p;
+		}
+
+		/// The end of the field starting at \a p: the delimiter, the end
+		/// of the line, or \a end.  Quoted fields may contain the
+		/// delimiter.
+		inline const char* fieldEnd(const char* p, const char* end, char delimiter) {
+			p = trimStart(p, end);
+			if (p != end && *p == '"') {
+				for (++p; p != end && *p != '\n'; ++p) {
+					if (*p == '"') {
+						if (p + 1 != end && p[1] == '"') {
+							++p;
+						}
+						else {
+							++p;
+							break;
+						}
+					}
+				}
+			}
+			while (p != end && *p != delimiter && *p != '\n') {
+				++p;
+			}
+			return p;
+		}
+
+		/// The text of a field, trimmed and unquoted.
+		inline std::string fieldText(const char* p, const char* end) {
+			p = trimStart(p, end);
+			end = trimEnd(p, end);
+			if (end - p >= 2 && *p == '"' && end[-1] == '"') {
+				std::string text;
+				for (const char* q = p + 1; q < end - 1; ++q) {
+					text += *q;
+					q += *q == '"' && q[1] == '"';
+				}
+				return text;
+			}
+			return std::string(p, end);
+		}
+
+		/// The end of the line starting at \a p, not including the
+		/// newline.
+		inline const char* lineEnd(const char* p, const char* end) {
+			const void* newline = std::memchr(p, '\n', std::size_t(end - p));
+			return newline ? static_cast<const char*>(newline) : end;
+		}
+
+		inline bool blank(const char* p, const char* line) {
+			return line == p || (line == p + 1 && *p == '\r');
+		}
+
+		/// 10^n for n < 32, and 10^(32n) for n < 11, in extended
+		/// precision.  Up to 10^27 they are exact.
+		constexpr long double SMALL_POWERS[] = {
+			1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L,
+			1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L,
+			1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L, 1e28L, 1e29L, 1e30L,
+			1e31L,
+		};
+		constexpr long double LARGE_POWERS[] = {
+			1e0L, 1e32L, 1e64L, 1e96L, 1e128L, 1e160L, 1e192L, 1e224L, 1e256L,
+			1e288L, 1e320L,
+		};
+
+		constexpr std::uint64_t INTEGER_POWERS[] = {
+			1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull,
+			10000000ull, 100000000ull, 1000000000ull, 10000000000ull,
+			100000000000ull, 1000000000000ull, 10000000000000ull,
+			100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+			100000000000000000ull,
+		};
+
+		/// \a x * 10^n, for |n| < 352, to within two ulps of extended
+		/// precision.
+		inline long double scale(long double x, int n) {
+			unsigned a = unsigned(n < 0 ? -n : n);
+			long double power = SMALL_POWERS[a & 31] * LARGE_POWERS[a >> 5];
+			return n < 0 ? x / power : x * power;
+		}
+
+		/// The most characters formatNumber writes.
+		constexpr std::size_t MAX_NUMBER_SIZE = 48;
+
+		/// The end of what snprintf wrote at \a p into MAX_NUMBER_SIZE
+		/// bytes, given its result \a length, which is the length it
+		/// would have written without truncation, or negative.
+		inline char* printed(char* p, int length) {
+			return p + std::min(std::size_t(std::max(length, 0)), MAX_NUMBER_SIZE - 1);
+		}
+
+		/// Writes \a value at \a p like printf's "%.*g", and returns the
+		/// end of the number.
+		///
+		/// With an extended precision long double, a finite non-zero
+		/// value is scaled by a power of ten to a \a precision digit
+		/// integer in that precision, and its digits are written out.
+		/// The scaling is off by at most a few parts in 2^64, so the
+		/// last digit can differ from printf's for values that close to
+		/// halfway between two decimals; at max_digits10, the result
+		/// still always reads back exactly.  Everything else goes to
+		/// snprintf, which is several times slower.
+		inline char* formatDouble(char* p, double value, int precision) {
+			if (std::numeric_limits<long double>::digits < 64 ||
+			    precision < 1 || precision > 17 ||
+			    !std::isfinite(value) || value == 0) {
+				return printed(p, std::snprintf(p, MAX_NUMBER_SIZE, "%.*g", precision, value));
+			}
+			if (value < 0) {
+				*p++ = '-';
+				value = -value;
+			}
+
+			// The estimate of the decimal exponent from the binary
+			// one is exact or one too low, and rounding can carry
+			// into another digit.
+			int binary;
+			std::frexp(value, &binary);
+			int exponent = int(std::floor((binary - 1) * 0.30102999566398120));
+			std::uint64_t mantissa;
+			while ((mantissa = std::uint64_t(std::llrint(
+					scale(value, precision - 1 - exponent)))) >= INTEGER_POWERS[precision]) {
+				++exponent;
+			}
+
+			char digits[20];
+			for (int i = precision - 1; i >= 0; --i) {
+				digits[i] = char('0' + mantissa % 10);
+				mantissa /= 10;
+			}
+			int count = precision;
+			while (count > 1 && digits[count - 1] == '0') {
+				--count;
+			}
+
+			if (exponent < -4 || exponent >= precision) {
+				*p++ = digits[0];
+				if (count > 1) {
+					*p++ = '.';
+					std::memcpy(p, digits + 1, std::size_t(count - 1));
+					p += count - 1;
+				}
+				*p++ = 'e';
+				*p++ = exponent < 0 ? '-' : '+';
+				unsigned magnitude = unsigned(exponent < 0 ? -exponent : exponent);
+				if (magnitude >= 100) {
+					*p++ = char('0' + magnitude / 100);
+				}
+				*p++ = char('0' + magnitude / 10 % 10);
+				*p++ = char('0' + magnitude % 10);
+			}
+			else if (exponent < 0) {
+				*p++ = '0';
+				*p++ = '.';
+				for (int i = -1; i > exponent; --i) {
+					*p++ = '0';
+				}
+				std::memcpy(p, digits, std::size_t(count));
+				p += count;
+			}
+			else {
+				std::memcpy(p, digits, std::size_t(exponent + 1));
+				p += exponent + 1;
+				if (count > exponent + 1) {
+					*p++ = '.';
+					std::memcpy(p, digits + exponent + 1, std::size_t(count - exponent - 1));
+					p += count - exponent - 1;
+				}
+			}
+			return p;
+		}
+
+		/// Writes \a value at \a p with \a precision significant
+		/// digits, or if that is zero with max_digits10, which is enough
+		/// to read it back exactly, and returns the end of the number.
+		template <class T>
+		char* formatNumber(char* p, T value, int precision) {
+			precision = precision == 0 ? std::numeric_limits<T>::max_digits10 : precision;
+			return formatDouble(p, double(value), precision);
+		}
+
+		template <>
+		inline char* formatNumber(char* p, long double value, int precision) {
+			precision = precision == 0 ? std::numeric_limits<long double>::max_digits10 : precision;
+			return printed(p, std::snprintf(p, MAX_NUMBER_SIZE, "%.*Lg", precision, value));
+		}
+
+		/// \a text, quoted if it holds anything that would split it.
+		inline std::string quote(const std::string& text, char delimiter) {
+			if (text.find_first_of(std::string("\"\r\n") + delimiter) == std::string::npos) {
+				return text;
+			}
+			std::string quoted = "\"";
+			for (char c : text) {
+				quoted += c;
+				if (c == '"') {
+					quoted += c;
+				}
+			}
+			return quoted + '"';
+		}
+
+		/// The SI unit of Q, as Quantity prints it.
+		template <class Q>
+		std::string unitText() {
+			std::string text = DefaultQuantityFormat<Q::length, Q::mass, Q::time, Q::current,
+								 Q::temperature, Q::amount, Q::luminosity,
+								 Q::root>::Format(0);
+			return text.substr(text.find(' ') + 1);
+		}
+
+		/// Runs \a work(t) for t in [0, threads), on that many threads, and
+		/// rethrows the first exception thrown by any of them.
+		template <class Work>
+		void parallel(unsigned threads, Work work) {
+			if (threads == 1) {
+				work(0);
+				return;
+			}
+			std::vector<std::exception_ptr> errors(threads);
+			std::vector<std::thread> workers;
+			for (unsigned t = 0; t < threads; ++t) {
+				workers.emplace_back([&, t] {
+					try {
+						work(t);
+					}
+					catch (...) {
+						errors[t] = std::current_exception();
+					}
+				});
+			}
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+			for (const std::exception_ptr& error : errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+		}
+	}
+}
+
+/// Reads a CSV file with a header row into vectors of quantities.  See the
+/// top of this file.
+class CsvReader {
+public:
+	/// Maps the file at \a path and parses its header.
+	explicit CsvReader(const std::string& path, char delimiter = ',')
+		: file(new MappedFile(path, AccessPattern::Sequential)),
+		  begin(file->Data()), end(file->Data() + file->Size()), delimiter(delimiter)
+	{
+		ParseHeader();
+	}
+
+	/// Reads the \a size bytes of CSV text at \a data, which must outlive
+	/// the reader.
+	CsvReader(const char* data, std::size_t size, char delimiter = ',')
+		: begin(data), end(data + size), delimiter(delimiter)
+	{
+		ParseHeader();
+	}
+
+	std::size_t Columns() const {
+		return columns.size();
+	}
+
+	/// The name of a column, without its unit.
+	const std::string& Name(std::size_t column) const {
+		return columns[column].name;
+	}
+
+	const ParsedUnit& Unit(std::size_t column) const {
+		return columns[column].unit;
+	}
+
+	/// The index of the column \a name.  Throws a CsvError if there is
+	/// none.
+	std::size_t Find(const std::string& name) const {
+		for (std::size_t i = 0; i < columns.size(); ++i) {
+			if (columns[i].name == name) {
+				return i;
+			}
+		}
+		throw CsvError("No column " + name);
+	}
+
+	/// Has Read fill \a out with the column \a name, converted from the
+	/// column's unit.  Throws a UnitError if the unit does not have the
+	/// dimensions of Q.
+	template <class Q>
+	void Bind(const std::string& name, std::vector<Q>& out) {
+		typedef typename Q::type T;
+		static_assert(std::is_floating_point<T>::value,
+			      "Columns can only be read into floating point quantities");
+		static_assert(sizeof(Q) == sizeof(T), "Quantity must wrap a bare Number");
+
+		std::size_t column = Find(name);
+		if (!columns[column].unit.template Is<Q>()) {
+			throw UnitError("Column " + name + " is in " + columns[column].unitText +
+					", which does not have the dimensions of the quantity");
+		}
+		long double scale = columns[column].unit.scale;
+		columns[column].target.reset(new detail::csv::Target{
+			detail::csv::kindOf<T>(),
+			&out,
+			[](void* vector, std::size_t size) -> void* {
+				std::vector<Q>& values = *static_cast<std::vector<Q>*>(vector);
+				values.resize(size);
+				return values.data();
+			},
+			double(scale),
+			scale,
+			nullptr
+		});
+	}
+
+	/// Parses every row into the bound vectors, which are resized to the
+	/// number of rows, splitting the file between \a threads threads.
+	/// Returns the number of rows.  Throws a CsvError if a bound column
+	/// holds something that is not a number.
+	std::size_t Read(unsigned threads = 1) {
+		threads = threads == 0 ? 1 : threads;
+
+		// Chunks start at the beginning of a line, so that each can
+		// be parsed independently.
+		std::vector<const char*> bounds(1, body);
+		for (unsigned t = 1; t < threads; ++t) {
+			const char* split = body + std::size_t(end - body) * t / threads;
+			if (split > bounds.back()) {
+				const char* newline = detail::csv::lineEnd(split - 1, end);
+				split = newline == end ? end : newline + 1;
+			}
+			bounds.push_back(split > bounds.back() ? split : bounds.back());
+		}
+		bounds.push_back(end);
+
+		// Counting the rows first lets every chunk write straight into
+		// the output.
+		std::vector<std::size_t> firstRow(threads + 1, 0);
+		detail::csv::parallel(threads, [&](unsigned t) {
+			firstRow[t + 1] = CountRows(bounds[t], bounds[t + 1]);
+		});
+		for (unsigned t = 0; t < threads; ++t) {
+			firstRow[t + 1] += firstRow[t];
+		}
+		std::size_t rows = firstRow[threads];
+
+		for (Column& column : columns) {
+			if (column.target) {
+				column.target->data = column.target->resize(column.target->vector, rows);
+			}
+		}
+		detail::csv::parallel(threads, [&](unsigned t) {
+			Parse(bounds[t], bounds[t + 1], firstRow[t]);
+		});
+		return rows;
+	}
+
+private:
+	struct Column {
+		std::string name;
+		std::string unitText;
+		ParsedUnit unit;
+		std::unique_ptr<detail::csv::Target> target;
+	};
+
+	void ParseHeader() {
+		const char* line = detail::csv::lineEnd(begin, end);
+		body = line == end ? end : line + 1;
+		if (line == begin) {
+			throw CsvError("Missing CSV header");
+		}
+		for (const char* p = begin; ; ) {
+			const char* field = detail::csv::fieldEnd(p, line, delimiter);
+			std::string cell = detail::csv::fieldText(p, field);
+
+			Column column;
+			std::size_t open = cell.rfind('[');
+			if (!cell.empty() && cell.back() == ']' && open != std::string::npos) {
+				column.name = detail::csv::fieldText(cell.data(), cell.data() + open);
+				column.unitText = cell.substr(open + 1, cell.size() - open - 2);
+			}
+			else {
+				column.name = cell;
+			}
+			column.unit = ParseUnit(column.unitText);
+			columns.push_back(std::move(column));
+
+			if (field == line) {
+				break;
+			}
+			p = field + 1;
+		}
+	}
+
+	std::size_t CountRows(const char* p, const char* last) const {
+		std::size_t rows = 0;
+		while (p < last) {
+			const char* line = detail::csv::lineEnd(p, last);
+			rows += !detail::csv::blank(p, line);
+			p = line + 1;
+		}
+		return rows;
+	}
+
+	// Parses rows in a single pass: each field is scanned once, by the
+	// number parser for bound columns, and the end of the line is found
+	// on the way.
+	void Parse(const char* p, const char* last, std::size_t row) const {
+		std::vector<const detail::csv::Target*> targets;
+		for (const Column& column : columns) {
+			targets.push_back(column.target.get());
+		}
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+
+		while (p < last) {
+			if (*p == '\n' || (*p == '\r' && (p + 1 == last || p[1] == '\n'))) {
+				p += 1 + (*p == '\r');
+				continue;
+			}
+			std::size_t c = 0;
+			for (; c < targets.size(); ++c) {
+				if (targets[c] && targets[c]->kind == detail::csv::Kind::LongDouble) {
+					Store(*targets[c], row, ParseField<long double>(p, last, c, row));
+				}
+				else if (targets[c]) {
+					Store(*targets[c], row, ParseField<double>(p, last, c, row));
+				}
+				else {
+					p = detail::csv::fieldEnd(p, last, delimiter);
+				}
+				if (p == last || *p == '\n') {
+					++c;
+					break;
+				}
+				++p;
+			}
+			for (; c < targets.size(); ++c) {
+				if (targets[c]) {
+					Store(*targets[c], row, nan);
+				}
+			}
+			p = p < last && *p != '\n' ? detail::csv::lineEnd(p, last) : p;
+			++p;
+			++row;
+		}
+	}
+
+	/// Parses the field at \a p in the precision of T, leaving \a p at the
+	/// delimiter or newline after it.
+	template <class T>
+	T ParseField(const char*& p, const char* last, std::size_t column, std::size_t row) const {
+		const char* start = detail::csv::trimStart(p, last);
+		const char* q = start;
+		bool quoted = q != last && *q == '"';
+		q += quoted;
+
+		double fast;
+		if (std::is_same<T, double>::value && detail::csv::scanNumber(q, last, fast)) {
+			q += quoted && q != last && *q == '"';
+			while (q != last && (*q == ' ' || *q == '\t' || *q == '\r')) {
+				++q;
+			}
+			if (q == last || *q == delimiter || *q == '\n') {
+				p = q;
+				return fast;
+			}
+		}
+
+		// Off the fast path.
+		p = detail::csv::fieldEnd(start, last, delimiter);
+		const char* stop = detail::csv::trimEnd(start, p);
+		if (stop - start >= 2 && *start == '"' && stop[-1] == '"') {
+			++start;
+			--stop;
+		}
+		if (start == stop) {
+			return std::numeric_limits<T>::quiet_NaN();
+		}
+		T value;
+		if (!detail::csv::parseNumber(start, stop, value)) {
+			throw CsvError("Cannot parse \"" + std::string(start, stop) + "\" in column " +
+				       columns[column].name + " of row " + std::to_string(row + 1));
+		}
+		return value;
+	}
+
+	static void Store(const detail::csv::Target& target, std::size_t row, double value) {
+		switch (target.kind) {
+			case detail::csv::Kind::Float:
+				static_cast<float*>(target.data)[row] = float(value * target.scale);
+				break;
+			case detail::csv::Kind::Double:
+				static_cast<double*>(target.data)[row] = value * target.scale;
+				break;
+			case detail::csv::Kind::LongDouble:
+				static_cast<long double*>(target.data)[row] = value * target.longScale;
+				break;
+		}
+	}
+
+	static void Store(const detail::csv::Target& target, std::size_t row, long double value) {
+		static_cast<long double*>(target.data)[row] = value * target.longScale;
+	}
+
+	std::unique_ptr<MappedFile> file;
+	const char* begin;
+	const char* end;
+	const char* body;
+	char delimiter;
+	std::vector<Column> columns;
+};
+
+/// Writes arrays of quantities as the columns of a CSV file with a header
+/// row.  See the top of this file.
+class CsvWriter {
+public:
+	/// Writes to \a stream, separating fields with \a delimiter; '\\t'
+	/// gives TSV.  Values are written with \a precision significant
+	/// digits, or, if it is zero, with enough for CsvReader to read them
+	/// back exactly.
+	/// Throws a std::invalid_argument unless \a precision is between zero
+	/// and the max_digits10 of long double.
+	explicit CsvWriter(std::ostream& stream, char delimiter = ',', int precision = 0)
+		: stream(stream), delimiter(delimiter), precision(precision)
+	{
+		if (precision < 0 || precision > std::numeric_limits<long double>::max_digits10) {
+			throw std::invalid_argument("CSV precision out of range: " +
+						    std::to_string(precision));
+		}
+	}
+
+	/// Adds the column \a name, headed with the SI unit of Q.  \a values
+	/// must outlive the writer.  Columns shorter than the longest leave
+	/// their remaining fields empty.  Q must have integer exponents, since
+	/// CsvReader could not parse the unit of any other.
+	template <class Q>
+	void Add(const std::string& name, QuantitySpan<const Q> values) {
+		typedef typename Q::type T;
+		static_assert(std::is_floating_point<T>::value,
+			      "Only floating point quantities can be written");
+		static_assert(sizeof(Q) == sizeof(T), "Quantity must wrap a bare Number");
+		static_assert(Q::root == 1, "Only quantities with integer exponents can be written");
+
+		std::string unit = detail::csv::unitText<Q>();
+		std::string header = unit.empty() ? name : name + " [" + unit + "]";
+		columns.push_back(Column{
+			detail::csv::quote(header, delimiter),
+			detail::csv::kindOf<T>(),
+			values.data(),
+			values.size()
+		});
+	}
+
+	template <class Q>
+	void Add(const std::string& name, const std::vector<Q>& values) {
+		Add(name, QuantitySpan<const Q>(values));
+	}
+
+	/// The number of rows Write writes, not counting the header.
+	std::size_t Rows() const {
+		std::size_t rows = 0;
+		for (const Column& column : columns) {
+			rows = std::max(rows, column.size);
+		}
+		return rows;
+	}
+
+	/// Writes the header and every row, formatting on \a threads threads.
+	/// The stream's error state is left for the caller to check.
+	void Write(unsigned threads = 1) {
+		threads = threads == 0 ? 1 : threads;
+		buffers.resize(std::max<std::size_t>(buffers.size(), threads));
+
+		std::string header;
+		for (std::size_t c = 0; c < columns.size(); ++c) {
+			if (c != 0) {
+				header += delimiter;
+			}
+			header += columns[c].header;
+		}
+		header += '\n';
+		stream.write(header.data(), std::streamsize(header.size()));
+
+		// Each round, every thread formats a block of rows into its
+		// own buffer, and the buffers are written out in order.
+		std::size_t rows = Rows();
+		for (std::size_t first = 0; first < rows; first += BLOCK_ROWS * threads) {
+			std::vector<std::size_t> sizes(threads);
+			detail::csv::parallel(threads, [&](unsigned t) {
+				std::size_t begin = std::min(rows, first + BLOCK_ROWS * t);
+				std::size_t end = std::min(rows, begin + BLOCK_ROWS);
+				sizes[t] = Format(begin, end, buffers[t]);
+			});
+			for (unsigned t = 0; t < threads; ++t) {
+				stream.write(buffers[t].data(), std::streamsize(sizes[t]));
+			}
+		}
+	}
+
+private:
+	/// Rows per block.  A block of a few columns is a few hundred
+	/// kilobytes of text.
+	static constexpr std::size_t BLOCK_ROWS = 8192;
+
+	struct Column {
+		std::string header;
+		detail::csv::Kind kind;
+		const void* data;
+		std::size_t size;
+	};
+
+	/// Formats rows [begin, end) into \a buffer, and returns their size.
+	std::size_t Format(std::size_t begin, std::size_t end, std::vector<char>& buffer) const {
+		buffer.resize(std::max(buffer.size(),
+				       (end - begin) * columns.size() * (detail::csv::MAX_NUMBER_SIZE + 1)));
+		char* p = buffer.data();
+		for (std::size_t row = begin; row < end; ++row) {
+			for (std::size_t c = 0; c < columns.size(); ++c) {
+				if (c != 0) {
+					*p++ = delimiter;
+				}
+				const Column& column = columns[c];
+				if (row < column.size) {
+					p = FormatValue(p, column, row);
+				}
+			}
+			*p++ = '\n';
+		}
+		return std::size_t(p - buffer.data());
+	}
+
+	char* FormatValue(char* p, const Column& column, std::size_t row) const {
+		switch (column.kind) {
+			case detail::csv::Kind::Float:
+				return detail::csv::formatNumber(
+					p, static_cast<const float*>(column.data)[row], precision);
+			case detail::csv::Kind::Double:
+				return detail::csv::formatNumber(
+					p, static_cast<const double*>(column.data)[row], precision);
+			case detail::csv::Kind::LongDouble:
+				return detail::csv::formatNumber(
+					p, static_cast<const long double*>(column.data)[row], precision);
+		}
+		return p;
+	}
+
+	std::ostream& stream;
+	char delimiter;
+	int precision;
+	std::vector<Column> columns;
+	std::vector<std::vector<char>> buffers;
+};
+
+#endif // BTUL_CSV_H
@@ -0,0 +1,172 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_DUAL_H
+#define BTUL_DUAL_H
+
+#include <btul.h>
+#include <btul_chain.h>
+
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+
+/// A dual number v + t·ε with ε² = 0, for forward-mode automatic
+/// differentiation.  Evaluating a function on Dual numbers carries its exact
+/// derivative along with its value, in a single pass and without the
+/// truncation error of finite differences.  With N tangents, derivatives
+/// with respect to N independent variables are propagated at once; the
+/// tangents are stored contiguously, so the per-tangent loops vectorize.
+///
+/// Dual is a drop-in Number type for Quantity.  Derivative() then gives
+/// derivatives with the dimensions of their quotient:
+///
+/// \code
+/// auto x = Variable(0.2_m);
+/// auto energy = 0.5 * 300_N / m * x.p2();
+/// Force restoring = Derivative(energy, x);
+/// \endcode
+///
+/// Comparisons compare only the values.
+template <class T = double, std::size_t N = 1>
+class Dual {
+	static_assert(std::is_floating_point<T>::value,
+		      "Dual numbers must be floating point");
+	static_assert(N > 0, "Dual numbers need at least one tangent");
+
+public:
+	typedef T value_type;
+
+	constexpr Dual()
+		: value(0), tangents()
+	{}
+
+	/// A constant, with zero derivatives.
+	constexpr Dual(T value)
+		: value(value), tangents()
+	{}
+
+	/// An independent variable, whose derivative is tracked in the tangent
+	/// with the given index.
+	static Dual Variable(T value, std::size_t index = 0) {
+		Dual result(value);
+		result.tangents[index] = 1;
+		return result;
+	}
+
+	constexpr T Value() const {
+		return value;
+	}
+
+	constexpr T Tangent(std::size_t i = 0) const {
+		return tangents[i];
+	}
+
+	/// The chain rule: the result of a function of this number, given the
+	/// value and derivative of that function here.  The arithmetic and
+	/// math functions in btul_chain.h are written in terms of this, and so
+	/// can others be.
+	Dual Chain(T result, T derivative) const {
+		Dual chained(result);
+		for (std::size_t i = 0; i < N; ++i) {
+			chained.tangents[i] = derivative * tangents[i];
+		}
+		return chained;
+	}
+
+	/// The chain rule for a function of two numbers, given its partial
+	/// derivatives with respect to each.
+	static Dual Chain(T result, T dx, const Dual& x, T dy, const Dual& y) {
+		Dual chained(result);
+		for (std::size_t i = 0; i < N; ++i) {
+			chained.tangents[i] = dx * x.tangents[i] + dy * y.tangents[i];
+		}
+		return chained;
+	}
+
+private:
+	T value;
+	T tangents[N];
+};
+
+
+namespace detail {
+	namespace chain {
+		template <class T, std::size_t N>
+		struct Enabled<Dual<T, N>> : std::true_type {};
+	}
+}
+
+/// Prints e.g. "3 + [1, 0]ε".
+template <class T, std::size_t N>
+std::ostream& operator <<(std::ostream& stream, const Dual<T, N>& x) {
+	stream << x.Value() << " + [";
+	for (std::size_t i = 0; i < N; ++i) {
+		stream << (i == 0 ? "" : ", ") << x.Tangent(i);
+	}
+	return stream << "]\xce\xb5";
+}
+
+
+/// An independent variable for differentiation, as a quantity with the
+/// dimensions of \a x whose derivative is tracked in the tangent with the
+/// given index.
+template <std::size_t N = 1, class T = double,
+	  BASE_QUANTITIES_DECLARATION, int Root, class U, class F>
+Quantity<BASE_QUANTITIES, Dual<T, N>, F, Root>
+Variable(const Quantity<BASE_QUANTITIES, U, F, Root>& x, std::size_t index = 0) {
+	return Quantity<BASE_QUANTITIES, Dual<T, N>, F, Root>(
+		Dual<T, N>::Variable(T(x.Value()), index)
+	);
+}
+
+/// The value of a quantity computed with dual numbers.
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, std::size_t N, class F>
+Quantity<BASE_QUANTITIES, T, F, Root>
+ValueOf(const Quantity<BASE_QUANTITIES, Dual<T, N>, F, Root>& y) {
+	return Quantity<BASE_QUANTITIES, T, F, Root>(y.Value().Value());
+}
+
+/// The derivative of \a y with respect to the variable \a x, which has the
+/// dimensions of y / x.  \a x must be an independent variable, as made by
+/// Variable().
+template <BASE_QUANTITIES_DECLARATION_1, class T, std::size_t N, class F1, int Root1,
+	  BASE_QUANTITIES_DECLARATION_2, class F2, int Root2>
+NORMALIZED_QUANTITY(T, detail::DefaultFormat, Root1 * Root2, BASE_QUANTITIES_ROOT_OP(-))
+Derivative(const Quantity<BASE_QUANTITIES_1, Dual<T, N>, F1, Root1>& y,
+	   const Quantity<BASE_QUANTITIES_2, Dual<T, N>, F2, Root2>& x)
+{
+	// The tangent that x was seeded in is its only nonzero one.
+	std::size_t i = 0;
+	while (i + 1 < N && x.Value().Tangent(i) == 0) {
+		++i;
+	}
+	return NORMALIZED_QUANTITY(T, detail::DefaultFormat, Root1 * Root2,
+				   BASE_QUANTITIES_ROOT_OP(-))
+	(
+		y.Value().Tangent(i) / x.Value().Tangent(i)
+	);
+}
+
+#endif // BTUL_DUAL_H
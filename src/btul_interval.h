@@ -0,0 +1,540 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_INTERVAL_H
+#define BTUL_INTERVAL_H
+
+#include <btul.h>
+#include <btul_span.h>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+
+// Interval arithmetic without rounding-mode switches.  Every operation is
+// evaluated in the default round-to-nearest mode, and the bounds are then
+// pushed outward to the neighbouring representable values with a branch-free
+// step (Rump, Zimmermann, Boldo & Melquiond, "Computing predecessor and
+// successor in rounding to nearest", 2009).  The result is at most one ulp
+// wider per operation than with directed rounding (more for bounds within a
+// few orders of magnitude of the underflow threshold), but never requires a
+// change of the floating point environment, so loops over intervals stay in
+// the pipeline and vectorize.
+//
+// The bounds are only guaranteed under strict IEEE evaluation, i.e. not with
+// -ffast-math.
+
+namespace detail {
+	namespace interval {
+		template <class T>
+		constexpr T phi() {
+			return std::numeric_limits<T>::epsilon() / 2 *
+			       (1 + std::numeric_limits<T>::epsilon());
+		}
+
+		/// At least one ulp of \a x.  The published step adds the smallest
+		/// subnormal to cover the underflow range; flooring the step at the
+		/// smallest normal instead is looser for tiny values but keeps
+		/// subnormal operands, and their microcode assists, out of the
+		/// common case.
+		template <class T>
+		inline T step(T x) {
+			T scaled = phi<T>() * std::fabs(x);
+			return scaled < std::numeric_limits<T>::min() ?
+			       std::numeric_limits<T>::min() :
+			       scaled;
+		}
+
+		/// A value no larger than the predecessor of \a x.
+		template <class T>
+		inline T down(T x) {
+			T next = x - step(x);
+			// Overflow to +inf happens only when the exact value is
+			// above the largest finite number.
+			return x == std::numeric_limits<T>::infinity() ?
+			       std::numeric_limits<T>::max() :
+			       next;
+		}
+
+		/// A value no smaller than the successor of \a x.
+		template <class T>
+		inline T up(T x) {
+			T next = x + step(x);
+			return x == -std::numeric_limits<T>::infinity() ?
+			       std::numeric_limits<T>::lowest() :
+			       next;
+		}
+
+		// These return y if x is NaN, and compile to minpd and maxpd.
+
+		template <class T>
+		inline T min(T x, T y) {
+			return x < y ? x : y;
+		}
+
+		template <class T>
+		inline T max(T x, T y) {
+			return x > y ? x : y;
+		}
+
+		/// Bounds of x^n for x >= 0.
+		template <class T>
+		inline T powDown(T x, int n) {
+			T result = 1;
+			for (int i = 0; i < n; ++i) {
+				result = down(result * x);
+			}
+			return n > 0 ? max(result, T(0)) : result;
+		}
+
+		template <class T>
+		inline T powUp(T x, int n) {
+			T result = 1;
+			for (int i = 0; i < n; ++i) {
+				result = up(result * x);
+			}
+			return result;
+		}
+
+		/// An estimate of the N-th root of x > 0.  pow with the inexact
+		/// exponent 1/N can be off by hundreds of ulps, so its result is
+		/// polished with a Newton step, unless that would overflow.
+		template <int N, class T>
+		inline T newtonRoot(T x) {
+			T y = std::pow(x, T(1) / N);
+			T correction = (std::pow(y, N) - x) / (N * std::pow(y, N - 1));
+			return std::isfinite(correction) ? y - correction : y;
+		}
+
+		// step() is loose for powers near the underflow range, so roots
+		// of tiny numbers are taken after scaling by an exact power of two.
+		template <class T>
+		inline bool tiny(T x) {
+			return x < std::ldexp(T(1), -std::numeric_limits<T>::max_exponent / 2);
+		}
+
+		template <int N, class T>
+		constexpr int rootScale() {
+			return std::numeric_limits<T>::max_exponent / N;
+		}
+
+		/// Bounds of the N-th root of x >= 0, found by stepping outward
+		/// from the estimate until its N-th power bounds x.
+		template <int N, class T>
+		inline T rootDown(T x) {
+			if (x == 0 || x == std::numeric_limits<T>::infinity()) {
+				return x;
+			}
+			if (tiny(x)) {
+				return std::ldexp(rootDown<N>(std::ldexp(x, N * rootScale<N, T>())),
+						  -rootScale<N, T>());
+			}
+			T y = newtonRoot<N>(x);
+			while (powUp(y, N) > x) {
+				y = down(y);
+			}
+			return max(y, T(0));
+		}
+
+		template <int N, class T>
+		inline T rootUp(T x) {
+			if (x == 0 || x == std::numeric_limits<T>::infinity()) {
+				return x;
+			}
+			if (tiny(x)) {
+				return std::ldexp(rootUp<N>(std::ldexp(x, N * rootScale<N, T>())),
+						  -rootScale<N, T>());
+			}
+			T y = newtonRoot<N>(x);
+			while (powDown(y, N) < x) {
+				y = up(y);
+			}
+			return y;
+		}
+
+		/// Bounds of a value of another arithmetic type, which may not be
+		/// representable in T.  Comparisons are made in long double, which
+		/// holds every value of the built-in types exactly.
+		template <class T, class U>
+		inline T lowerOf(U x) {
+			T result = T(x);
+			return static_cast<long double>(result) > static_cast<long double>(x) ?
+			       std::nextafter(result, -std::numeric_limits<T>::infinity()) :
+			       result;
+		}
+
+		template <class T, class U>
+		inline T upperOf(U x) {
+			T result = T(x);
+			return static_cast<long double>(result) < static_cast<long double>(x) ?
+			       std::nextafter(result, std::numeric_limits<T>::infinity()) :
+			       result;
+		}
+	}
+}
+
+
+/// A closed interval [Lower(), Upper()] that is guaranteed to contain the
+/// exact result of the computation that produced it.  Interval is a drop-in
+/// Number type for Quantity, so bounds on derived quantities come out of the
+/// same expressions used with plain numbers:
+///
+/// \code
+/// typedef Quantity<1, 1, -2, 0, 0, 0, 0, Interval<double>> BoundedForce;
+/// BoundedForce f = Interval<double>(9.99, 10.01) * kg * 9.81_m / s.p2();
+/// \endcode
+///
+/// Ordering comparisons are certain: x < y holds only if every value of x is
+/// less than every value of y, so both x < y and x >= y may be false.  x == y
+/// compares the bounds.  Division by an interval containing zero gives the
+/// whole real line.
+template <class T = double>
+class Interval {
+	static_assert(std::is_floating_point<T>::value,
+		      "Interval bounds must be floating point");
+
+public:
+	constexpr Interval()
+		: lower(0), upper(0)
+	{}
+
+	constexpr Interval(T value)
+		: lower(value), upper(value)
+	{}
+
+	/// Converts a number of another type, widening the interval if it is
+	/// not representable in T.
+	template <class U, class = typename std::enable_if<
+			std::is_arithmetic<U>::value && !std::is_same<U, T>::value
+		 >::type>
+	Interval(U value)
+		: lower(detail::interval::lowerOf<T>(value)),
+		  upper(detail::interval::upperOf<T>(value))
+	{}
+
+	constexpr Interval(T lower, T upper)
+		: lower(lower), upper(upper)
+	{}
+
+	constexpr T Lower() const {
+		return lower;
+	}
+
+	constexpr T Upper() const {
+		return upper;
+	}
+
+	/// Not guaranteed to be exact.
+	constexpr T Midpoint() const {
+		return lower / 2 + upper / 2;
+	}
+
+	/// Not guaranteed to be exact.
+	constexpr T Width() const {
+		return upper - lower;
+	}
+
+	constexpr bool Contains(T value) const {
+		return (lower <= value) & (value <= upper);
+	}
+
+	Interval& operator +=(const Interval& other) {
+		return *this = *this + other;
+	}
+
+	Interval& operator -=(const Interval& other) {
+		return *this = *this - other;
+	}
+
+	Interval& operator *=(const Interval& other) {
+		return *this = *this * other;
+	}
+
+	Interval& operator /=(const Interval& other) {
+		return *this = *this / other;
+	}
+
+	Interval& operator ++() {
+		return *this += Interval(1);
+	}
+
+	Interval& operator --() {
+		return *this -= Interval(1);
+	}
+
+	Interval operator ++(int) {
+		Interval result = *this;
+		++*this;
+		return result;
+	}
+
+	Interval operator --(int) {
+		Interval result = *this;
+		--*this;
+		return result;
+	}
+
+private:
+	T lower;
+	T upper;
+};
+
+
+template <class T>
+inline Interval<T> operator +(const Interval<T>& x, const Interval<T>& y) {
+	return Interval<T>(detail::interval::down(x.Lower() + y.Lower()),
+			   detail::interval::up(x.Upper() + y.Upper()));
+}
+
+template <class T>
+inline Interval<T> operator -(const Interval<T>& x, const Interval<T>& y) {
+	return Interval<T>(detail::interval::down(x.Lower() - y.Upper()),
+			   detail::interval::up(x.Upper() - y.Lower()));
+}
+
+template <class T>
+inline Interval<T> operator *(const Interval<T>& x, const Interval<T>& y) {
+	using detail::interval::min;
+	using detail::interval::max;
+	T ll = x.Lower() * y.Lower();
+	T lu = x.Lower() * y.Upper();
+	T ul = x.Upper() * y.Lower();
+	T uu = x.Upper() * y.Upper();
+	// A NaN product can only be zero times infinity, in which case one of
+	// the operands has a bound of zero, so zero is in the result.  min and
+	// max skip NaNs, as long as the running value isn't NaN to start with.
+	T first = ll == ll ? ll : T(0);
+	T lower = min(uu, min(ul, min(lu, first)));
+	T upper = max(uu, max(ul, max(lu, first)));
+	return Interval<T>(detail::interval::down(lower), detail::interval::up(upper));
+}
+
+template <class T>
+inline Interval<T> operator /(const Interval<T>& x, const Interval<T>& y) {
+	using detail::interval::min;
+	using detail::interval::max;
+	T ll = x.Lower() / y.Lower();
+	T lu = x.Lower() / y.Upper();
+	T ul = x.Upper() / y.Lower();
+	T uu = x.Upper() / y.Upper();
+	bool finite = (y.Lower() > 0) | (y.Upper() < 0);
+	return Interval<T>(finite ? detail::interval::down(min(min(ll, lu), min(ul, uu))) :
+				    -std::numeric_limits<T>::infinity(),
+			   finite ? detail::interval::up(max(max(ll, lu), max(ul, uu))) :
+				    std::numeric_limits<T>::infinity());
+}
+
+// Mixed arithmetic with plain numbers, which are converted to (possibly
+// degenerate) intervals first.
+
+#define DECLARE_MIXED_INTERVAL_OPERATOR(OP)					\
+template <class T, class U>							\
+inline typename std::enable_if<std::is_arithmetic<U>::value, Interval<T>>::type	\
+operator OP(const Interval<T>& x, const U& y) {					\
+	return x OP Interval<T>(y);						\
+}										\
+										\
+template <class T, class U>							\
+inline typename std::enable_if<std::is_arithmetic<U>::value, Interval<T>>::type	\
+operator OP(const U& x, const Interval<T>& y) {					\
+	return Interval<T>(x) OP y;						\
+}
+
+DECLARE_MIXED_INTERVAL_OPERATOR(+)
+DECLARE_MIXED_INTERVAL_OPERATOR(-)
+DECLARE_MIXED_INTERVAL_OPERATOR(*)
+DECLARE_MIXED_INTERVAL_OPERATOR(/)
+
+#undef DECLARE_MIXED_INTERVAL_OPERATOR
+
+template <class T>
+constexpr Interval<T> operator +(const Interval<T>& x) {
+	return x;
+}
+
+template <class T>
+constexpr Interval<T> operator -(const Interval<T>& x) {
+	return Interval<T>(-x.Upper(), -x.Lower());
+}
+
+template <class T>
+constexpr bool operator ==(const Interval<T>& x, const Interval<T>& y) {
+	return (x.Lower() == y.Lower()) & (x.Upper() == y.Upper());
+}
+
+template <class T>
+constexpr bool operator !=(const Interval<T>& x, const Interval<T>& y) {
+	return !(x == y);
+}
+
+template <class T>
+constexpr bool operator <(const Interval<T>& x, const Interval<T>& y) {
+	return x.Upper() < y.Lower();
+}
+
+template <class T>
+constexpr bool operator <=(const Interval<T>& x, const Interval<T>& y) {
+	return x.Upper() <= y.Lower();
+}
+
+template <class T>
+constexpr bool operator >(const Interval<T>& x, const Interval<T>& y) {
+	return y < x;
+}
+
+template <class T>
+constexpr bool operator >=(const Interval<T>& x, const Interval<T>& y) {
+	return y <= x;
+}
+
+template <class T>
+std::ostream& operator <<(std::ostream& stream, const Interval<T>& x) {
+	return stream << '[' << x.Lower() << ", " << x.Upper() << ']';
+}
+
+
+// Math functions, found by argument-dependent lookup from the Quantity
+// overloads in btul_math.h and from the p##N() and n##N() powers.  fmod is
+// not provided, since it is discontinuous.
+
+template <class T>
+Interval<T> pow(const Interval<T>& x, int n) {
+	using namespace detail::interval;
+	if (n < 0) {
+		return Interval<T>(1) / pow(x, -n);
+	}
+	if (n % 2 == 0) {
+		// Even powers are decreasing below zero.
+		T lower = max(max(-x.Upper(), x.Lower()), T(0));
+		T upper = max(-x.Lower(), x.Upper());
+		return Interval<T>(powDown(lower, n), powUp(upper, n));
+	}
+	// Odd powers are increasing everywhere.
+	return Interval<T>(x.Lower() < 0 ? -powUp(-x.Lower(), n) : powDown(x.Lower(), n),
+			   x.Upper() < 0 ? -powDown(-x.Upper(), n) : powUp(x.Upper(), n));
+}
+
+template <class T>
+Interval<T> abs(const Interval<T>& x) {
+	using namespace detail::interval;
+	return Interval<T>(max(max(-x.Upper(), x.Lower()), T(0)),
+			   max(-x.Lower(), x.Upper()));
+}
+
+/// The square root of the non-negative part of \a x.
+template <class T>
+Interval<T> sqrt(const Interval<T>& x) {
+	using namespace detail::interval;
+	return Interval<T>(max(down(std::sqrt(max(x.Lower(), T(0)))), T(0)),
+			   up(std::sqrt(x.Upper())));
+}
+
+/// Odd roots are taken of the whole interval, even roots of its non-negative
+/// part.
+template <int N, class T>
+Interval<T> root(const Interval<T>& x) {
+	using namespace detail::interval;
+	if (N % 2 == 0) {
+		return Interval<T>(rootDown<N>(max(x.Lower(), T(0))), rootUp<N>(x.Upper()));
+	}
+	return Interval<T>(x.Lower() < 0 ? -rootUp<N>(-x.Lower()) : rootDown<N>(x.Lower()),
+			   x.Upper() < 0 ? -rootDown<N>(-x.Upper()) : rootUp<N>(x.Upper()));
+}
+
+template <class T>
+Interval<T> cbrt(const Interval<T>& x) {
+	return root<3>(x);
+}
+
+/// Computed as sqrt(x^2 + y^2), so unlike std::hypot it overflows when the
+/// squares do.
+template <class T>
+Interval<T> hypot(const Interval<T>& x, const Interval<T>& y) {
+	return sqrt(pow(x, 2) + pow(y, 2));
+}
+
+/// Bounds x * y + z, although unlike std::fma the product is rounded.
+template <class T>
+Interval<T> fma(const Interval<T>& x, const Interval<T>& y, const Interval<T>& z) {
+	return x * y + z;
+}
+
+#define DECLARE_MONOTONIC_INTERVAL_FUNCTION(NAME)			\
+template <class T>							\
+Interval<T> NAME(const Interval<T>& x) {				\
+	return Interval<T>(std::NAME(x.Lower()), std::NAME(x.Upper()));	\
+}
+
+DECLARE_MONOTONIC_INTERVAL_FUNCTION(floor)
+DECLARE_MONOTONIC_INTERVAL_FUNCTION(ceil)
+DECLARE_MONOTONIC_INTERVAL_FUNCTION(round)
+
+#undef DECLARE_MONOTONIC_INTERVAL_FUNCTION
+
+template <class T>
+Interval<T> fmin(const Interval<T>& x, const Interval<T>& y) {
+	return Interval<T>(std::fmin(x.Lower(), y.Lower()), std::fmin(x.Upper(), y.Upper()));
+}
+
+template <class T>
+Interval<T> fmax(const Interval<T>& x, const Interval<T>& y) {
+	return Interval<T>(std::fmax(x.Lower(), y.Lower()), std::fmax(x.Upper(), y.Upper()));
+}
+
+
+namespace detail {
+	namespace interval {
+		template <class T>
+		struct IsInterval : std::false_type {};
+
+		template <class T>
+		struct IsInterval<Interval<T>> : std::true_type {};
+	}
+}
+
+// Batch arithmetic over spans of interval-valued quantities, out[i] = x[i] OP
+// y[i] for the first x.size() elements.  Only spans whose output holds
+// intervals are accepted, so these never capture calls meant for other
+// quantities.
+
+#define DECLARE_INTERVAL_SPAN_OPERATION(NAME, OP)				\
+template <class Q1, class Q2, class R>						\
+typename std::enable_if<							\
+	detail::interval::IsInterval<typename R::type>::value			\
+>::type										\
+NAME(QuantitySpan<Q1> x, QuantitySpan<Q2> y, QuantitySpan<R> out) {		\
+	for (std::size_t i = 0; i < x.size(); ++i) {				\
+		out[i] = x[i] OP y[i];						\
+	}									\
+}
+
+DECLARE_INTERVAL_SPAN_OPERATION(Add, +)
+DECLARE_INTERVAL_SPAN_OPERATION(Subtract, -)
+DECLARE_INTERVAL_SPAN_OPERATION(Multiply, *)
+DECLARE_INTERVAL_SPAN_OPERATION(Divide, /)
+
+#undef DECLARE_INTERVAL_SPAN_OPERATION
+
+#endif // BTUL_INTERVAL_H
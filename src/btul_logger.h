@@ -0,0 +1,264 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_LOGGER_H
+#define BTUL_LOGGER_H
+
+#include <btul.h>
+#include <btul_queue.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// Logging quantities without formatting them on the logging thread.  Log
+// copies the raw Number and a pointer to the function that formats its
+// type, which is fixed at compile time, into a lock-free buffer of the
+// calling thread's own; the records are formatted, as operator<< would,
+// and written out later by a background thread or by Drain:
+//
+//	QuantityLogger log(std::clog);
+//	log.Log("speed", v);			// A few nanoseconds.
+//
+// Each thread's records come out in the order they were logged, but records
+// from different threads are interleaved a buffer at a time.  If a thread's
+// buffer is full, Log drops the record and returns false.
+
+namespace detail {
+	namespace logger {
+		/// A record waiting to be formatted.  \a render formats \a value,
+		/// the bytes of a quantity, as the quantity's type would.
+		struct Record {
+			const char* label;
+			void (*render)(std::ostream& stream, const unsigned char* value);
+			alignas(16) unsigned char value[16];
+		};
+
+		template <class Q>
+		void render(std::ostream& stream, const unsigned char* value) {
+			Q quantity;
+			std::memcpy(&quantity, value, sizeof(Q));
+			stream << quantity;
+		}
+
+		/// The records of one thread.
+		struct Buffer {
+			static constexpr std::size_t CAPACITY = 8192;
+
+			// The queue keeps its indices on separate cache lines,
+			// but new only aligns to fundamental types before C++17,
+			// so buffers align themselves, keeping the address that
+			// new returned just before the buffer.
+			static void* operator new(std::size_t size) {
+				char* raw = static_cast<char*>(::operator new(size + CACHE_LINE_SIZE));
+				std::size_t misalignment = reinterpret_cast<std::uintptr_t>(raw) % CACHE_LINE_SIZE;
+				char* aligned = raw + CACHE_LINE_SIZE - misalignment;
+				std::memcpy(aligned - sizeof(raw), &raw, sizeof(raw));
+				return aligned;
+			}
+
+			static void operator delete(void* aligned) {
+				char* raw;
+				std::memcpy(&raw, static_cast<char*>(aligned) - sizeof(raw), sizeof(raw));
+				::operator delete(raw);
+			}
+
+			SpscQuantityQueue<Record, CAPACITY> records;
+			std::atomic<std::uint64_t> dropped{0};
+		};
+
+		/// A different number for every logger, so that a thread's
+		/// cached buffer is never mistaken for one of a later logger at
+		/// the same address.
+		inline std::uint64_t nextLoggerId() {
+			static std::atomic<std::uint64_t> next(1);
+			return next.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+/// Logs quantities from any number of threads, and formats them elsewhere.
+/// See the top of this file.
+class QuantityLogger {
+public:
+	/// Writes lines of a record's label, a space and its quantity to
+	/// \a stream: from a background thread, if \a background, and
+	/// otherwise only when Drain is called.
+	explicit QuantityLogger(std::ostream& stream, bool background = true)
+		: stream(stream), id(detail::logger::nextLoggerId())
+	{
+		if (background) {
+			worker = std::thread([this] {
+				Run();
+			});
+		}
+	}
+
+	QuantityLogger(const QuantityLogger&) = delete;
+	QuantityLogger& operator =(const QuantityLogger&) = delete;
+
+	/// Stops the background thread, and writes out every record logged
+	/// before the destructor was called.
+	~QuantityLogger() {
+		if (worker.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				stopping = true;
+			}
+			wake.notify_one();
+			worker.join();
+		}
+		Drain();
+	}
+
+	/// Queues \a value under \a label, which must be a string that
+	/// outlives the logger, such as a literal, or null.  Returns false,
+	/// and drops the record, if this thread's buffer is full.
+	template <class Q>
+	bool Log(const char* label, const Q& value) {
+		static_assert(std::is_trivially_copyable<Q>::value && sizeof(Q) <= 16,
+			      "Only small, trivially copyable values can be logged");
+		detail::logger::Record record;
+		record.label = label;
+		record.render = &detail::logger::render<Q>;
+		std::memcpy(record.value, &value, sizeof(Q));
+
+		detail::logger::Buffer& buffer = ThreadBuffer();
+		if (!buffer.records.TryPush(record)) {
+			buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1,
+					     std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	/// Formats and writes out every record queued so far, and returns
+	/// how many there were.  Safe to call alongside the background
+	/// thread.
+	std::size_t Drain() {
+		std::lock_guard<std::mutex> lock(drainMutex);
+		std::vector<detail::logger::Buffer*> current;
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+			for (const auto& buffer : buffers) {
+				current.push_back(buffer.get());
+			}
+		}
+
+		std::size_t written = 0;
+		detail::logger::Record records[256];
+		for (detail::logger::Buffer* buffer : current) {
+			std::size_t n;
+			while ((n = buffer->records.PopBatch(QuantitySpan<detail::logger::Record>(records))) != 0) {
+				for (std::size_t i = 0; i < n; ++i) {
+					if (records[i].label) {
+						stream << records[i].label << ' ';
+					}
+					records[i].render(stream, records[i].value);
+					stream << '\n';
+				}
+				written += n;
+			}
+		}
+		return written;
+	}
+
+	/// The number of records dropped because a buffer was full.
+	std::uint64_t Dropped() const {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		std::uint64_t dropped = 0;
+		for (const auto& buffer : buffers) {
+			dropped += buffer->dropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+private:
+	/// The calling thread's buffer, made the first time the thread logs.
+	/// The buffer of the last logger a thread used is cached.
+	detail::logger::Buffer& ThreadBuffer() {
+		struct Cache {
+			std::uint64_t id;
+			detail::logger::Buffer* buffer;
+		};
+		thread_local Cache cache = {0, nullptr};
+		if (cache.id != id) {
+			cache.buffer = FindBuffer();
+			cache.id = id;
+		}
+		return *cache.buffer;
+	}
+
+	detail::logger::Buffer* FindBuffer() {
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		std::thread::id self = std::this_thread::get_id();
+		for (std::size_t i = 0; i < owners.size(); ++i) {
+			if (owners[i] == self) {
+				return buffers[i].get();
+			}
+		}
+		buffers.emplace_back(new detail::logger::Buffer);
+		owners.push_back(self);
+		return buffers.back().get();
+	}
+
+	void Run() {
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		while (!stopping) {
+			lock.unlock();
+			std::size_t written = Drain();
+			if (written != 0) {
+				stream.flush();
+			}
+			lock.lock();
+			if (written == 0) {
+				wake.wait_for(lock, std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	std::ostream& stream;
+	const std::uint64_t id;
+
+	mutable std::mutex buffersMutex;
+	std::vector<std::unique_ptr<detail::logger::Buffer>> buffers;
+	std::vector<std::thread::id> owners;
+
+	std::mutex drainMutex;
+
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	bool stopping = false;
+	std::thread worker;
+};
+
+#endif // BTUL_LOGGER_H
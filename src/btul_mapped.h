@@ -0,0 +1,159 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_MAPPED_H
+#define BTUL_MAPPED_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/// How a mapping will be accessed, for the kernel's readahead.
+enum class AccessPattern {
+	Normal,
+	/// Read ahead aggressively and drop pages soon after they are read.
+	Sequential,
+	/// No readahead.
+	Random
+};
+
+namespace detail {
+	namespace mapped {
+		inline int advice(AccessPattern pattern) {
+			switch (pattern) {
+				case AccessPattern::Sequential: return MADV_SEQUENTIAL;
+				case AccessPattern::Random: return MADV_RANDOM;
+				default: return MADV_NORMAL;
+			}
+		}
+
+		inline std::system_error systemError(const std::string& what) {
+			return std::system_error(errno, std::generic_category(), what);
+		}
+	}
+}
+
+/// A whole file mapped read-only into memory.  Pages are read from disk
+/// only when they are first touched.  Failures are reported with
+/// std::system_error.  POSIX only.
+class MappedFile {
+public:
+	/// Maps the file at \a path.  \a hugePages asks for the mapping to be
+	/// backed by transparent huge pages where the kernel and file system
+	/// support it, and is otherwise ignored.
+	explicit MappedFile(const std::string& path,
+			    AccessPattern pattern = AccessPattern::Normal,
+			    bool hugePages = false)
+		: data(nullptr), size(0)
+	{
+		int descriptor = ::open(path.c_str(), O_RDONLY);
+		if (descriptor < 0) {
+			throw detail::mapped::systemError("Cannot open " + path);
+		}
+		struct stat status;
+		if (::fstat(descriptor, &status) != 0) {
+			::close(descriptor);
+			throw detail::mapped::systemError("Cannot stat " + path);
+		}
+		size = std::size_t(status.st_size);
+		if (size == 0) {
+			// mmap rejects empty mappings.
+			::close(descriptor);
+			return;
+		}
+		void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+		::close(descriptor);
+		if (mapping == MAP_FAILED) {
+			throw detail::mapped::systemError("Cannot map " + path);
+		}
+		data = static_cast<const char*>(mapping);
+
+		Advise(0, size, pattern);
+#ifdef MADV_HUGEPAGE
+		if (hugePages) {
+			::madvise(mapping, size, MADV_HUGEPAGE);
+		}
+#else
+		(void)hugePages;
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator =(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other)
+		: data(other.data), size(other.size)
+	{
+		other.data = nullptr;
+		other.size = 0;
+	}
+
+	~MappedFile() {
+		if (data) {
+			::munmap(const_cast<char*>(data), size);
+		}
+	}
+
+	const char* Data() const {
+		return data;
+	}
+
+	std::size_t Size() const {
+		return size;
+	}
+
+	/// Changes the readahead for the \a length bytes at \a offset.
+	void Advise(std::size_t offset, std::size_t length, AccessPattern pattern) const {
+		Madvise(offset, length, detail::mapped::advice(pattern));
+	}
+
+	/// Starts reading the \a length bytes at \a offset in the background.
+	void Prefetch(std::size_t offset, std::size_t length) const {
+		Madvise(offset, length, MADV_WILLNEED);
+	}
+
+private:
+	// madvise needs a page-aligned start, so the range is widened to the
+	// page boundary below it.  The advice is only a hint, so failures
+	// are ignored.
+	void Madvise(std::size_t offset, std::size_t length, int advice) const {
+		if (!data) {
+			return;
+		}
+		std::size_t page = std::size_t(::sysconf(_SC_PAGESIZE));
+		std::size_t start = offset - offset % page;
+		::madvise(const_cast<char*>(data) + start, offset + length - start, advice);
+	}
+
+	const char* data;
+	std::size_t size;
+};
+
+#endif // BTUL_MAPPED_H
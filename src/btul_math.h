@@ -0,0 +1,495 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_MATH_H
+#define BTUL_MATH_H
+
+#include <btul.h>
+#include <btul_span.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#if defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+	template <class Q1, class Q2>
+	constexpr bool sameDimensions() {
+		return Q1::length == Q2::length &&
+		       Q1::mass == Q2::mass &&
+		       Q1::time == Q2::time &&
+		       Q1::current == Q2::current &&
+		       Q1::temperature == Q2::temperature &&
+		       Q1::amount == Q2::amount &&
+		       Q1::luminosity == Q2::luminosity &&
+		       Q1::root == Q2::root;
+	}
+
+	// The standard math functions are called unqualified from inside this
+	// namespace, so that they are found by argument-dependent lookup for
+	// custom Number types, and in std for the built-in ones.
+	namespace math {
+		using std::abs;
+		using std::cbrt;
+		using std::ceil;
+		using std::floor;
+		using std::fma;
+		using std::fmax;
+		using std::fmin;
+		using std::fmod;
+		using std::hypot;
+		using std::pow;
+		using std::round;
+		using std::sqrt;
+
+		#define DECLARE_UNARY_MATH_CALL(NAME)				\
+		template <class T>						\
+		auto NAME##Of(const T& x) -> decltype(NAME(x)) {		\
+			return NAME(x);						\
+		}
+
+		#define DECLARE_BINARY_MATH_CALL(NAME)				\
+		template <class T1, class T2>					\
+		auto NAME##Of(const T1& x, const T2& y) -> decltype(NAME(x, y)) {\
+			return NAME(x, y);					\
+		}
+
+		DECLARE_UNARY_MATH_CALL(abs)
+		DECLARE_UNARY_MATH_CALL(cbrt)
+		DECLARE_UNARY_MATH_CALL(ceil)
+		DECLARE_UNARY_MATH_CALL(floor)
+		DECLARE_UNARY_MATH_CALL(round)
+		DECLARE_UNARY_MATH_CALL(sqrt)
+		DECLARE_BINARY_MATH_CALL(fmax)
+		DECLARE_BINARY_MATH_CALL(fmin)
+		DECLARE_BINARY_MATH_CALL(fmod)
+		DECLARE_BINARY_MATH_CALL(hypot)
+		DECLARE_BINARY_MATH_CALL(pow)
+
+		#undef DECLARE_UNARY_MATH_CALL
+		#undef DECLARE_BINARY_MATH_CALL
+
+		// Odd roots of negative numbers are real, as with cbrt.  Custom
+		// Number types can provide a better root<N> of their own.
+		template <int N, class T,
+			  class R = decltype(pow(std::declval<T>(), std::declval<T>()))>
+		R root(const T& x) {
+			return N == 2 ? R(sqrt(x)) :
+			       N == 3 ? R(cbrt(x)) :
+			       N % 2 == 1 && x < T(0) ? -R(pow(-x, R(1) / N)) :
+			       R(pow(x, R(1) / N));
+		}
+
+		template <int N, class T>
+		auto rootOf(const T& x) -> decltype(root<N>(x)) {
+			return root<N>(x);
+		}
+
+		template <class T1, class T2, class T3>
+		auto fmaOf(const T1& x, const T2& y, const T3& z) -> decltype(fma(x, y, z)) {
+			return fma(x, y, z);
+		}
+	}
+
+	// Vectorized kernels over spans of double-valued quantities.  Each kernel
+	// processes as much of its input as it can and returns how many elements
+	// it handled; the caller finishes the tail (or everything, for number
+	// types and instruction sets without a kernel) with the scalar function.
+	namespace simd {
+		struct Scalar {};
+
+		template <class Q>
+		using IsDouble = std::is_same<typename std::remove_cv<Q>::type::type, double>;
+
+		template <class Q>
+		typename std::enable_if<IsDouble<Q>::value && !std::is_const<Q>::value, double*>::type
+		raw(QuantitySpan<Q> span) {
+			static_assert(sizeof(Q) == sizeof(double), "Quantity must wrap a bare double");
+			return reinterpret_cast<double*>(span.data());
+		}
+
+		template <class Q>
+		typename std::enable_if<IsDouble<Q>::value, const double*>::type
+		raw(QuantitySpan<const Q> span) {
+			static_assert(sizeof(Q) == sizeof(double), "Quantity must wrap a bare double");
+			return reinterpret_cast<const double*>(span.data());
+		}
+
+		template <class Q>
+		typename std::enable_if<!IsDouble<Q>::value, Scalar>::type
+		raw(QuantitySpan<Q>) {
+			return Scalar();
+		}
+
+		#define DECLARE_SCALAR_KERNEL(NAME)			\
+		template <class... Args>				\
+		std::size_t NAME(Args...) {				\
+			return 0;					\
+		}
+
+		DECLARE_SCALAR_KERNEL(abs)
+		DECLARE_SCALAR_KERNEL(cbrt)
+		DECLARE_SCALAR_KERNEL(ceil)
+		DECLARE_SCALAR_KERNEL(floor)
+		DECLARE_SCALAR_KERNEL(fma)
+		DECLARE_SCALAR_KERNEL(fmod)
+		DECLARE_SCALAR_KERNEL(hypot)
+		DECLARE_SCALAR_KERNEL(max)
+		DECLARE_SCALAR_KERNEL(min)
+		DECLARE_SCALAR_KERNEL(round)
+		DECLARE_SCALAR_KERNEL(sqrt)
+
+		#undef DECLARE_SCALAR_KERNEL
+
+		#define DECLARE_UNARY_KERNEL(NAME, EXPRESSION)				\
+		inline std::size_t NAME(const double* in, double* out, std::size_t n) {\
+			std::size_t i = 0;						\
+			for (; i + 2 <= n; i += 2) {					\
+				__m128d x = _mm_loadu_pd(in + i);			\
+				_mm_storeu_pd(out + i, EXPRESSION);			\
+			}								\
+			return i;							\
+		}
+
+		#define DECLARE_BINARY_KERNEL(NAME, EXPRESSION)				\
+		inline std::size_t NAME(const double* in1, const double* in2,		\
+					double* out, std::size_t n)			\
+		{									\
+			std::size_t i = 0;						\
+			for (; i + 2 <= n; i += 2) {					\
+				__m128d x = _mm_loadu_pd(in1 + i);			\
+				__m128d y = _mm_loadu_pd(in2 + i);			\
+				_mm_storeu_pd(out + i, EXPRESSION);			\
+			}								\
+			return i;							\
+		}
+
+#if defined(__SSE2__)
+		// Selects y wherever x is NaN, matching fmin and fmax, which only
+		// return NaN if both arguments are NaN.
+		inline __m128d unlessNaN(__m128d x, __m128d y, __m128d result) {
+			__m128d nan = _mm_cmpunord_pd(x, x);
+			return _mm_or_pd(_mm_and_pd(nan, y), _mm_andnot_pd(nan, result));
+		}
+
+		DECLARE_UNARY_KERNEL(sqrt, _mm_sqrt_pd(x))
+		DECLARE_UNARY_KERNEL(abs, _mm_andnot_pd(_mm_set1_pd(-0.0), x))
+		DECLARE_BINARY_KERNEL(min, unlessNaN(x, y, _mm_min_pd(y, x)))
+		DECLARE_BINARY_KERNEL(max, unlessNaN(x, y, _mm_max_pd(y, x)))
+#endif
+
+#if defined(__SSE4_1__)
+		DECLARE_UNARY_KERNEL(floor, _mm_floor_pd(x))
+		DECLARE_UNARY_KERNEL(ceil, _mm_ceil_pd(x))
+#endif
+
+#if defined(__FMA__)
+		inline std::size_t fma(const double* in1, const double* in2,
+				       const double* in3, double* out, std::size_t n)
+		{
+			std::size_t i = 0;
+			for (; i + 2 <= n; i += 2) {
+				_mm_storeu_pd(out + i, _mm_fmadd_pd(_mm_loadu_pd(in1 + i),
+								    _mm_loadu_pd(in2 + i),
+								    _mm_loadu_pd(in3 + i)));
+			}
+			return i;
+		}
+#endif
+
+		#undef DECLARE_UNARY_KERNEL
+		#undef DECLARE_BINARY_KERNEL
+	}
+}
+
+
+// Scalar overloads.  Each derives the dimensions of its result from the
+// exponents of its arguments, so e.g. the square root of an Area is a Length,
+// and the square root of a Frequency has a time exponent of -1/2.
+
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>
+NORMALIZED_QUANTITY(decltype(detail::math::sqrtOf(std::declval<T>())),
+		    detail::DefaultFormat, Root * 2, BASE_QUANTITIES)
+sqrt(const Quantity<BASE_QUANTITIES, T, F, Root>& x) {
+	return NORMALIZED_QUANTITY(decltype(detail::math::sqrtOf(x.Value())),
+				   detail::DefaultFormat, Root * 2, BASE_QUANTITIES)
+	(
+		detail::math::sqrtOf(x.Value())
+	);
+}
+
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>
+NORMALIZED_QUANTITY(decltype(detail::math::cbrtOf(std::declval<T>())),
+		    detail::DefaultFormat, Root * 3, BASE_QUANTITIES)
+cbrt(const Quantity<BASE_QUANTITIES, T, F, Root>& x) {
+	return NORMALIZED_QUANTITY(decltype(detail::math::cbrtOf(x.Value())),
+				   detail::DefaultFormat, Root * 3, BASE_QUANTITIES)
+	(
+		detail::math::cbrtOf(x.Value())
+	);
+}
+
+/// The N-th root, e.g. root<4>(x) has a quarter of the exponents of x.
+template <int N, BASE_QUANTITIES_DECLARATION, int Root, class T, class F>
+NORMALIZED_QUANTITY(decltype(detail::math::rootOf<N>(std::declval<T>())),
+		    detail::DefaultFormat, Root * N, BASE_QUANTITIES)
+root(const Quantity<BASE_QUANTITIES, T, F, Root>& x) {
+	static_assert(N > 0, "Only positive roots are supported");
+	return NORMALIZED_QUANTITY(decltype(detail::math::rootOf<N>(x.Value())),
+				   detail::DefaultFormat, Root * N, BASE_QUANTITIES)
+	(
+		detail::math::rootOf<N>(x.Value())
+	);
+}
+
+#define DECLARE_UNARY_QUANTITY_FUNCTION(NAME)					\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>		\
+Quantity<BASE_QUANTITIES, T, F, Root>						\
+NAME(const Quantity<BASE_QUANTITIES, T, F, Root>& x) {				\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(				\
+		detail::math::NAME##Of(x.Value())				\
+	);									\
+}
+
+DECLARE_UNARY_QUANTITY_FUNCTION(abs)
+DECLARE_UNARY_QUANTITY_FUNCTION(floor)
+DECLARE_UNARY_QUANTITY_FUNCTION(ceil)
+DECLARE_UNARY_QUANTITY_FUNCTION(round)
+
+#define DECLARE_BINARY_QUANTITY_FUNCTION(NAME, MATH_NAME)			\
+template <BASE_QUANTITIES_DECLARATION, int Root,				\
+	  class T1, class F1,							\
+	  class T2, class F2>							\
+Quantity<BASE_QUANTITIES,							\
+	 decltype(detail::math::MATH_NAME##Of(std::declval<T1>(),		\
+					      std::declval<T2>())),		\
+	 DefaultQuantityFormat<BASE_QUANTITIES, Root>,				\
+	 Root>									\
+NAME(const Quantity<BASE_QUANTITIES, T1, F1, Root>& x,				\
+     const Quantity<BASE_QUANTITIES, T2, F2, Root>& y)				\
+{										\
+	return Quantity<BASE_QUANTITIES,					\
+			decltype(detail::math::MATH_NAME##Of(x.Value(),		\
+							     y.Value())),	\
+			DefaultQuantityFormat<BASE_QUANTITIES, Root>,		\
+			Root>							\
+	       (								\
+			detail::math::MATH_NAME##Of(x.Value(), y.Value())	\
+	       );								\
+}
+
+DECLARE_BINARY_QUANTITY_FUNCTION(hypot, hypot)
+DECLARE_BINARY_QUANTITY_FUNCTION(fmod, fmod)
+
+// Unlike the other binary functions, min and max take two quantities of the
+// same type, which keeps them from being ambiguous with std::min and std::max
+// under a using-directive.  NaNs are ignored, as with fmin and fmax.
+
+#define DECLARE_EXTREMUM_QUANTITY_FUNCTION(NAME, MATH_NAME)			\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>		\
+Quantity<BASE_QUANTITIES, T, F, Root>						\
+NAME(const Quantity<BASE_QUANTITIES, T, F, Root>& x,				\
+     const Quantity<BASE_QUANTITIES, T, F, Root>& y)				\
+{										\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(				\
+		detail::math::MATH_NAME##Of(x.Value(), y.Value())		\
+	);									\
+}
+
+DECLARE_EXTREMUM_QUANTITY_FUNCTION(min, fmin)
+DECLARE_EXTREMUM_QUANTITY_FUNCTION(max, fmax)
+
+/// Computes x * y + z with a single rounding.  The dimension of \a z must be
+/// that of the product.
+template <BASE_QUANTITIES_DECLARATION_1, class T1, class F1, int Root1,
+	  BASE_QUANTITIES_DECLARATION_2, class T2, class F2, int Root2,
+	  BASE_QUANTITIES_DECLARATION_N(3), class T3, class F3, int Root3>
+NORMALIZED_QUANTITY(decltype(detail::math::fmaOf(std::declval<T1>(),
+						 std::declval<T2>(),
+						 std::declval<T3>())),
+		    detail::DefaultFormat,
+		    Root1 * Root2,
+		    BASE_QUANTITIES_ROOT_OP(+))
+fma(const Quantity<BASE_QUANTITIES_1, T1, F1, Root1>& x,
+    const Quantity<BASE_QUANTITIES_2, T2, F2, Root2>& y,
+    const Quantity<BASE_QUANTITIES_N(3), T3, F3, Root3>& z)
+{
+	static_assert(detail::sameDimensions<
+			decltype(x * y),
+			Quantity<BASE_QUANTITIES_N(3), T3, F3, Root3>
+		      >(),
+		      "The addend must have the dimensions of the product");
+	return NORMALIZED_QUANTITY(decltype(detail::math::fmaOf(x.Value(),
+								y.Value(),
+								z.Value())),
+				   detail::DefaultFormat,
+				   Root1 * Root2,
+				   BASE_QUANTITIES_ROOT_OP(+))
+	(
+		detail::math::fmaOf(x.Value(), y.Value(), z.Value())
+	);
+}
+
+
+// Span overloads.  These apply the scalar function to every element of the
+// input span(s), writing into \a out, which must be at least as long as the
+// input and of the dimension the scalar function returns.  Spans of
+// double-valued quantities are processed with SSE2 (and SSE4.1 or FMA, where
+// the target supports them); anything else falls back to a plain loop.
+
+#define DECLARE_UNARY_SPAN_FUNCTION(NAME)					\
+template <class Q, class R>							\
+void NAME(QuantitySpan<Q> in, QuantitySpan<R> out) {				\
+	static_assert(detail::sameDimensions<decltype(NAME(in[0])), R>(),	\
+		      "Output span has the wrong dimensions");			\
+	std::size_t i = detail::simd::NAME(detail::simd::raw(in),		\
+					   detail::simd::raw(out),		\
+					   in.size());				\
+	for (; i < in.size(); ++i) {						\
+		out[i] = R(NAME(in[i]));					\
+	}									\
+}
+
+DECLARE_UNARY_SPAN_FUNCTION(sqrt)
+DECLARE_UNARY_SPAN_FUNCTION(cbrt)
+DECLARE_UNARY_SPAN_FUNCTION(abs)
+DECLARE_UNARY_SPAN_FUNCTION(floor)
+DECLARE_UNARY_SPAN_FUNCTION(ceil)
+DECLARE_UNARY_SPAN_FUNCTION(round)
+
+#define DECLARE_BINARY_SPAN_FUNCTION(NAME)					\
+template <class Q1, class Q2, class R>						\
+void NAME(QuantitySpan<Q1> x, QuantitySpan<Q2> y, QuantitySpan<R> out) {	\
+	static_assert(detail::sameDimensions<decltype(NAME(x[0], y[0])), R>(),	\
+		      "Output span has the wrong dimensions");			\
+	std::size_t i = detail::simd::NAME(detail::simd::raw(x),		\
+					   detail::simd::raw(y),		\
+					   detail::simd::raw(out),		\
+					   x.size());				\
+	for (; i < x.size(); ++i) {						\
+		out[i] = R(NAME(x[i], y[i]));				\
+	}									\
+}
+
+DECLARE_BINARY_SPAN_FUNCTION(hypot)
+DECLARE_BINARY_SPAN_FUNCTION(fmod)
+
+#define DECLARE_EXTREMUM_SPAN_FUNCTION(NAME)					\
+template <class Q, class R>							\
+void NAME(QuantitySpan<Q> x, QuantitySpan<Q> y, QuantitySpan<R> out) {		\
+	static_assert(detail::sameDimensions<decltype(NAME(x[0], y[0])), R>(),	\
+		      "Output span has the wrong dimensions");			\
+	std::size_t i = detail::simd::NAME(detail::simd::raw(x),		\
+					   detail::simd::raw(y),		\
+					   detail::simd::raw(out),		\
+					   x.size());				\
+	for (; i < x.size(); ++i) {						\
+		out[i] = R(NAME(x[i], y[i]));					\
+	}									\
+}
+
+DECLARE_EXTREMUM_SPAN_FUNCTION(min)
+DECLARE_EXTREMUM_SPAN_FUNCTION(max)
+
+template <class Q1, class Q2, class Q3, class R>
+void fma(QuantitySpan<Q1> x, QuantitySpan<Q2> y, QuantitySpan<Q3> z, QuantitySpan<R> out) {
+	static_assert(detail::sameDimensions<decltype(fma(x[0], y[0], z[0])), R>(),
+		      "Output span has the wrong dimensions");
+	std::size_t i = detail::simd::fma(detail::simd::raw(x),
+					  detail::simd::raw(y),
+					  detail::simd::raw(z),
+					  detail::simd::raw(out),
+					  x.size());
+	for (; i < x.size(); ++i) {
+		out[i] = R(fma(x[i], y[i], z[i]));
+	}
+}
+
+
+// Array overloads, returning a new array of the results.
+
+#define DECLARE_UNARY_ARRAY_FUNCTION(NAME)					\
+template <class Q, std::size_t N>						\
+std::array<decltype(NAME(std::declval<Q>())), N>				\
+NAME(const std::array<Q, N>& in) {						\
+	std::array<decltype(NAME(std::declval<Q>())), N> out;			\
+	NAME(QuantitySpan<const Q>(in), QuantitySpan<typename decltype(out)::value_type>(out));\
+	return out;								\
+}
+
+DECLARE_UNARY_ARRAY_FUNCTION(sqrt)
+DECLARE_UNARY_ARRAY_FUNCTION(cbrt)
+DECLARE_UNARY_ARRAY_FUNCTION(abs)
+DECLARE_UNARY_ARRAY_FUNCTION(floor)
+DECLARE_UNARY_ARRAY_FUNCTION(ceil)
+DECLARE_UNARY_ARRAY_FUNCTION(round)
+
+#define DECLARE_BINARY_ARRAY_FUNCTION(NAME)					\
+template <class Q1, class Q2, std::size_t N>					\
+std::array<decltype(NAME(std::declval<Q1>(), std::declval<Q2>())), N>		\
+NAME(const std::array<Q1, N>& x, const std::array<Q2, N>& y) {			\
+	std::array<decltype(NAME(std::declval<Q1>(), std::declval<Q2>())), N> out;\
+	NAME(QuantitySpan<const Q1>(x),						\
+	     QuantitySpan<const Q2>(y),						\
+	     QuantitySpan<typename decltype(out)::value_type>(out));		\
+	return out;								\
+}
+
+DECLARE_BINARY_ARRAY_FUNCTION(hypot)
+DECLARE_BINARY_ARRAY_FUNCTION(fmod)
+
+#define DECLARE_EXTREMUM_ARRAY_FUNCTION(NAME)					\
+template <class Q, std::size_t N>						\
+std::array<Q, N> NAME(const std::array<Q, N>& x, const std::array<Q, N>& y) {	\
+	std::array<Q, N> out;							\
+	NAME(QuantitySpan<const Q>(x),						\
+	     QuantitySpan<const Q>(y),						\
+	     QuantitySpan<Q>(out));						\
+	return out;								\
+}
+
+DECLARE_EXTREMUM_ARRAY_FUNCTION(min)
+DECLARE_EXTREMUM_ARRAY_FUNCTION(max)
+
+template <class Q1, class Q2, class Q3, std::size_t N>
+std::array<decltype(fma(std::declval<Q1>(), std::declval<Q2>(), std::declval<Q3>())), N>
+fma(const std::array<Q1, N>& x, const std::array<Q2, N>& y, const std::array<Q3, N>& z) {
+	std::array<decltype(fma(std::declval<Q1>(), std::declval<Q2>(), std::declval<Q3>())), N> out;
+	fma(QuantitySpan<const Q1>(x),
+	    QuantitySpan<const Q2>(y),
+	    QuantitySpan<const Q3>(z),
+	    QuantitySpan<typename decltype(out)::value_type>(out));
+	return out;
+}
+
+#endif // BTUL_MATH_H
@@ -0,0 +1,320 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_QUANTIZED_H
+#define BTUL_QUANTIZED_H
+
+#include <btul.h>
+#include <btul_span.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Compact, lossy storage for arrays of quantities, such as archived sensor
+// readings: each value is kept as an 8 or 16 bit code, and each block of
+// codes has its own offset and scale, which are quantities of the same
+// dimensions as the values, so that value = offset + scale * code:
+//
+//	QuantizedArray<Pressure> archive(readings);	// 16 bit codes.
+//	Pressure p = archive[i];
+//	archive.Decode(first, QuantitySpan<Pressure>(window));
+//	Pressure worst = archive.MaxError();
+//
+// The offset and scale of a block span its smallest and largest value, so
+// every value is within half a step of its code, or of the Number's own
+// precision if that is coarser, and the largest error of any value is
+// measured when the array is made.  A long double array of
+// 16 bit codes takes an eighth of the memory, and of 8 bit codes a
+// sixteenth, plus two quantities per block.
+
+namespace detail {
+	namespace quantized {
+		// The SIMD kernels dequantize as many leading codes as they can,
+		// and return how many; the rest are left to the scalar loop.
+		// Both compute offset + scale * code, rounding the product, so
+		// that they agree with each other and with single accesses.
+		template <class Code, class T>
+		std::size_t dequantizeKernel(const Code*, T, T, T*, std::size_t) {
+			return 0;
+		}
+
+#if defined(__SSE2__)
+		/// Dequantizes eight codes, widened to 32 bit integers in \a low
+		/// and \a high.
+		inline void dequantize8(__m128i low, __m128i high, __m128d offset, __m128d scale,
+					double* out) {
+			__m128d values[4] = {
+				_mm_cvtepi32_pd(low),
+				_mm_cvtepi32_pd(_mm_shuffle_epi32(low, 0x4e)),
+				_mm_cvtepi32_pd(high),
+				_mm_cvtepi32_pd(_mm_shuffle_epi32(high, 0x4e)),
+			};
+			for (int j = 0; j < 4; ++j) {
+				_mm_storeu_pd(out + 2 * j, _mm_add_pd(offset, _mm_mul_pd(scale, values[j])));
+			}
+		}
+
+		inline void dequantize8(__m128i low, __m128i high, __m128 offset, __m128 scale,
+					float* out) {
+			_mm_storeu_ps(out, _mm_add_ps(offset, _mm_mul_ps(scale, _mm_cvtepi32_ps(low))));
+			_mm_storeu_ps(out + 4, _mm_add_ps(offset, _mm_mul_ps(scale, _mm_cvtepi32_ps(high))));
+		}
+
+		inline __m128d broadcast(double x) {
+			return _mm_set1_pd(x);
+		}
+
+		inline __m128 broadcast(float x) {
+			return _mm_set1_ps(x);
+		}
+
+		template <class T>
+		std::size_t dequantizeKernel(const std::uint16_t* codes, T offset, T scale, T* out,
+					     std::size_t n) {
+			auto offsets = broadcast(offset);
+			auto scales = broadcast(scale);
+			__m128i zero = _mm_setzero_si128();
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+				dequantize8(_mm_unpacklo_epi16(c, zero), _mm_unpackhi_epi16(c, zero),
+					    offsets, scales, out + i);
+			}
+			return i;
+		}
+
+		template <class T>
+		std::size_t dequantizeKernel(const std::uint8_t* codes, T offset, T scale, T* out,
+					     std::size_t n) {
+			auto offsets = broadcast(offset);
+			auto scales = broadcast(scale);
+			__m128i zero = _mm_setzero_si128();
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m128i c = _mm_unpacklo_epi8(
+					_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + i)), zero);
+				dequantize8(_mm_unpacklo_epi16(c, zero), _mm_unpackhi_epi16(c, zero),
+					    offsets, scales, out + i);
+			}
+			return i;
+		}
+
+		// long double has no SIMD kernel.
+		inline std::size_t dequantizeKernel(const std::uint16_t*, long double, long double,
+						    long double*, std::size_t) {
+			return 0;
+		}
+
+		inline std::size_t dequantizeKernel(const std::uint8_t*, long double, long double,
+						    long double*, std::size_t) {
+			return 0;
+		}
+#endif
+
+		template <class Code, class T>
+		void dequantize(const Code* codes, T offset, T scale, T* out, std::size_t n) {
+			for (std::size_t i = dequantizeKernel(codes, offset, scale, out, n); i < n; ++i) {
+				out[i] = offset + scale * T(codes[i]);
+			}
+		}
+	}
+}
+
+/// An array of quantities stored as \a Code integers, with an offset and a
+/// scale for every \a BlockSize of them.  See the top of this file.
+template <class Q, class Code = std::uint16_t, std::size_t BlockSize = 256>
+class QuantizedArray {
+	typedef typename Q::type T;
+	static_assert(std::is_same<Code, std::uint8_t>::value || std::is_same<Code, std::uint16_t>::value,
+		      "Codes must be 8 or 16 bit unsigned integers");
+	static_assert(std::is_floating_point<T>::value, "Only floating point quantities can be quantized");
+	static_assert(sizeof(Q) == sizeof(T), "Quantity must wrap a bare Number");
+	static_assert(BlockSize > 0, "Blocks must hold at least one value");
+
+public:
+	typedef Q value_type;
+
+	/// The largest code.
+	static constexpr Code MAX_CODE = std::numeric_limits<Code>::max();
+
+	QuantizedArray() = default;
+
+	/// Quantizes \a values.  Throws a std::domain_error if any is not
+	/// finite.
+	explicit QuantizedArray(QuantitySpan<const Q> values) {
+		Assign(values);
+	}
+
+	explicit QuantizedArray(const std::vector<Q>& values)
+		: QuantizedArray(QuantitySpan<const Q>(values))
+	{}
+
+	/// Replaces the contents with \a values, quantized.  Throws a
+	/// std::domain_error if any is not finite, leaving the array as it
+	/// was.
+	void Assign(QuantitySpan<const Q> values) {
+		std::vector<Code> newCodes(values.size());
+		std::vector<Block> newBlocks((values.size() + BlockSize - 1) / BlockSize);
+		T maxError = 0;
+		const T* in = reinterpret_cast<const T*>(values.data());
+		for (std::size_t b = 0; b < newBlocks.size(); ++b) {
+			std::size_t first = b * BlockSize;
+			std::size_t size = std::min(BlockSize, values.size() - first);
+			maxError = std::max(maxError, Quantize(in + first, size, newCodes.data() + first,
+							       newBlocks[b]));
+		}
+		codes.swap(newCodes);
+		blocks.swap(newBlocks);
+		error = maxError;
+	}
+
+	std::size_t Size() const {
+		return codes.size();
+	}
+
+	bool Empty() const {
+		return codes.empty();
+	}
+
+	/// The \a i'th value, dequantized.
+	Q operator[](std::size_t i) const {
+		const Block& block = blocks[i / BlockSize];
+		return Q(block.offset + block.scale * T(codes[i]));
+	}
+
+	/// Dequantizes the values from index \a first into \a out, as many as
+	/// fit or are left, and returns how many.
+	std::size_t Decode(std::size_t first, QuantitySpan<Q> out) const {
+		if (first >= codes.size()) {
+			return 0;
+		}
+		std::size_t count = std::min(out.size(), codes.size() - first);
+		T* result = reinterpret_cast<T*>(out.data());
+		for (std::size_t done = 0; done < count; ) {
+			std::size_t index = first + done;
+			const Block& block = blocks[index / BlockSize];
+			std::size_t n = std::min(count - done, BlockSize - index % BlockSize);
+			detail::quantized::dequantize(codes.data() + index, block.offset, block.scale,
+						      result + done, n);
+			done += n;
+		}
+		return count;
+	}
+
+	/// All of the values, dequantized.
+	std::vector<Q> Decode() const {
+		std::vector<Q> values(codes.size());
+		Decode(0, QuantitySpan<Q>(values));
+		return values;
+	}
+
+	/// The largest difference between a value given to Assign and its
+	/// dequantized value: about half of the largest Step, at most.
+	Q MaxError() const {
+		return Q(error);
+	}
+
+	std::size_t Blocks() const {
+		return blocks.size();
+	}
+
+	/// The value of code 0 in block \a b.
+	Q Offset(std::size_t b) const {
+		return Q(blocks[b].offset);
+	}
+
+	/// The difference between consecutive codes in block \a b.
+	Q Step(std::size_t b) const {
+		return Q(blocks[b].scale);
+	}
+
+	/// The memory the codes and blocks take, in bytes.
+	std::size_t Bytes() const {
+		return codes.size() * sizeof(Code) + blocks.size() * sizeof(Block);
+	}
+
+private:
+	struct Block {
+		T offset;
+		T scale;
+	};
+
+	/// Quantizes the \a size values at \a in into \a out, setting up
+	/// \a block, and returns the largest error.
+	static T Quantize(const T* in, std::size_t size, Code* out, Block& block) {
+		T low = in[0];
+		T high = in[0];
+		for (std::size_t i = 0; i < size; ++i) {
+			if (!std::isfinite(in[i])) {
+				throw std::domain_error("Only finite values can be quantized");
+			}
+			low = std::min(low, in[i]);
+			high = std::max(high, in[i]);
+		}
+
+		// A range too wide for T is divided before subtracting.
+		block.offset = low;
+		block.scale = std::isfinite(high - low) ? (high - low) / T(MAX_CODE) :
+			      high / T(MAX_CODE) - low / T(MAX_CODE);
+
+		T maxError = 0;
+		T inverse = block.scale > 0 ? 1 / block.scale : T(0);
+		for (std::size_t i = 0; i < size; ++i) {
+			T code = std::round((in[i] - low) * inverse);
+			code = std::min(std::max(code, T(0)), T(MAX_CODE));
+			out[i] = Code(code);
+
+			// Rounding in the inverse or in the dequantization can
+			// leave a value nearer the next code.
+			T value = block.offset + block.scale * code;
+			for (T next : {code - 1, code + 1}) {
+				if (next >= 0 && next <= T(MAX_CODE) &&
+				    std::abs(block.offset + block.scale * next - in[i]) < std::abs(value - in[i])) {
+					out[i] = Code(next);
+					value = block.offset + block.scale * next;
+				}
+			}
+			maxError = std::max(maxError, std::abs(value - in[i]));
+		}
+		return maxError;
+	}
+
+	std::vector<Code> codes;
+	std::vector<Block> blocks;
+	T error = 0;
+};
+
+template <class Q, class Code, std::size_t BlockSize>
+constexpr Code QuantizedArray<Q, Code, BlockSize>::MAX_CODE;
+
+#endif // BTUL_QUANTIZED_H
@@ -0,0 +1,260 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_QUEUE_H
+#define BTUL_QUEUE_H
+
+#include <btul.h>
+#include <btul_span.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace detail {
+	constexpr bool isPowerOfTwo(std::size_t n) {
+		return n != 0 && (n & (n - 1)) == 0;
+	}
+}
+
+
+/// A bounded, lock-free queue for handing quantity samples from exactly one
+/// producer thread to exactly one consumer thread.
+///
+/// The producer and consumer indices live on separate cache lines, and each
+/// side keeps a private copy of the other's index which it refreshes only
+/// when the queue appears full (or empty), so in the steady state neither
+/// side touches the other's cache line.  Batch operations copy whole runs of
+/// samples with a single pair of index updates.
+template <class Q, std::size_t Capacity>
+class SpscQuantityQueue {
+	static_assert(std::is_trivially_copyable<Q>::value,
+		      "Queued samples are copied as raw memory");
+	static_assert(detail::isPowerOfTwo(Capacity),
+		      "Capacity must be a power of two");
+
+public:
+	SpscQuantityQueue()
+		: head(0), cachedTail(0), tail(0), cachedHead(0)
+	{}
+
+	SpscQuantityQueue(const SpscQuantityQueue&) = delete;
+	SpscQuantityQueue& operator =(const SpscQuantityQueue&) = delete;
+
+	/// Producer only.  Returns false if the queue is full.
+	bool TryPush(const Q& item) {
+		return PushBatch(QuantitySpan<const Q>(&item, 1)) == 1;
+	}
+
+	/// Consumer only.  Returns false if the queue is empty.
+	bool TryPop(Q& item) {
+		return PopBatch(QuantitySpan<Q>(&item, 1)) == 1;
+	}
+
+	/// Producer only.  Pushes as many of \a items as will fit, in order,
+	/// and returns how many were pushed.
+	std::size_t PushBatch(QuantitySpan<const Q> items) {
+		std::size_t position = tail.load(std::memory_order_relaxed);
+		std::size_t space = Capacity - (position - cachedHead);
+		if (space < items.size()) {
+			cachedHead = head.load(std::memory_order_acquire);
+			space = Capacity - (position - cachedHead);
+		}
+
+		std::size_t n = std::min(space, items.size());
+		copyIn(position, items.data(), n);
+		tail.store(position + n, std::memory_order_release);
+		return n;
+	}
+
+	/// Consumer only.  Pops up to items.size() samples into \a items, in
+	/// order, and returns how many were popped.
+	std::size_t PopBatch(QuantitySpan<Q> items) {
+		std::size_t position = head.load(std::memory_order_relaxed);
+		std::size_t available = cachedTail - position;
+		if (available < items.size()) {
+			cachedTail = tail.load(std::memory_order_acquire);
+			available = cachedTail - position;
+		}
+
+		std::size_t n = std::min(available, items.size());
+		copyOut(position, items.data(), n);
+		head.store(position + n, std::memory_order_release);
+		return n;
+	}
+
+	/// The number of queued samples.  Exact only when called from the
+	/// producer or consumer while the other side is idle.
+	std::size_t SizeApprox() const {
+		return tail.load(std::memory_order_acquire) -
+		       head.load(std::memory_order_acquire);
+	}
+
+private:
+	void copyIn(std::size_t position, const Q* items, std::size_t n) {
+		std::size_t slot = position & (Capacity - 1);
+		std::size_t firstRun = std::min(n, Capacity - slot);
+		std::memcpy(buffer + slot, items, firstRun * sizeof(Q));
+		std::memcpy(buffer, items + firstRun, (n - firstRun) * sizeof(Q));
+	}
+
+	void copyOut(std::size_t position, Q* items, std::size_t n) const {
+		std::size_t slot = position & (Capacity - 1);
+		std::size_t firstRun = std::min(n, Capacity - slot);
+		std::memcpy(items, buffer + slot, firstRun * sizeof(Q));
+		std::memcpy(items + firstRun, buffer, (n - firstRun) * sizeof(Q));
+	}
+
+	// Written by the consumer.
+	alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> head;
+	std::size_t cachedTail;
+
+	// Written by the producer.
+	alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+	std::size_t cachedHead;
+
+	alignas(detail::CACHE_LINE_SIZE) Q buffer[Capacity];
+};
+
+
+/// A bounded, lock-free queue for handing quantity samples from any number
+/// of producer threads to a single consumer thread.
+///
+/// This is Dmitry Vyukov's bounded queue: every cell carries a sequence number
+/// which tells producers and the consumer whose turn it is, so producers only
+/// contend on claiming positions.  A batch push claims a run of consecutive
+/// cells with a single compare-and-swap.
+template <class Q, std::size_t Capacity>
+class MpscQuantityQueue {
+	static_assert(std::is_trivially_copyable<Q>::value,
+		      "Queued samples are copied as raw memory");
+	static_assert(detail::isPowerOfTwo(Capacity),
+		      "Capacity must be a power of two");
+
+public:
+	MpscQuantityQueue()
+		: tail(0), head(0)
+	{
+		for (std::size_t i = 0; i < Capacity; ++i) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	MpscQuantityQueue(const MpscQuantityQueue&) = delete;
+	MpscQuantityQueue& operator =(const MpscQuantityQueue&) = delete;
+
+	/// Any thread.  Returns false if the queue is full.
+	bool TryPush(const Q& item) {
+		return PushBatch(QuantitySpan<const Q>(&item, 1)) == 1;
+	}
+
+	/// Consumer only.  Returns false if the queue is empty.
+	bool TryPop(Q& item) {
+		return PopBatch(QuantitySpan<Q>(&item, 1)) == 1;
+	}
+
+	/// Any thread.  Pushes as many of \a items as will fit, as one
+	/// contiguous run, and returns how many were pushed.
+	std::size_t PushBatch(QuantitySpan<const Q> items) {
+		if (items.empty()) {
+			return 0;
+		}
+
+		std::size_t position = tail.load(std::memory_order_relaxed);
+		std::size_t n;
+		for (;;) {
+			// Cells are released by the consumer in order, so the run of
+			// free cells starting at our position is everything we may
+			// claim.
+			n = 0;
+			while (n < items.size() && n < Capacity &&
+			       cell(position + n).sequence.load(std::memory_order_acquire) ==
+			       position + n)
+			{
+				++n;
+			}
+
+			if (n == 0) {
+				// Either the queue is full, or another producer has
+				// claimed our position since we read it.
+				std::size_t current = tail.load(std::memory_order_relaxed);
+				if (current == position) {
+					return 0;
+				}
+				position = current;
+			}
+			else if (tail.compare_exchange_weak(position, position + n,
+							    std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+
+		for (std::size_t i = 0; i < n; ++i) {
+			Cell& c = cell(position + i);
+			c.value = items[i];
+			c.sequence.store(position + i + 1, std::memory_order_release);
+		}
+		return n;
+	}
+
+	/// Consumer only.  Pops up to items.size() samples into \a items, in
+	/// order, and returns how many were popped.
+	std::size_t PopBatch(QuantitySpan<Q> items) {
+		std::size_t n = 0;
+		while (n < items.size() &&
+		       cell(head + n).sequence.load(std::memory_order_acquire) == head + n + 1)
+		{
+			items[n] = cell(head + n).value;
+			++n;
+		}
+
+		for (std::size_t i = 0; i < n; ++i) {
+			cell(head + i).sequence.store(head + i + Capacity,
+						      std::memory_order_release);
+		}
+		head += n;
+		return n;
+	}
+
+private:
+	struct Cell {
+		std::atomic<std::size_t> sequence;
+		Q value;
+	};
+
+	Cell& cell(std::size_t position) {
+		return cells[position & (Capacity - 1)];
+	}
+
+	// Claimed by producers.
+	alignas(detail::CACHE_LINE_SIZE) std::atomic<std::size_t> tail;
+
+	// Owned by the consumer.
+	alignas(detail::CACHE_LINE_SIZE) std::size_t head;
+
+	alignas(detail::CACHE_LINE_SIZE) Cell cells[Capacity];
+};
+
+#endif // BTUL_QUEUE_H
@@ -0,0 +1,454 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_RANDOM_H
+#define BTUL_RANDOM_H
+
+#include <btul.h>
+#include <btul_span.h>
+#include <btul_trig.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+
+// Random quantities for Monte Carlo work.  Philox4x32 is a counter-based
+// generator: the n-th block of its output is a pure function of the seed, the
+// stream and n, so a distribution can fill an array of quantities in bulk
+// with a loop that vectorizes, and any part of that array can be filled
+// separately, on any thread, with the same result:
+//
+//	Philox4x32 generator(seed);
+//	NormalQuantityDistribution<FastLength> error(0_m, 2_mm);
+//	std::vector<FastLength> errors(count);
+//	// On each thread, for its own [begin, end):
+//	error.Fill(generator, QuantitySpan<FastLength>(errors).subspan(begin, end - begin), begin);
+//
+// Independent sequences come from different streams of the same seed.  The
+// generator also meets the UniformRandomBitGenerator requirements, and the
+// distributions can draw single values from any such generator.
+
+namespace detail {
+	namespace random {
+		typedef std::array<std::uint32_t, 4> Block;
+
+		constexpr std::uint32_t PHILOX_M0 = 0xD2511F53;
+		constexpr std::uint32_t PHILOX_M1 = 0xCD9E8D57;
+		constexpr std::uint32_t PHILOX_W0 = 0x9E3779B9;
+		constexpr std::uint32_t PHILOX_W1 = 0xBB67AE85;
+
+		inline void philoxRound(std::uint32_t (&c)[4], std::uint32_t k0, std::uint32_t k1) {
+			std::uint64_t p0 = std::uint64_t(PHILOX_M0) * c[0];
+			std::uint64_t p1 = std::uint64_t(PHILOX_M1) * c[2];
+			std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c[1] ^ k0;
+			std::uint32_t n2 = std::uint32_t(p0 >> 32) ^ c[3] ^ k1;
+			c[1] = std::uint32_t(p1);
+			c[3] = std::uint32_t(p0);
+			c[0] = n0;
+			c[2] = n2;
+		}
+
+		/// Philox4x32-10 (Salmon et al., "Parallel random numbers: as
+		/// easy as 1, 2, 3").  Only integer multiplies, xors and adds,
+		/// so a loop over counters vectorizes.  The rounds are written
+		/// out, because GCC will not vectorize the outer loop around
+		/// a loop it has not unrolled.
+		inline Block philox(std::uint32_t c0, std::uint32_t c1,
+				    std::uint32_t c2, std::uint32_t c3,
+				    std::uint32_t k0, std::uint32_t k1)
+		{
+			std::uint32_t c[4] = {c0, c1, c2, c3};
+			philoxRound(c, k0, k1);
+			philoxRound(c, k0 + 1 * PHILOX_W0, k1 + 1 * PHILOX_W1);
+			philoxRound(c, k0 + 2 * PHILOX_W0, k1 + 2 * PHILOX_W1);
+			philoxRound(c, k0 + 3 * PHILOX_W0, k1 + 3 * PHILOX_W1);
+			philoxRound(c, k0 + 4 * PHILOX_W0, k1 + 4 * PHILOX_W1);
+			philoxRound(c, k0 + 5 * PHILOX_W0, k1 + 5 * PHILOX_W1);
+			philoxRound(c, k0 + 6 * PHILOX_W0, k1 + 6 * PHILOX_W1);
+			philoxRound(c, k0 + 7 * PHILOX_W0, k1 + 7 * PHILOX_W1);
+			philoxRound(c, k0 + 8 * PHILOX_W0, k1 + 8 * PHILOX_W1);
+			philoxRound(c, k0 + 9 * PHILOX_W0, k1 + 9 * PHILOX_W1);
+			return Block{{c[0], c[1], c[2], c[3]}};
+		}
+
+		/// A double in [0, 1), on a grid of 2^-53, from two words.  The
+		/// words are narrowed to fit a signed int first, because only
+		/// signed conversions to double vectorize.
+		inline double canonical(std::uint32_t hi, std::uint32_t lo) {
+			return (double(std::int32_t(hi >> 5)) * 67108864.0 +
+				double(std::int32_t(lo >> 6))) * (1.0 / 9007199254740992.0);
+		}
+
+		inline double fromBits(std::uint64_t bits) {
+			double x;
+			std::memcpy(&x, &bits, sizeof(x));
+			return x;
+		}
+
+		inline std::uint64_t toBits(double x) {
+			std::uint64_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			return bits;
+		}
+
+		// Branch-free log and exp, after fdlibm, so that the
+		// distributions built on them vectorize.  logKernel expects a
+		// positive normal argument, and expKernel saturates to 0 and
+		// infinity well outside the range of double.
+
+		constexpr double LN2_HI = 6.93147180369123816490e-01;
+		constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+		inline double logKernel(double x) {
+			// x = 2^e * m, with m in [sqrt(2)/2, sqrt(2)).  The
+			// exponent field is converted by planting it in the
+			// mantissa of 2^52.
+			std::uint64_t bits = toBits(x);
+			std::uint64_t hx = (bits >> 32) + (0x3FF00000 - 0x3FE6A09E);
+			std::uint64_t exponent = hx >> 20;
+			double e = fromBits(0x4330000000000000 | exponent) -
+				   (4503599627370496.0 + 1023);
+			std::uint64_t mantissa = ((hx & 0x000FFFFF) + 0x3FE6A09E) << 32 |
+						 (bits & 0xFFFFFFFF);
+			double f = fromBits(mantissa) - 1;
+
+			double s = f / (2 + f);
+			double z = s * s;
+			double w = z * z;
+			double t1 = w * (3.999999999940941908e-01 +
+				    w * (2.222219843214978396e-01 +
+				    w * 1.531383769920937332e-01));
+			double t2 = z * (6.666666666666735130e-01 +
+				    w * (2.857142874366239149e-01 +
+				    w * (1.818357216161805012e-01 +
+				    w * 1.479819860511658591e-01)));
+			double r = t1 + t2;
+			double hfsq = 0.5 * f * f;
+			return e * LN2_HI - ((hfsq - (s * (hfsq + r) + e * LN2_LO)) - f);
+		}
+
+		inline double expKernel(double x) {
+			x = x < -760 ? -760 : x;
+			x = x > 760 ? 760 : x;
+			double k = (x * 1.44269504088896338700e+00 + 6755399441055744.0) -
+				   6755399441055744.0;
+			double hi = x - k * LN2_HI;
+			double lo = k * LN2_LO;
+			double r = hi - lo;
+			double t = r * r;
+			double c = r - t * (1.66666666666666019037e-01 +
+				       t * (-2.77777777770155933842e-03 +
+				       t * (6.61375632143793436117e-05 +
+				       t * (-1.65339022054652515390e-06 +
+				       t * 4.13813679705723846039e-08))));
+			double y = 1 - ((lo - (r * c) / (2 - c)) - hi);
+
+			// 2^k, in two factors that are each normal for
+			// |k| <= 1100, so that over- and underflow happen in
+			// the final multiplication.
+			std::int32_t n = std::int32_t(k);
+			std::int32_t half = n / 2;
+			double scale1 = fromBits(std::uint64_t(std::int64_t(half + 1023)) << 52);
+			double scale2 = fromBits(std::uint64_t(std::int64_t(n - half + 1023)) << 52);
+			return y * scale1 * scale2;
+		}
+
+		/// The square root of a non-negative normal number or zero, by
+		/// Newton's method on the reciprocal square root.  std::sqrt
+		/// would do, except that GCC keeps a branch for errno on it.
+		inline double sqrtKernel(double x) {
+			double y = fromBits(0x5FE6EB50C7B537A9 - (toBits(x) >> 1));
+			y = y * (1.5 - 0.5 * x * y * y);
+			y = y * (1.5 - 0.5 * x * y * y);
+			y = y * (1.5 - 0.5 * x * y * y);
+			y = y * (1.5 - 0.5 * x * y * y);
+			double r = x * y;
+			return r + 0.5 * y * (x - r * r);
+		}
+
+		/// A pair of independent standard normal deviates, by the
+		/// Box-Muller transform of one block.
+		inline void normalPair(const Block& block, double& first, double& second) {
+			double u = 1 - canonical(block[0], block[1]);
+			double v = canonical(block[2], block[3]);
+			double r = sqrtKernel(-2 * logKernel(u));
+			double sine, cosine;
+			trig::sincosKernel<PreciseTrig>(6.28318530717958647692 * v, sine, cosine);
+			first = r * cosine;
+			second = r * sine;
+		}
+
+		/// A standard normal deviate from an arbitrary generator.
+		template <class Generator>
+		double normal(Generator& generator, bool& saved, double& next) {
+			if (saved) {
+				saved = false;
+				return next;
+			}
+			double u = 1 - std::generate_canonical<double, 53>(generator);
+			double v = std::generate_canonical<double, 53>(generator);
+			double r = std::sqrt(-2 * std::log(u));
+			next = r * std::sin(6.28318530717958647692 * v);
+			saved = true;
+			return r * std::cos(6.28318530717958647692 * v);
+		}
+	}
+}
+
+/// The Philox4x32-10 counter-based generator.  Its output is a sequence of
+/// 128-bit blocks; block n is available directly as generator[n], and
+/// operator() walks through the words of the blocks in order.
+class Philox4x32 {
+public:
+	typedef std::uint32_t result_type;
+	typedef detail::random::Block Block;
+
+	explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+		: seed(seed), stream(stream), position(0), buffer()
+	{}
+
+	static constexpr result_type min() {
+		return 0;
+	}
+
+	static constexpr result_type max() {
+		return 0xFFFFFFFF;
+	}
+
+	result_type operator()() {
+		if ((position & 3) == 0) {
+			buffer = (*this)[position >> 2];
+		}
+		return buffer[position++ & 3];
+	}
+
+	void discard(unsigned long long n) {
+		position += n;
+		if (position & 3) {
+			buffer = (*this)[position >> 2];
+		}
+	}
+
+	/// Block \a index of the sequence, regardless of the position of
+	/// operator().
+	Block operator [](std::uint64_t index) const {
+		return detail::random::philox(std::uint32_t(index),
+					      std::uint32_t(index >> 32),
+					      std::uint32_t(stream),
+					      std::uint32_t(stream >> 32),
+					      std::uint32_t(seed),
+					      std::uint32_t(seed >> 32));
+	}
+
+	std::uint64_t Seed() const {
+		return seed;
+	}
+
+	std::uint64_t Stream() const {
+		return stream;
+	}
+
+private:
+	std::uint64_t seed;
+	std::uint64_t stream;
+	std::uint64_t position;
+	Block buffer;
+};
+
+namespace detail {
+	namespace random {
+		/// Fills \a out with the values numbered \a first onward, two
+		/// per block: block n gives values 2n and 2n + 1.
+		template <class Q, class Pair>
+		void fill(const Philox4x32& generator, QuantitySpan<Q> out,
+			  std::uint64_t first, Pair pair)
+		{
+			typedef typename Q::type T;
+			double a, b;
+			std::size_t i = 0;
+			if ((first & 1) && out.size() > 0) {
+				pair(generator[first >> 1], a, b);
+				out[i++] = Q(T(b));
+			}
+			std::uint64_t block = (first + i) >> 1;
+			std::size_t pairs = (out.size() - i) / 2;
+			for (std::size_t j = 0; j < pairs; ++j) {
+				pair(generator[block + j], a, b);
+				out[i + 2 * j] = Q(T(a));
+				out[i + 2 * j + 1] = Q(T(b));
+			}
+			i += 2 * pairs;
+			if (i < out.size()) {
+				pair(generator[block + pairs], a, b);
+				out[i] = Q(T(a));
+			}
+		}
+	}
+}
+
+
+/// Quantities uniformly distributed on [a, b).
+template <class Q>
+class UniformQuantityDistribution {
+public:
+	typedef Q result_type;
+
+	UniformQuantityDistribution(const Q& a, const Q& b)
+		: lower(double(a.Value())), width(double(b.Value() - a.Value()))
+	{}
+
+	template <class Generator>
+	Q operator()(Generator& generator) const {
+		typedef typename Q::type T;
+		return Q(T(lower + width * std::generate_canonical<double, 53>(generator)));
+	}
+
+	/// Fills \a out with values \a first to \a first + out.size() - 1 of
+	/// this distribution's sequence for \a generator.
+	void Fill(const Philox4x32& generator, QuantitySpan<Q> out, std::uint64_t first = 0) const {
+		double lower = this->lower;
+		double width = this->width;
+		detail::random::fill(generator, out, first,
+			[=](const Philox4x32::Block& block, double& a, double& b) {
+				a = lower + width * detail::random::canonical(block[0], block[1]);
+				b = lower + width * detail::random::canonical(block[2], block[3]);
+			});
+	}
+
+	Q a() const {
+		return Q(typename Q::type(lower));
+	}
+
+	Q b() const {
+		return Q(typename Q::type(lower + width));
+	}
+
+private:
+	double lower;
+	double width;
+};
+
+/// Normally distributed quantities.
+template <class Q>
+class NormalQuantityDistribution {
+public:
+	typedef Q result_type;
+
+	NormalQuantityDistribution(const Q& mean, const Q& deviation)
+		: location(double(mean.Value())), scale(double(deviation.Value())),
+		  saved(false), next(0)
+	{}
+
+	template <class Generator>
+	Q operator()(Generator& generator) {
+		typedef typename Q::type T;
+		return Q(T(location + scale * detail::random::normal(generator, saved, next)));
+	}
+
+	/// Fills \a out with values \a first to \a first + out.size() - 1 of
+	/// this distribution's sequence for \a generator.
+	void Fill(const Philox4x32& generator, QuantitySpan<Q> out, std::uint64_t first = 0) const {
+		double location = this->location;
+		double scale = this->scale;
+		detail::random::fill(generator, out, first,
+			[=](const Philox4x32::Block& block, double& a, double& b) {
+				detail::random::normalPair(block, a, b);
+				a = location + scale * a;
+				b = location + scale * b;
+			});
+	}
+
+	/// Forgets the second value of the last pair drawn by operator().
+	void reset() {
+		saved = false;
+	}
+
+	Q mean() const {
+		return Q(typename Q::type(location));
+	}
+
+	Q stddev() const {
+		return Q(typename Q::type(scale));
+	}
+
+private:
+	double location;
+	double scale;
+	bool saved;
+	double next;
+};
+
+/// Quantities whose logarithm is normally distributed: median * e^(sigma * Z)
+/// for standard normal Z.  The median carries the dimensions; \a sigma is the
+/// standard deviation of the logarithm, as for std::lognormal_distribution.
+template <class Q>
+class LognormalQuantityDistribution {
+public:
+	typedef Q result_type;
+
+	LognormalQuantityDistribution(const Q& median, double sigma)
+		: scale(double(median.Value())), shape(sigma), saved(false), next(0)
+	{}
+
+	template <class Generator>
+	Q operator()(Generator& generator) {
+		typedef typename Q::type T;
+		return Q(T(scale * std::exp(shape * detail::random::normal(generator, saved, next))));
+	}
+
+	/// Fills \a out with values \a first to \a first + out.size() - 1 of
+	/// this distribution's sequence for \a generator.
+	void Fill(const Philox4x32& generator, QuantitySpan<Q> out, std::uint64_t first = 0) const {
+		double scale = this->scale;
+		double shape = this->shape;
+		detail::random::fill(generator, out, first,
+			[=](const Philox4x32::Block& block, double& a, double& b) {
+				detail::random::normalPair(block, a, b);
+				a = scale * detail::random::expKernel(shape * a);
+				b = scale * detail::random::expKernel(shape * b);
+			});
+	}
+
+	void reset() {
+		saved = false;
+	}
+
+	Q median() const {
+		return Q(typename Q::type(scale));
+	}
+
+	double sigma() const {
+		return shape;
+	}
+
+private:
+	double scale;
+	double shape;
+	bool saved;
+	double next;
+};
+
+#endif // BTUL_RANDOM_H
@@ -0,0 +1,108 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_SPAN_H
+#define BTUL_SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+/// A non-owning view of a contiguous run of quantities (or of anything else
+/// stored contiguously), in the spirit of std::span.  A QuantitySpan<T> can be
+/// made from a pointer and a size, a built-in array, or any container with
+/// data() and size(), and converts implicitly to a QuantitySpan<const T>.
+///
+/// \code
+/// std::vector<Length> lengths = ...;
+/// QuantitySpan<const Length> view = lengths;
+/// \endcode
+template <class T>
+class QuantitySpan {
+public:
+	typedef T element_type;
+	typedef typename std::remove_cv<T>::type value_type;
+	typedef T* iterator;
+
+	constexpr QuantitySpan()
+		: first(nullptr), count(0)
+	{}
+
+	constexpr QuantitySpan(T* data, std::size_t size)
+		: first(data), count(size)
+	{}
+
+	template <std::size_t N>
+	constexpr QuantitySpan(T (&array)[N])
+		: first(array), count(N)
+	{}
+
+	template <class Container,
+		  class = typename std::enable_if<std::is_convertible<
+			decltype(std::declval<Container&>().data()), T*
+		  >::value>::type>
+	constexpr QuantitySpan(Container& container)
+		: first(container.data()), count(container.size())
+	{}
+
+	template <class U,
+		  class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	constexpr QuantitySpan(QuantitySpan<U> other)
+		: first(other.data()), count(other.size())
+	{}
+
+	constexpr T* data() const {
+		return first;
+	}
+
+	constexpr std::size_t size() const {
+		return count;
+	}
+
+	constexpr bool empty() const {
+		return count == 0;
+	}
+
+	constexpr T& operator [](std::size_t i) const {
+		return first[i];
+	}
+
+	constexpr iterator begin() const {
+		return first;
+	}
+
+	constexpr iterator end() const {
+		return first + count;
+	}
+
+	/// The \a size elements starting at \a offset.
+	constexpr QuantitySpan subspan(std::size_t offset, std::size_t size) const {
+		return QuantitySpan(first + offset, size);
+	}
+
+private:
+	T* first;
+	std::size_t count;
+};
+
+#endif // BTUL_SPAN_H
@@ -0,0 +1,175 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_STATISTICS_H
+#define BTUL_STATISTICS_H
+
+#include <btul.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+
+/// Single-pass summary statistics over a stream of quantities, using Welford's
+/// numerically stable update extended to the third and fourth central moments.
+///
+/// Results carry the right dimensions: the mean, standard deviation, minimum
+/// and maximum have the dimension of \a Q, the variance has the squared
+/// dimension given by Q::p2(), and the skewness and kurtosis are plain
+/// numbers.  Moments are kept in \a Number, which defaults to double for
+/// speed; adding a sample performs no allocation and no data-dependent
+/// branches.
+///
+/// Partial results computed separately, e.g. on several threads, can be
+/// combined exactly with Merge().
+template <class Q, class Number = double>
+class QuantityStatistics {
+public:
+	typedef decltype(std::declval<Q>().p2()) Variance;
+
+	QuantityStatistics& operator +=(const Q& sample) {
+		Add(sample);
+		return *this;
+	}
+
+	void Add(const Q& sample) {
+		Number x = sample.Value();
+		Number n1 = Number(n);
+		++n;
+		Number nn = Number(n);
+
+		Number delta = x - mean;
+		Number deltaN = delta / nn;
+		Number deltaN2 = deltaN * deltaN;
+		Number term1 = delta * deltaN * n1;
+
+		mean += deltaN;
+		m4 += term1 * deltaN2 * (nn * nn - 3 * nn + 3) +
+		      6 * deltaN2 * m2 -
+		      4 * deltaN * m3;
+		m3 += term1 * deltaN * (nn - 2) - 3 * deltaN * m2;
+		m2 += term1;
+
+		min = x < min ? x : min;
+		max = x > max ? x : max;
+	}
+
+	/// Combines the statistics of another stream into this one, as though
+	/// every sample of \a other had been added here.
+	QuantityStatistics& Merge(const QuantityStatistics& other) {
+		if (other.n == 0) {
+			return *this;
+		}
+		if (n == 0) {
+			return *this = other;
+		}
+
+		Number na = Number(n);
+		Number nb = Number(other.n);
+		Number nn = na + nb;
+
+		Number delta = other.mean - mean;
+		Number delta2 = delta * delta;
+		Number delta3 = delta2 * delta;
+		Number delta4 = delta2 * delta2;
+
+		Number combinedM2 = m2 + other.m2 + delta2 * na * nb / nn;
+		Number combinedM3 = m3 + other.m3 +
+				    delta3 * na * nb * (na - nb) / (nn * nn) +
+				    3 * delta * (na * other.m2 - nb * m2) / nn;
+		Number combinedM4 = m4 + other.m4 +
+				    delta4 * na * nb * (na * na - na * nb + nb * nb) /
+				    (nn * nn * nn) +
+				    6 * delta2 * (na * na * other.m2 + nb * nb * m2) /
+				    (nn * nn) +
+				    4 * delta * (na * other.m3 - nb * m3) / nn;
+
+		mean += delta * nb / nn;
+		m2 = combinedM2;
+		m3 = combinedM3;
+		m4 = combinedM4;
+		n += other.n;
+		min = other.min < min ? other.min : min;
+		max = other.max > max ? other.max : max;
+		return *this;
+	}
+
+	std::uint64_t Count() const {
+		return n;
+	}
+
+	Q Mean() const {
+		return Q(mean);
+	}
+
+	/// The population variance.
+	Variance PopulationVariance() const {
+		return Variance(m2 / Number(n));
+	}
+
+	/// The unbiased sample variance.
+	Variance SampleVariance() const {
+		return Variance(m2 / Number(n - 1));
+	}
+
+	/// The population standard deviation.
+	Q PopulationStandardDeviation() const {
+		return Q(std::sqrt(m2 / Number(n)));
+	}
+
+	/// The square root of the unbiased sample variance.
+	Q SampleStandardDeviation() const {
+		return Q(std::sqrt(m2 / Number(n - 1)));
+	}
+
+	Q Min() const {
+		return Q(min);
+	}
+
+	Q Max() const {
+		return Q(max);
+	}
+
+	/// The population skewness, i.e. the third standardized moment.
+	Number Skewness() const {
+		return std::sqrt(Number(n)) * m3 / std::pow(m2, Number(1.5));
+	}
+
+	/// The population excess kurtosis, i.e. the fourth standardized moment
+	/// minus three, which is zero for a normal distribution.
+	Number Kurtosis() const {
+		return Number(n) * m4 / (m2 * m2) - 3;
+	}
+
+private:
+	std::uint64_t n = 0;
+	Number mean = 0;
+	Number m2 = 0;
+	Number m3 = 0;
+	Number m4 = 0;
+	Number min = std::numeric_limits<Number>::infinity();
+	Number max = -std::numeric_limits<Number>::infinity();
+};
+
+#endif // BTUL_STATISTICS_H
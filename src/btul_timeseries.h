@@ -0,0 +1,232 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_TIMESERIES_H
+#define BTUL_TIMESERIES_H
+
+#include <btul.h>
+#include <btul_accumulator.h>
+#include <btul_span.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace detail {
+	// A fixed-capacity double-ended queue of sample sequence numbers, used
+	// to track the running minimum and maximum of a sliding window.
+	template <std::size_t Capacity>
+	class SequenceDeque {
+	public:
+		bool empty() const {
+			return count == 0;
+		}
+
+		std::uint64_t front() const {
+			return sequences[head];
+		}
+
+		std::uint64_t back() const {
+			return sequences[(head + count - 1) % Capacity];
+		}
+
+		void push_back(std::uint64_t sequence) {
+			sequences[(head + count) % Capacity] = sequence;
+			++count;
+		}
+
+		void pop_front() {
+			head = (head + 1) % Capacity;
+			--count;
+		}
+
+		void pop_back() {
+			--count;
+		}
+
+		void clear() {
+			head = 0;
+			count = 0;
+		}
+
+	private:
+		std::uint64_t sequences[Capacity];
+		std::size_t head = 0;
+		std::size_t count = 0;
+	};
+}
+
+
+/// A fixed-capacity history of the last \a Capacity samples of a quantity,
+/// each stamped with the Time it was taken.  Pushing is O(1) and never
+/// allocates; once full, each push evicts the oldest sample.
+///
+/// The sum, mean, minimum and maximum over the samples currently held are
+/// maintained incrementally as samples arrive and leave, the extrema with
+/// monotonic deques, so reading them is O(1) as well.
+///
+/// Times and values are kept in separate cache-aligned arrays.  Values()
+/// and Times() hand out views of the stored samples in chronological order
+/// without copying; since the storage wraps around, a snapshot is in general
+/// made of two spans, the second of which is empty after Linearize().
+///
+/// Mean(), Min() and Max() must not be called on an empty buffer.
+template <class Q, std::size_t Capacity>
+class QuantityRingBuffer {
+	static_assert(Capacity > 0, "A ring buffer needs room for at least one sample");
+
+public:
+	typedef std::pair<QuantitySpan<const Q>, QuantitySpan<const Q>> ValueSpans;
+	typedef std::pair<QuantitySpan<const Time>, QuantitySpan<const Time>> TimeSpans;
+
+	void Push(Time time, Q value) {
+		if (count == Capacity) {
+			Evict();
+		}
+
+		std::uint64_t sequence = next++;
+		std::size_t slot = (head + count) % Capacity;
+		times[slot] = time;
+		values[slot] = value;
+		++count;
+
+		while (!minima.empty() && !(At(minima.back()) < value)) {
+			minima.pop_back();
+		}
+		minima.push_back(sequence);
+
+		while (!maxima.empty() && !(value < At(maxima.back()))) {
+			maxima.pop_back();
+		}
+		maxima.push_back(sequence);
+
+		sum += value;
+	}
+
+	std::size_t Size() const {
+		return count;
+	}
+
+	bool Empty() const {
+		return count == 0;
+	}
+
+	bool Full() const {
+		return count == Capacity;
+	}
+
+	/// The time of the \a i'th oldest sample.
+	Time TimeAt(std::size_t i) const {
+		return times[(head + i) % Capacity];
+	}
+
+	/// The value of the \a i'th oldest sample.
+	Q ValueAt(std::size_t i) const {
+		return values[(head + i) % Capacity];
+	}
+
+	Q Sum() const {
+		return sum.Total();
+	}
+
+	Q Mean() const {
+		return Q(sum.Total().Value() / count);
+	}
+
+	Q Min() const {
+		return At(minima.front());
+	}
+
+	Q Max() const {
+		return At(maxima.front());
+	}
+
+	ValueSpans Values() const {
+		return Spans<const Q>(values);
+	}
+
+	TimeSpans Times() const {
+		return Spans<const Time>(times);
+	}
+
+	/// Rotates the storage so the oldest sample comes first, after which
+	/// Values() and Times() each describe the whole history as a single
+	/// span.  Costs one pass over the buffer, and nothing if the history
+	/// has not wrapped since the last call.
+	void Linearize() {
+		if (head != 0) {
+			std::rotate(times, times + head, times + Capacity);
+			std::rotate(values, values + head, values + Capacity);
+			head = 0;
+		}
+	}
+
+	void Clear() {
+		head = 0;
+		count = 0;
+		oldest = next;
+		minima.clear();
+		maxima.clear();
+		sum.Reset();
+	}
+
+private:
+	void Evict() {
+		if (minima.front() == oldest) {
+			minima.pop_front();
+		}
+		if (maxima.front() == oldest) {
+			maxima.pop_front();
+		}
+		sum -= values[head];
+
+		head = (head + 1) % Capacity;
+		--count;
+		++oldest;
+	}
+
+	const Q& At(std::uint64_t sequence) const {
+		return values[(head + (sequence - oldest)) % Capacity];
+	}
+
+	template <class T, class U>
+	std::pair<QuantitySpan<T>, QuantitySpan<T>> Spans(const U* storage) const {
+		std::size_t firstSize = std::min(count, Capacity - head);
+		return std::make_pair(QuantitySpan<T>(storage + head, firstSize),
+				      QuantitySpan<T>(storage, count - firstSize));
+	}
+
+	alignas(detail::CACHE_LINE_SIZE) Time times[Capacity];
+	alignas(detail::CACHE_LINE_SIZE) Q values[Capacity];
+
+	std::size_t head = 0;
+	std::size_t count = 0;
+	std::uint64_t oldest = 0;
+	std::uint64_t next = 0;
+
+	detail::SequenceDeque<Capacity> minima;
+	detail::SequenceDeque<Capacity> maxima;
+	QuantityAccumulator<Q> sum;
+};
+
+#endif // BTUL_TIMESERIES_H
@@ -0,0 +1,642 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_TRIG_H
+#define BTUL_TRIG_H
+
+#include <btul.h>
+#include <btul_math.h>
+#include <btul_span.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+
+// Trigonometric functions of the Angle quantity, and atan2 of any two
+// quantities of the same dimensions.  These are evaluated in double precision
+// by polynomial kernels rather than libm.  The kernels contain no branches,
+// so the span overloads vectorize, and the accuracy is selected with one of
+// the policies below:
+//
+//	double y = sin(theta);			// PreciseTrig
+//	double z = sin<FastTrig>(theta);
+//	Angle heading = atan2(north, east);
+//
+// Arguments beyond a policy's Limit are reduced by Payne and Hanek's method
+// instead, outside the vectorized loops, and non-finite arguments are passed
+// to libm.
+
+namespace detail {
+	namespace trig {
+		/// a - b, and in \a error the rounding error of the result
+		/// (Knuth's TwoSum).
+		inline double difference(double a, double b, double& error) {
+			double d = a - b;
+			double z = d - a;
+			error = (a - (d - z)) - (b + z);
+			return d;
+		}
+
+		/// a * b, and in \a error its rounding error (Dekker's product,
+		/// which needs no fused multiply-add).
+		inline double product(double a, double b, double& error) {
+			double p = a * b;
+			double ta = 134217729.0 * a;
+			double tb = 134217729.0 * b;
+			double aHi = ta - (ta - a);
+			double bHi = tb - (tb - b);
+			double aLo = a - aHi;
+			double bLo = b - bHi;
+			error = ((aHi * bHi - p) + aHi * bLo + aLo * bHi) + aLo * bLo;
+			return p;
+		}
+	}
+}
+
+/// Within 1 ulp of the exact result for sin and cos, 2 ulp for tan and 3 ulp
+/// for atan2, using the fdlibm kernels and fdlibm's reduction, which keeps
+/// the reduced argument to twice double precision.
+struct PreciseTrig {
+	/// The largest argument that Reduce handles: the quadrant has at most
+	/// 21 bits, so its products with the parts of pi/2 are exact.
+	static constexpr double Limit = 1647099.0;
+
+	/// Returns x - quadrant * pi/2, in [-pi/4, pi/4], as the sum of the
+	/// result and \a tail.  pi/2 is split into three 33-bit parts and a
+	/// remainder, as in fdlibm's medium range reduction.  Where fdlibm
+	/// goes on to the second and third parts only when the remainder has
+	/// cancelled, this always does, carrying each rounding error along,
+	/// which costs a few flops and keeps the kernels free of branches.
+	static double Reduce(double x, int& quadrant, double& tail) {
+		double n = (x * 6.36619772367581382433e-01 + 6755399441055744.0) -
+			   6755399441055744.0;
+		quadrant = int(n);
+		double error2, error3;
+		double r = detail::trig::difference(x - n * 1.57079632673412561417e+00,
+						    n * 6.07710050630396597660e-11, error2);
+		r = detail::trig::difference(r, n * 2.02226624871116645580e-21, error3);
+		// Subtracted rather than added, so that -0 reduces to -0.
+		double t = n * 8.47842766036889956997e-32 - (error2 + error3);
+		double y = r - t;
+		tail = (r - y) - t;
+		return y;
+	}
+
+	/// sin(r + tail), for |tail| below half an ulp of r.
+	static double Sin(double r, double tail) {
+		double hi, lo;
+		SinParts(r, tail, hi, lo);
+		// The sign is restored so that sin(-0) is -0.
+		return std::copysign(hi + lo, r);
+	}
+
+	static double Cos(double r, double tail) {
+		double hi, lo;
+		CosParts(r, tail, hi, lo);
+		return hi + lo;
+	}
+
+	/// tan(r + tail), or if \a odd, -1 / tan(r + tail).  The quotient of
+	/// the unrounded sine and cosine is corrected by one Newton step, so
+	/// that neither their rounding nor the division's adds to the error.
+	static double Tan(double r, double tail, bool odd) {
+		double sHi, sLo, cHi, cLo;
+		SinParts(r, tail, sHi, sLo);
+		CosParts(r, tail, cHi, cLo);
+		double nHi = odd ? cHi : sHi;
+		double nLo = odd ? cLo : sLo;
+		double dHi = odd ? sHi : cHi;
+		double dLo = odd ? sLo : cLo;
+		double d = dHi + dLo;
+		double q = (nHi + nLo) / d;
+		double error;
+		double p = detail::trig::product(q, dHi, error);
+		q += (((nHi - p) - error) + (nLo - q * dLo)) / d;
+		return odd ? -q : std::copysign(q, r);
+	}
+
+	/// sin(r + tail) as hi + lo, before their sum is rounded.
+	static void SinParts(double r, double tail, double& hi, double& lo) {
+		double z = r * r;
+		double v = z * r;
+		double p = 8.33333333332248946124e-03 +
+			   z * (-1.98412698298579493134e-04 +
+			   z * (2.75573137070700676789e-06 +
+			   z * (-2.50507602534068634195e-08 +
+			   z * 1.58969099521155010221e-10)));
+		hi = r;
+		lo = -((z * (0.5 * tail - v * p) - tail) - v * -1.66666666666666324348e-01);
+	}
+
+	static void CosParts(double r, double tail, double& hi, double& lo) {
+		double z = r * r;
+		double p = z * (4.16666666666666019037e-02 +
+			   z * (-1.38888888888741095749e-03 +
+			   z * (2.48015872894767294178e-05 +
+			   z * (-2.75573143513906633035e-07 +
+			   z * (2.08757232129817482790e-09 +
+			   z * -1.13596475577881948265e-11)))));
+		double h = 0.5 * z;
+		hi = 1.0 - h;
+		lo = ((1.0 - hi) - h) + (z * p - r * tail);
+	}
+
+	/// Valid for |t| <= tan(pi/8).
+	static double Atan(double t) {
+		double z = t * t;
+		double w = z * z;
+		double s1 = z * (3.33333333333329318027e-01 +
+			    w * (1.42857142725034663711e-01 +
+			    w * (9.09088713343650656196e-02 +
+			    w * (6.66107313738753120669e-02 +
+			    w * (4.97687799461593236017e-02 +
+			    w * 1.62858201153657823623e-02)))));
+		double s2 = w * (-1.99999999998764832476e-01 +
+			    w * (-1.11111104054623557880e-01 +
+			    w * (-7.69187620504482999495e-02 +
+			    w * (-5.83357013379057348645e-02 +
+			    w * -3.65315727442169155270e-02))));
+		return t - t * (s1 + s2);
+	}
+};
+
+/// Within about 1e-7 of the exact result, using the shorter cephes
+/// single-precision kernels.
+struct FastTrig {
+	static constexpr double Limit = 1647099.0;
+
+	/// The tail is always zero; the kernels have no use for it.
+	static double Reduce(double x, int& quadrant, double& tail) {
+		double n = (x * 6.36619772367581382433e-01 + 6755399441055744.0) -
+			   6755399441055744.0;
+		quadrant = int(n);
+		tail = 0;
+		return (x - n * 1.57079632673412561417e+00) -
+		       n * 6.07710050650619224932e-11;
+	}
+
+	static double Sin(double r, double) {
+		double z = r * r;
+		return std::copysign(r + z * r * (-1.6666654611e-1 +
+						  z * (8.3321608736e-3 +
+						  z * -1.9515295891e-4)),
+				     r);
+	}
+
+	static double Cos(double r, double) {
+		double z = r * r;
+		return 1.0 - 0.5 * z + z * z * (4.166664568298827e-2 +
+						z * (-1.388731625493765e-3 +
+						z * 2.443315711809948e-5));
+	}
+
+	static double Tan(double r, double tail, bool odd) {
+		double s = Sin(r, tail);
+		double c = Cos(r, tail);
+		return odd ? -c / s : s / c;
+	}
+
+	static double Atan(double t) {
+		double z = t * t;
+		return t + t * z * (-3.33329491539e-1 +
+				    z * (1.99777106478e-1 +
+				    z * (-1.38776856032e-1 +
+				    z * 8.05374449538e-2)));
+	}
+};
+
+namespace detail {
+	namespace trig {
+		constexpr double TAN_PI_8 = 4.14213562373095034e-01;
+
+		// Multiples of pi/4, split into the nearest double and the
+		// remainder.
+		constexpr double PI_4_HI = 7.85398163397448278999e-01;
+		constexpr double PI_4_LO = 3.06161699786838301793e-17;
+		constexpr double PI_2_HI = 1.57079632679489655800e+00;
+		constexpr double PI_2_LO = 6.12323399573676603587e-17;
+		constexpr double PI_3_4_HI = 2.35619449019234483700e+00;
+		constexpr double PI_3_4_LO = 9.18485099360514843751e-17;
+		constexpr double PI_HI = 3.14159265358979311600e+00;
+		constexpr double PI_LO = 1.22464679914735320717e-16;
+
+		// The kernels below do no range checking.  They are kept free of
+		// branches, so that loops calling them vectorize.  Each works
+		// from x reduced to r + tail - quadrant * pi/2.
+
+		template <class Accuracy>
+		inline double sinReduced(double r, double tail, int quadrant) {
+			double s = Accuracy::Sin(r, tail);
+			double c = Accuracy::Cos(r, tail);
+			double v = (quadrant & 1) ? c : s;
+			return (quadrant & 2) ? -v : v;
+		}
+
+		template <class Accuracy>
+		inline double cosReduced(double r, double tail, int quadrant) {
+			double s = Accuracy::Sin(r, tail);
+			double c = Accuracy::Cos(r, tail);
+			double v = (quadrant & 1) ? s : c;
+			return ((quadrant + 1) & 2) ? -v : v;
+		}
+
+		template <class Accuracy>
+		inline double tanReduced(double r, double tail, int quadrant) {
+			return Accuracy::Tan(r, tail, (quadrant & 1) != 0);
+		}
+
+		/// Computes the sine and cosine of r + tail + quadrant * pi/2.
+		template <class Accuracy>
+		inline void unreduce(double r, double tail, int quadrant, double& sine, double& cosine) {
+			double s = Accuracy::Sin(r, tail);
+			double c = Accuracy::Cos(r, tail);
+			double u = (quadrant & 1) ? c : s;
+			double v = (quadrant & 1) ? s : c;
+			sine = (quadrant & 2) ? -u : u;
+			cosine = ((quadrant + 1) & 2) ? -v : v;
+		}
+
+#define DECLARE_TRIG_KERNEL(NAME)						\
+		template <class Accuracy>					\
+		inline double NAME##Kernel(double x) {				\
+			int quadrant;						\
+			double tail;						\
+			double r = Accuracy::Reduce(x, quadrant, tail);		\
+			return NAME##Reduced<Accuracy>(r, tail, quadrant);	\
+		}
+
+		DECLARE_TRIG_KERNEL(sin)
+		DECLARE_TRIG_KERNEL(cos)
+		DECLARE_TRIG_KERNEL(tan)
+#undef DECLARE_TRIG_KERNEL
+
+		template <class Accuracy>
+		inline void sincosKernel(double x, double& sine, double& cosine) {
+			int quadrant;
+			double tail;
+			double r = Accuracy::Reduce(x, quadrant, tail);
+			unreduce<Accuracy>(r, tail, quadrant, sine, cosine);
+		}
+
+		template <class Accuracy>
+		inline double atan2Kernel(double y, double x) {
+			double ax = std::fabs(x);
+			double ay = std::fabs(y);
+			double hi = ax > ay ? ax : ay;
+			double lo = ax > ay ? ay : ax;
+
+			// Above tan(pi/8), atan(t) = pi/4 + atan((t - 1) / (t + 1)).
+			// The reduction is selected arithmetically by k, because
+			// the vectorizer will not speculate floating point
+			// operations that might trap, and would leave a branch
+			// on it in place.
+			double t = lo / (hi == 0 ? std::numeric_limits<double>::denorm_min() : hi);
+			double k = double(t > TAN_PI_8);
+			double r = Accuracy::Atan((t - k) / (1 + k * t));
+
+			// The result is m * pi/4 +/- r, for m = 0..4.  Adding
+			// the multiple of pi/4 in a single step avoids rounding
+			// it twice.  As above, the octant is worked out with
+			// arithmetic rather than branches.
+			double steep = double(ay > ax);
+			double negative = double(std::copysign(1.0, x) < 0);
+			double m = steep * (2 + (2 * negative - 1) * k) +
+				   (1 - steep) * (4 * negative + (1 - 2 * negative) * k);
+			double sign = 1 - 2 * (steep + negative - 2 * steep * negative);
+			double offsetHi = (m == 1) * PI_4_HI + (m == 2) * PI_2_HI +
+					  (m == 3) * PI_3_4_HI + (m == 4) * PI_HI;
+			double offsetLo = (m == 1) * PI_4_LO + (m == 2) * PI_2_LO +
+					  (m == 3) * PI_3_4_LO + (m == 4) * PI_LO;
+			return std::copysign(offsetHi + (sign * r + offsetLo), y);
+		}
+
+		template <class Accuracy>
+		inline bool inRange(double x) {
+			return std::fabs(x) <= Accuracy::Limit;
+		}
+
+		/// \a x if the kernels can reduce it, and otherwise 0, whose
+		/// result is overwritten afterwards.  Out of range arguments
+		/// must not reach Reduce, where the quadrant would overflow an
+		/// int.
+		template <class Accuracy>
+		inline double kernelArgument(double x) {
+			return inRange<Accuracy>(x) ? x : 0.0;
+		}
+
+		inline bool finite(double y, double x) {
+			return std::isfinite(y) && std::isfinite(x);
+		}
+
+		/// The bits of 2/pi after the binary point, enough for the
+		/// largest double.
+		constexpr std::uint32_t TWO_OVER_PI[] = {
+			0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0, 0xDB629599, 0x3C439041,
+			0xFE5163AB, 0xDEBBC561, 0xB7246E3A, 0x424DD2E0, 0x06492EEA, 0x09D1921C,
+			0xFE1DEB1C, 0xB129A73E, 0xE88235F5, 0x2EBB4484, 0xE99C7026, 0xB45F7E41,
+			0x3991D639, 0x835339F4, 0x9C845F8B, 0xBDF9283B, 0x1FF897FF, 0xDE05980F,
+			0xEF2F118B, 0x5A0A6D1F, 0x6D367ECF, 0x27CB09B7, 0x4F463F66, 0x9E5FEA2D,
+			0x7527BAC7, 0xEBE5F17B, 0x3D0739F7, 0x8A5292EA, 0x6BFB5FB1, 0x1F8D5D08,
+			0x56033046, 0xFC7B6BAB, 0xF0CFBC20, 0x9AF4361D,
+		};
+
+		/// The 64 bits of the little-endian integer \a limbs starting at
+		/// bit \a low, with bits below zero reading as zero.
+		inline std::uint64_t bitsFrom(const std::uint32_t (&limbs)[10], int low) {
+			if (low <= -64) {
+				return 0;
+			}
+			if (low < 0) {
+				return bitsFrom(limbs, 0) << -low;
+			}
+			auto limb = [&](int i) -> std::uint64_t { return i < 10 ? limbs[i] : 0; };
+			int i = low / 32;
+			int shift = low % 32;
+			std::uint64_t bits = (limb(i) | limb(i + 1) << 32) >> shift;
+			return shift == 0 ? bits : bits | limb(i + 2) << (64 - shift);
+		}
+
+		/// Payne and Hanek's reduction of a finite \a x with |x| >= 1,
+		/// returning x - quadrant * pi/2 like the policies' Reduce.  x is
+		/// an integer times 2^e, so only the bits of 2/pi from about the
+		/// e-th on affect x * 2/pi modulo 4; eight words of them are
+		/// multiplied out exactly, leaving over 170 bits after the point,
+		/// far more than the worst cancellation of any double.
+		inline double reduceLarge(double x, int& quadrant, double& tail) {
+			int exponent;
+			double fraction = std::frexp(std::fabs(x), &exponent);
+			std::uint64_t mantissa = std::uint64_t(std::ldexp(fraction, 53));
+			int e = exponent - 53;
+
+			// With the first words skipped, x * 2/pi is product * 2^-point.
+			int skip = e > 2 ? (e - 2) / 32 : 0;
+			int point = 256 - (e - 32 * skip);
+			std::uint32_t product[10] = {};
+			const std::uint32_t halves[2] = {std::uint32_t(mantissa),
+							 std::uint32_t(mantissa >> 32)};
+			for (int h = 0; h < 2; ++h) {
+				std::uint64_t carry = 0;
+				for (int j = 0; j < 8; ++j) {
+					std::uint64_t t = std::uint64_t(TWO_OVER_PI[skip + 7 - j]) * halves[h] +
+							  product[j + h] + carry;
+					product[j + h] = std::uint32_t(t);
+					carry = t >> 32;
+				}
+				product[8 + h] = std::uint32_t(carry);
+			}
+
+			// The quadrant is the integer part modulo 4, rounded to
+			// nearest, and the remainder is what is left of the
+			// fraction, negated if it was rounded up.
+			auto bit = [&](int i) { return (product[i / 32] >> (i % 32)) & 1u; };
+			unsigned q = bit(point) + 2 * bit(point + 1);
+			bool up = bit(point - 1) != 0;
+			int top = point / 32;
+			std::uint32_t mask = (std::uint32_t(1) << (point % 32)) - 1;
+			for (int i = top + 1; i < 10; ++i) {
+				product[i] = 0;
+			}
+			product[top] &= mask;
+			if (up) {
+				++q;
+				std::uint64_t carry = 1;
+				for (int i = 0; i <= top; ++i) {
+					std::uint64_t t = std::uint64_t(~product[i]) + carry;
+					product[i] = std::uint32_t(t);
+					carry = t >> 32;
+				}
+				product[top] &= mask;
+			}
+
+			int leading = 32 * top + 31;
+			while (leading >= 0 && !bit(leading)) {
+				--leading;
+			}
+			double r = 0;
+			tail = 0;
+			if (leading >= 0) {
+				// The leading 53 bits convert exactly, and the rest to
+				// well beyond double precision of the total.
+				std::uint64_t high = bitsFrom(product, leading - 63);
+				std::uint64_t low = bitsFrom(product, leading - 127);
+				int scale = leading - 63 - point;
+				double a = std::ldexp(double(high & ~std::uint64_t(0x7FF)), scale);
+				double b = std::ldexp(double(high & 0x7FF) + std::ldexp(double(low), -64), scale);
+				double hi = a * PI_2_HI;
+				double lo = std::fma(a, PI_2_HI, -hi) + (a * PI_2_LO + b * PI_2_HI);
+				r = hi + lo;
+				tail = (hi - r) + lo;
+			}
+			if (up) {
+				r = -r;
+				tail = -tail;
+			}
+			if (x < 0) {
+				r = -r;
+				tail = -tail;
+				q = 0u - q;
+			}
+			quadrant = int(q & 3);
+			return r;
+		}
+
+#define DECLARE_TRIG_OF(NAME)							\
+		template <class Accuracy>					\
+		double NAME##Of(double x) {					\
+			if (inRange<Accuracy>(x)) {				\
+				return NAME##Kernel<Accuracy>(x);		\
+			}							\
+			if (!std::isfinite(x)) {				\
+				return std::NAME(x);				\
+			}							\
+			int quadrant;						\
+			double tail;						\
+			double r = reduceLarge(x, quadrant, tail);		\
+			return NAME##Reduced<Accuracy>(r, tail, quadrant);	\
+		}
+
+		DECLARE_TRIG_OF(sin)
+		DECLARE_TRIG_OF(cos)
+		DECLARE_TRIG_OF(tan)
+#undef DECLARE_TRIG_OF
+
+		template <class Accuracy>
+		void sincosOf(double x, double& sine, double& cosine) {
+			if (inRange<Accuracy>(x)) {
+				sincosKernel<Accuracy>(x, sine, cosine);
+			}
+			else if (!std::isfinite(x)) {
+				sine = std::sin(x);
+				cosine = std::cos(x);
+			}
+			else {
+				int quadrant;
+				double tail;
+				double r = reduceLarge(x, quadrant, tail);
+				unreduce<Accuracy>(r, tail, quadrant, sine, cosine);
+			}
+		}
+
+		template <class Accuracy>
+		double atan2Of(double y, double x) {
+			return finite(y, x) ? atan2Kernel<Accuracy>(y, x) : std::atan2(y, x);
+		}
+
+		template <class Q>
+		constexpr bool dimensionless() {
+			return sameDimensions<Q, Quantity<0, 0, 0, 0, 0, 0, 0>>();
+		}
+	}
+}
+
+
+// Scalar overloads.
+
+#define DECLARE_TRIG_FUNCTION(NAME)						\
+template <class Accuracy = PreciseTrig, class T, class F>			\
+double NAME(const Quantity<0, 0, 0, 0, 0, 0, 0, T, F>& x) {			\
+	return detail::trig::NAME##Of<Accuracy>(double(x.Value()));		\
+}
+
+DECLARE_TRIG_FUNCTION(sin)
+DECLARE_TRIG_FUNCTION(cos)
+DECLARE_TRIG_FUNCTION(tan)
+
+/// Returns the sine and cosine of \a x, sharing the argument reduction.
+template <class Accuracy = PreciseTrig, class T, class F>
+std::pair<double, double> sincos(const Quantity<0, 0, 0, 0, 0, 0, 0, T, F>& x) {
+	std::pair<double, double> result;
+	detail::trig::sincosOf<Accuracy>(double(x.Value()), result.first, result.second);
+	return result;
+}
+
+/// The angle of the point (x, y) from the x axis, in (-pi, pi].  Both
+/// coordinates may be of any dimension, as long as it's the same one.
+template <class Accuracy = PreciseTrig,
+	  BASE_QUANTITIES_DECLARATION, int Root,
+	  class T1, class F1, class T2, class F2>
+Angle atan2(const Quantity<BASE_QUANTITIES, T1, F1, Root>& y,
+	    const Quantity<BASE_QUANTITIES, T2, F2, Root>& x)
+{
+	return Angle(detail::trig::atan2Of<Accuracy>(double(y.Value()),
+						     double(x.Value())));
+}
+
+template <class Accuracy = PreciseTrig, class T, class F>
+Angle atan(const Quantity<0, 0, 0, 0, 0, 0, 0, T, F>& x) {
+	return Angle(detail::trig::atan2Of<Accuracy>(double(x.Value()), 1.0));
+}
+
+
+// Span overloads.  The kernel is applied to every element first, and the
+// few elements it cannot reduce are then recomputed, which keeps the main
+// loop free of branches.
+
+#define DECLARE_TRIG_SPAN_FUNCTION(NAME)					\
+template <class Accuracy = PreciseTrig, class Q>				\
+void NAME(QuantitySpan<Q> in, QuantitySpan<double> out) {			\
+	static_assert(detail::trig::dimensionless<Q>(),				\
+		      "Trigonometric functions take a dimensionless angle");	\
+	for (std::size_t i = 0; i < in.size(); ++i) {				\
+		out[i] = detail::trig::NAME##Kernel<Accuracy>(			\
+			detail::trig::kernelArgument<Accuracy>(			\
+				double(in[i].Value()))				\
+		);								\
+	}									\
+	for (std::size_t i = 0; i < in.size(); ++i) {				\
+		double x = double(in[i].Value());				\
+		if (!detail::trig::inRange<Accuracy>(x)) {			\
+			out[i] = detail::trig::NAME##Of<Accuracy>(x);		\
+		}								\
+	}									\
+}
+
+DECLARE_TRIG_SPAN_FUNCTION(sin)
+DECLARE_TRIG_SPAN_FUNCTION(cos)
+DECLARE_TRIG_SPAN_FUNCTION(tan)
+
+template <class Accuracy = PreciseTrig, class Q>
+void sincos(QuantitySpan<Q> in, QuantitySpan<double> sines, QuantitySpan<double> cosines) {
+	static_assert(detail::trig::dimensionless<Q>(),
+		      "Trigonometric functions take a dimensionless angle");
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		detail::trig::sincosKernel<Accuracy>(
+			detail::trig::kernelArgument<Accuracy>(double(in[i].Value())),
+			sines[i],
+			cosines[i]);
+	}
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		double x = double(in[i].Value());
+		if (!detail::trig::inRange<Accuracy>(x)) {
+			detail::trig::sincosOf<Accuracy>(x, sines[i], cosines[i]);
+		}
+	}
+}
+
+template <class Accuracy = PreciseTrig, class Q1, class Q2, class R>
+void atan2(QuantitySpan<Q1> y, QuantitySpan<Q2> x, QuantitySpan<R> out) {
+	static_assert(detail::sameDimensions<Q1, Q2>(),
+		      "The coordinates must have the same dimensions");
+	static_assert(detail::trig::dimensionless<R>(),
+		      "Output span has the wrong dimensions");
+	for (std::size_t i = 0; i < y.size(); ++i) {
+		out[i] = R(detail::trig::atan2Kernel<Accuracy>(double(y[i].Value()),
+							       double(x[i].Value())));
+	}
+	for (std::size_t i = 0; i < y.size(); ++i) {
+		double yi = double(y[i].Value());
+		double xi = double(x[i].Value());
+		if (!detail::trig::finite(yi, xi)) {
+			out[i] = R(std::atan2(yi, xi));
+		}
+	}
+}
+
+
+// Array overloads, returning a new array of the results.
+
+#define DECLARE_TRIG_ARRAY_FUNCTION(NAME)					\
+template <class Accuracy = PreciseTrig, class Q, std::size_t N>			\
+std::array<double, N> NAME(const std::array<Q, N>& in) {			\
+	std::array<double, N> out;						\
+	NAME<Accuracy>(QuantitySpan<const Q>(in), QuantitySpan<double>(out));	\
+	return out;								\
+}
+
+DECLARE_TRIG_ARRAY_FUNCTION(sin)
+DECLARE_TRIG_ARRAY_FUNCTION(cos)
+DECLARE_TRIG_ARRAY_FUNCTION(tan)
+
+template <class Accuracy = PreciseTrig, class Q1, class Q2, std::size_t N>
+std::array<Angle, N> atan2(const std::array<Q1, N>& y, const std::array<Q2, N>& x) {
+	std::array<Angle, N> out;
+	atan2<Accuracy>(QuantitySpan<const Q1>(y),
+			QuantitySpan<const Q2>(x),
+			QuantitySpan<Angle>(out));
+	return out;
+}
+
+#endif // BTUL_TRIG_H
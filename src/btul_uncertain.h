@@ -0,0 +1,303 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_UNCERTAIN_H
+#define BTUL_UNCERTAIN_H
+
+#include <btul.h>
+#include <btul_chain.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+
+// Number types for first order (linear) propagation of uncertainty.  Each
+// carries a value and its standard deviation σ through every operation in a
+// single pass: the deviation of f(x, y) is the root sum of squares of the
+// contributions ∂f/∂x·σx and ∂f/∂y·σy.  This is exact for linear functions,
+// and a good approximation whenever σ is small relative to the curvature of
+// f, which is the usual case for measurements.
+//
+// Uncertain assumes that the operands of every operation are independent,
+// which makes it as cheap as a pair of numbers, but overestimates or
+// underestimates the uncertainty of expressions that use the same
+// measurement twice, e.g. x - x.  CorrelatedUncertain instead keeps the
+// sensitivity of the value to each independent measurement it depends on,
+// so such correlations cancel exactly, at the cost of a (sparse, sorted)
+// list of dependencies per value.
+//
+//	typedef Quantity<0, 1, 0, 0, 0, 0, 0, Uncertain<double>> MeasuredMass;
+//	MeasuredMass mass = Uncertain<double>(2, 0.1) * kg;
+//	auto energy = 0.5 * mass * speed.p2();
+//	DeviationOf(energy);	// In joules.
+
+/// A value with an independent standard deviation.
+template <class T = double>
+class Uncertain {
+	static_assert(std::is_floating_point<T>::value,
+		      "Uncertain values must be floating point");
+
+public:
+	typedef T value_type;
+
+	constexpr Uncertain()
+		: value(0), deviation(0)
+	{}
+
+	/// An exact value.
+	constexpr Uncertain(T value)
+		: value(value), deviation(0)
+	{}
+
+	constexpr Uncertain(T value, T deviation)
+		: value(value), deviation(deviation)
+	{}
+
+	constexpr T Value() const {
+		return value;
+	}
+
+	constexpr T Deviation() const {
+		return deviation;
+	}
+
+	constexpr T Variance() const {
+		return deviation * deviation;
+	}
+
+	/// The chain rule, used by the arithmetic and math functions in
+	/// btul_chain.h: the result of a function of this value, given the
+	/// function's value and derivative here.
+	Uncertain Chain(T result, T derivative) const {
+		return Uncertain(result, std::fabs(derivative) * deviation);
+	}
+
+	static Uncertain Chain(T result, T dx, const Uncertain& x, T dy, const Uncertain& y) {
+		T a = dx * x.deviation;
+		T b = dy * y.deviation;
+		return Uncertain(result, std::sqrt(a * a + b * b));
+	}
+
+private:
+	T value;
+	T deviation;
+};
+
+
+namespace detail {
+	namespace uncertain {
+		/// Identifies an independent measurement.
+		inline std::uint64_t nextSource() {
+			static std::atomic<std::uint64_t> sources(0);
+			return sources.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+/// A value with a standard deviation, which tracks its correlation with
+/// other values through the independent measurements they depend on.
+template <class T = double>
+class CorrelatedUncertain {
+	static_assert(std::is_floating_point<T>::value,
+		      "Uncertain values must be floating point");
+
+public:
+	typedef T value_type;
+
+	CorrelatedUncertain()
+		: value(0)
+	{}
+
+	/// An exact value.
+	CorrelatedUncertain(T value)
+		: value(value)
+	{}
+
+	/// A new measurement, independent of every other.
+	CorrelatedUncertain(T value, T deviation)
+		: value(value)
+	{
+		if (deviation != 0) {
+			terms.push_back(Term{detail::uncertain::nextSource(), deviation});
+		}
+	}
+
+	T Value() const {
+		return value;
+	}
+
+	T Deviation() const {
+		return std::sqrt(Variance());
+	}
+
+	T Variance() const {
+		T variance = 0;
+		for (const Term& term : terms) {
+			variance += term.coefficient * term.coefficient;
+		}
+		return variance;
+	}
+
+	T Covariance(const CorrelatedUncertain& other) const {
+		T covariance = 0;
+		auto i = terms.begin();
+		auto j = other.terms.begin();
+		while (i != terms.end() && j != other.terms.end()) {
+			if (i->source < j->source) {
+				++i;
+			}
+			else if (j->source < i->source) {
+				++j;
+			}
+			else {
+				covariance += (i++)->coefficient * (j++)->coefficient;
+			}
+		}
+		return covariance;
+	}
+
+	/// The number of independent measurements this value depends on.
+	std::size_t Dependencies() const {
+		return terms.size();
+	}
+
+	/// The chain rule, used by the arithmetic and math functions in
+	/// btul_chain.h: the result of a function of this value, given the
+	/// function's value and derivative here.
+	CorrelatedUncertain Chain(T result, T derivative) const {
+		CorrelatedUncertain chained(result);
+		if (derivative != 0) {
+			chained.terms.reserve(terms.size());
+			for (const Term& term : terms) {
+				chained.terms.push_back(Term{term.source, derivative * term.coefficient});
+			}
+		}
+		return chained;
+	}
+
+	/// Merges the dependencies of \a x and \a y.  Sensitivities to a common
+	/// measurement are added before squaring, which is what makes
+	/// correlated contributions cancel or reinforce.
+	static CorrelatedUncertain Chain(T result,
+					 T dx, const CorrelatedUncertain& x,
+					 T dy, const CorrelatedUncertain& y)
+	{
+		CorrelatedUncertain chained(result);
+		chained.terms.reserve(x.terms.size() + y.terms.size());
+		auto i = x.terms.begin();
+		auto j = y.terms.begin();
+		while (i != x.terms.end() || j != y.terms.end()) {
+			Term term;
+			if (j == y.terms.end() || (i != x.terms.end() && i->source < j->source)) {
+				term = Term{i->source, dx * i->coefficient};
+				++i;
+			}
+			else if (i == x.terms.end() || j->source < i->source) {
+				term = Term{j->source, dy * j->coefficient};
+				++j;
+			}
+			else {
+				term = Term{i->source, dx * i->coefficient + dy * j->coefficient};
+				++i;
+				++j;
+			}
+			if (term.coefficient != 0) {
+				chained.terms.push_back(term);
+			}
+		}
+		return chained;
+	}
+
+private:
+	struct Term {
+		std::uint64_t source;
+		T coefficient;
+	};
+
+	T value;
+	/// Sorted by source.
+	std::vector<Term> terms;
+};
+
+
+namespace detail {
+	namespace chain {
+		template <class T>
+		struct Enabled<Uncertain<T>> : std::true_type {};
+
+		template <class T>
+		struct Enabled<CorrelatedUncertain<T>> : std::true_type {};
+	}
+}
+
+template <class T>
+std::ostream& operator <<(std::ostream& stream, const Uncertain<T>& x) {
+	return stream << x.Value() << " \xc2\xb1 " << x.Deviation();
+}
+
+template <class T>
+std::ostream& operator <<(std::ostream& stream, const CorrelatedUncertain<T>& x) {
+	return stream << x.Value() << " \xc2\xb1 " << x.Deviation();
+}
+
+
+// The value and standard deviation of uncertain quantities, as quantities of
+// the same dimensions.
+
+#define DECLARE_UNCERTAIN_QUANTITY_ACCESSORS(NUMBER)					\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>			\
+Quantity<BASE_QUANTITIES, T, F, Root>							\
+ValueOf(const Quantity<BASE_QUANTITIES, NUMBER<T>, F, Root>& x) {			\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(x.Value().Value());		\
+}											\
+											\
+template <BASE_QUANTITIES_DECLARATION, int Root, class T, class F>			\
+Quantity<BASE_QUANTITIES, T, F, Root>							\
+DeviationOf(const Quantity<BASE_QUANTITIES, NUMBER<T>, F, Root>& x) {			\
+	return Quantity<BASE_QUANTITIES, T, F, Root>(x.Value().Deviation());		\
+}
+
+DECLARE_UNCERTAIN_QUANTITY_ACCESSORS(Uncertain)
+DECLARE_UNCERTAIN_QUANTITY_ACCESSORS(CorrelatedUncertain)
+
+#undef DECLARE_UNCERTAIN_QUANTITY_ACCESSORS
+
+/// The covariance of two correlated quantities, which has the dimensions of
+/// their product.
+template <BASE_QUANTITIES_DECLARATION_1, class T, class F1, int Root1,
+	  BASE_QUANTITIES_DECLARATION_2, class F2, int Root2>
+NORMALIZED_QUANTITY(T, detail::DefaultFormat, Root1 * Root2, BASE_QUANTITIES_ROOT_OP(+))
+Covariance(const Quantity<BASE_QUANTITIES_1, CorrelatedUncertain<T>, F1, Root1>& x,
+	   const Quantity<BASE_QUANTITIES_2, CorrelatedUncertain<T>, F2, Root2>& y)
+{
+	return NORMALIZED_QUANTITY(T, detail::DefaultFormat, Root1 * Root2,
+				   BASE_QUANTITIES_ROOT_OP(+))
+	(
+		x.Value().Covariance(y.Value())
+	);
+}
+
+#endif // BTUL_UNCERTAIN_H
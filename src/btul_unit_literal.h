@@ -0,0 +1,336 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_UNIT_LITERAL_H
+#define BTUL_UNIT_LITERAL_H
+
+#include <btul.h>
+#include <btul_units.h>
+
+#include <cstddef>
+#include <type_traits>
+
+
+// Parsing of unit expressions at compile time, in the grammar of ParseUnit:
+//
+//	constexpr auto accel = 9.81L * UNIT("m/s^2");
+//	typedef UNIT_TYPE("J/(kg·K)") SpecificHeat;
+//	auto v = 90 * UNIT("km/h");			// 25 m/s
+//
+// UNIT is a constant of one of the given unit, and UNIT_TYPE its type, which
+// is the same type the multiplicative operators produce for the same
+// expression, so UNIT_TYPE("kg*m/s^2") is decltype(kg * m / s_p2).  Both are
+// resolved entirely by the compiler, and an expression that cannot be parsed
+// fails to compile.  Any combination of prefixes and integer powers works, so
+// code that only uses these, and the .pN() members, can define
+// NO_POWER_LITERALS to skip the thousands of _pN and _nN literals in btul.h.
+//
+// The string must be a literal of at most MAX_UNIT_LITERAL bytes.  C++11 has no
+// literal operator templates for strings, hence the macros.
+
+#define MAX_UNIT_LITERAL 32
+
+namespace detail {
+	namespace unitliteral {
+		/// ParsedUnit, as a literal type.
+		struct Unit {
+			int length, mass, time, current, temperature, amount, luminosity;
+			long double scale;
+		};
+
+		constexpr Unit ONE = {0, 0, 0, 0, 0, 0, 0, 1};
+
+		constexpr long double raise(long double x, int n) {
+			return n == 0 ? 1 : n < 0 ? 1 / raise(x, -n) : x * raise(x, n - 1);
+		}
+
+		constexpr Unit multiply(const Unit& a, const Unit& b) {
+			return Unit{a.length + b.length, a.mass + b.mass, a.time + b.time,
+				    a.current + b.current, a.temperature + b.temperature,
+				    a.amount + b.amount, a.luminosity + b.luminosity,
+				    a.scale * b.scale};
+		}
+
+		constexpr Unit power(const Unit& a, int n) {
+			return Unit{a.length * n, a.mass * n, a.time * n, a.current * n,
+				    a.temperature * n, a.amount * n, a.luminosity * n,
+				    raise(a.scale, n)};
+		}
+
+		constexpr Unit unpacked(const units::Symbol& symbol, long double scale) {
+			return Unit{units::unpack(symbol.dimensions, 0),
+				    units::unpack(symbol.dimensions, 1),
+				    units::unpack(symbol.dimensions, 2),
+				    units::unpack(symbol.dimensions, 3),
+				    units::unpack(symbol.dimensions, 4),
+				    units::unpack(symbol.dimensions, 5),
+				    units::unpack(symbol.dimensions, 6),
+				    symbol.scale * scale};
+		}
+
+		// Since C++11 only allows a single return statement in a
+		// constexpr function, the parser threads its position through
+		// return values instead of keeping it in a member, as
+		// detail::units::Parser does.  Errors are thrown, which makes
+		// the expression non-constant, so they only ever surface as
+		// compile errors.
+
+		/// A unit, and the position just past it.
+		struct Result {
+			Unit unit;
+			int end;
+		};
+
+		/// An exponent, and the position just past it.
+		struct Exponent {
+			int value;
+			int end;
+		};
+
+		constexpr unsigned char byte(const char* text, int p) {
+			return static_cast<unsigned char>(text[p]);
+		}
+
+		constexpr bool isDigit(const char* text, int p) {
+			return text[p] >= '0' && text[p] <= '9';
+		}
+
+		constexpr bool isMicro(const char* text, int p) {
+			return byte(text, p) == 0xc2 && byte(text, p + 1) == 0xb5;
+		}
+
+		constexpr bool isMiddleDot(const char* text, int p) {
+			return byte(text, p) == 0xc2 && byte(text, p + 1) == 0xb7;
+		}
+
+		constexpr bool isSuperscriptMinus(const char* text, int p) {
+			return byte(text, p) == 0xe2 && byte(text, p + 1) == 0x81 &&
+			       byte(text, p + 2) == 0xbb;
+		}
+
+		constexpr bool isLetter(const char* text, int p) {
+			return (text[p] >= 'a' && text[p] <= 'z') ||
+			       (text[p] >= 'A' && text[p] <= 'Z') || isMicro(text, p);
+		}
+
+		/// The superscript digit at \a p, as printed by Quantity, or -1.
+		constexpr int superscript(const char* text, int p) {
+			return byte(text, p) == 0xc2 ?
+				       (byte(text, p + 1) == 0xb9 ? 1 :
+					byte(text, p + 1) == 0xb2 ? 2 :
+					byte(text, p + 1) == 0xb3 ? 3 : -1) :
+			       byte(text, p) == 0xe2 && byte(text, p + 1) == 0x81 ?
+				       (byte(text, p + 2) == 0xb0 ? 0 :
+					byte(text, p + 2) >= 0xb4 && byte(text, p + 2) <= 0xb9 ?
+						byte(text, p + 2) - 0xb0 : -1) :
+			       -1;
+		}
+
+		constexpr int skipSpaces(const char* text, int p) {
+			return text[p] == ' ' ? skipSpaces(text, p + 1) : p;
+		}
+
+		constexpr int skipLetters(const char* text, int p) {
+			return isLetter(text, p) ? skipLetters(text, p + (isMicro(text, p) ? 2 : 1)) : p;
+		}
+
+		constexpr bool equal(const char* a, const char* b, int n) {
+			return n == 0 || (*a == *b && equal(a + 1, b + 1, n - 1));
+		}
+
+		// The symbols and prefixes of detail::units, searched in order,
+		// since the compiler has all the time in the world.
+
+		constexpr int findSymbol(const char* name, int n, int i) {
+			return i == units::SYMBOL_COUNT ? -1 :
+			       units::SYMBOLS[i].length == n && equal(units::SYMBOLS[i].name, name, n) ? i :
+			       findSymbol(name, n, i + 1);
+		}
+
+		constexpr int findPrefixed(const char* name, int n, const units::Prefix& prefix) {
+			return prefix.length < n && equal(prefix.name, name, prefix.length) ?
+				       findSymbol(name + prefix.length, n - prefix.length, 0) : -1;
+		}
+
+		constexpr bool hasPrefix(const char* name, int n, int i) {
+			return findPrefixed(name, n, units::PREFIXES[i]) >= 0 &&
+			       units::SYMBOLS[findPrefixed(name, n, units::PREFIXES[i])].prefixable;
+		}
+
+		constexpr Unit resolvePrefixed(const char* name, int n, int i) {
+			return i == units::NO_PREFIX ? throw UnitError("unknown unit") :
+			       hasPrefix(name, n, i) ?
+				       unpacked(units::SYMBOLS[findPrefixed(name, n, units::PREFIXES[i])],
+						units::PREFIXES[i].scale) :
+			       resolvePrefixed(name, n, i + 1);
+		}
+
+		/// Prefers an exact match over a prefixed one, like
+		/// detail::units::resolve.
+		constexpr Unit resolve(const char* name, int n) {
+			return findSymbol(name, n, 0) >= 0 ? unpacked(units::SYMBOLS[findSymbol(name, n, 0)], 1) :
+			       resolvePrefixed(name, n, 0);
+		}
+
+		constexpr Exponent digits(const char* text, int p, int value, bool found, bool negative) {
+			return value > ParsedUnit::MAX_EXPONENT ? throw UnitError("exponent out of range") :
+			       isDigit(text, p) ?
+				       digits(text, p + 1, 10 * value + (text[p] - '0'), true, negative) :
+			       superscript(text, p) >= 0 ?
+				       digits(text, p + (byte(text, p) == 0xc2 ? 2 : 3),
+					      10 * value + superscript(text, p), true, negative) :
+			       Exponent{(found ? value : 1) * (negative ? -1 : 1), p};
+		}
+
+		constexpr Exponent signedDigits(const char* text, int p, bool negative) {
+			return isDigit(text, p) ? digits(text, p, 0, false, negative) :
+			       throw UnitError("expected an exponent");
+		}
+
+		constexpr Exponent exponent(const char* text, int p) {
+			return text[p] == '^' ?
+				       signedDigits(text,
+						    p + 1 + (text[p + 1] == '-' || text[p + 1] == '+'),
+						    text[p + 1] == '-') :
+			       text[p] == '-' && isDigit(text, p + 1) ?
+				       digits(text, p + 1, 0, false, true) :
+			       isSuperscriptMinus(text, p) ?
+				       (superscript(text, p + 3) >= 0 ?
+						digits(text, p + 3, 0, false, true) :
+						throw UnitError("expected an exponent")) :
+			       digits(text, p, 0, false, false);
+		}
+
+		constexpr Result raised(const Unit& unit, const Exponent& e) {
+			return Result{power(unit, e.value), e.end};
+		}
+
+		constexpr Result expression(const char* text, int p);
+
+		constexpr Result closed(const char* text, const Result& inner) {
+			return text[inner.end] == ')' ?
+				       raised(inner.unit, exponent(text, inner.end + 1)) :
+			       throw UnitError("expected ')'");
+		}
+
+		constexpr Result symbol(const char* text, int p, int end) {
+			return end == p ? throw UnitError("expected a unit") :
+			       raised(resolve(text + p, end - p), exponent(text, end));
+		}
+
+		constexpr Result factor(const char* text, int p) {
+			return text[p] == '(' ? closed(text, expression(text, skipSpaces(text, p + 1))) :
+			       text[p] == '1' && isDigit(text, p + 1) ?
+				       throw UnitError("numeric factors are not supported") :
+			       text[p] == '1' ? raised(ONE, exponent(text, p + 1)) :
+			       symbol(text, p, skipLetters(text, p));
+		}
+
+		constexpr Result product(const Unit& unit, const Result& next, int n) {
+			return Result{multiply(unit, power(next.unit, n)), next.end};
+		}
+
+		constexpr Result rest(const char* text, const Result& left);
+
+		/// The rest of an expression, after the factors making up \a
+		/// left, whose end \a p is after any spaces.
+		constexpr Result rest(const char* text, const Result& left, int p) {
+			return text[p] == '/' ?
+				       rest(text, product(left.unit, factor(text, skipSpaces(text, p + 1)), -1)) :
+			       text[p] == '*' || text[p] == '.' ?
+				       rest(text, product(left.unit, factor(text, skipSpaces(text, p + 1)), 1)) :
+			       isMiddleDot(text, p) ?
+				       rest(text, product(left.unit, factor(text, skipSpaces(text, p + 2)), 1)) :
+			       p != left.end && text[p] != '\0' && text[p] != ')' ?
+				       rest(text, product(left.unit, factor(text, p), 1)) :
+			       Result{left.unit, p};
+		}
+
+		constexpr Result rest(const char* text, const Result& left) {
+			return rest(text, left, skipSpaces(text, left.end));
+		}
+
+		constexpr Result expression(const char* text, int p) {
+			return rest(text, factor(text, p));
+		}
+
+		constexpr Unit finish(const Result& result, const char* text) {
+			return text[result.end] == '\0' ? result.unit :
+			       throw UnitError("unexpected character");
+		}
+
+		/// Parses a unit expression; an empty one is dimensionless.
+		constexpr Unit parse(const char* text) {
+			return text[skipSpaces(text, 0)] == '\0' ? ONE :
+			       finish(expression(text, skipSpaces(text, 0)), text);
+		}
+
+		template <std::size_t Size, char... Text>
+		struct Literal {
+			static_assert(Size <= MAX_UNIT_LITERAL, "Unit literal is too long");
+
+			static constexpr char text[sizeof...(Text) + 1] = {Text..., '\0'};
+			static constexpr Unit unit = parse(text);
+
+			typedef NORMALIZED_QUANTITY(long double, DefaultFormat, 1,
+						    unit.length, unit.mass, unit.time,
+						    unit.current, unit.temperature,
+						    unit.amount, unit.luminosity) type;
+
+			static constexpr type value = type(unit.scale);
+		};
+
+		template <std::size_t Size, char... Text>
+		constexpr char Literal<Size, Text...>::text[];
+
+		template <std::size_t Size, char... Text>
+		constexpr Unit Literal<Size, Text...>::unit;
+
+		template <std::size_t Size, char... Text>
+		constexpr typename Literal<Size, Text...>::type Literal<Size, Text...>::value;
+	}
+}
+
+// The bytes of a string literal, padded with zeros to MAX_UNIT_LITERAL.
+#define UNIT_LITERAL_CHAR(TEXT, I) (I < sizeof(TEXT) ? TEXT[I] : '\0')
+#define UNIT_LITERAL_CHARS_8(TEXT, I)				\
+	UNIT_LITERAL_CHAR(TEXT, I + 0), UNIT_LITERAL_CHAR(TEXT, I + 1),	\
+	UNIT_LITERAL_CHAR(TEXT, I + 2), UNIT_LITERAL_CHAR(TEXT, I + 3),	\
+	UNIT_LITERAL_CHAR(TEXT, I + 4), UNIT_LITERAL_CHAR(TEXT, I + 5),	\
+	UNIT_LITERAL_CHAR(TEXT, I + 6), UNIT_LITERAL_CHAR(TEXT, I + 7)
+#define UNIT_LITERAL(TEXT)							\
+	detail::unitliteral::Literal<sizeof(TEXT) - 1,				\
+				     UNIT_LITERAL_CHARS_8(TEXT, 0),		\
+				     UNIT_LITERAL_CHARS_8(TEXT, 8),		\
+				     UNIT_LITERAL_CHARS_8(TEXT, 16),		\
+				     UNIT_LITERAL_CHARS_8(TEXT, 24)>
+
+// Both keep the commas of the template arguments in parentheses, so that they
+// can be passed on to other macros.
+
+/// One of the unit expression \a TEXT, as a constant.
+#define UNIT(TEXT) (UNIT_LITERAL(TEXT)::value)
+
+/// The Quantity type of the unit expression \a TEXT.
+#define UNIT_TYPE(TEXT) std::decay<decltype(UNIT(TEXT))>::type
+
+#endif // BTUL_UNIT_LITERAL_H
@@ -0,0 +1,558 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef BTUL_UNITS_H
+#define BTUL_UNITS_H
+
+#include <btul.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+
+// Parsing of unit expressions at run time, for reading files whose columns
+// are labelled with their units.  The grammar accepts what Quantity prints
+// for quantities with integer exponents, as well as the usual ASCII
+// spellings; rational exponents, which Quantity prints as e.g. "m¹⁄²", are
+// not supported:
+//
+//	ParsedUnit speed = ParseUnit("km/h");
+//	ParsedUnit heat = ParseUnit("J/(kg·K)");
+//	ParsedUnit accel = ParseUnit("m s^-2");		// or "m/s2", "m·s⁻²"
+//	Speed v = speed.Of<Speed>(90);			// 25 m/s
+//
+// Factors are separated by '*', '·', '.' or spaces, or by '/' to divide; a
+// factor is a unit symbol, "1", or a parenthesized expression, optionally
+// followed by an integer exponent of at most 64 written with '^', as plain
+// digits, or in superscript.  Units are the seven base units, the derived
+// units N, J, W, Pa, Hz, C, V and rad, and min, h and L, all but min and h
+// with the SI prefixes Y through y (u or µ for micro).  Affine units such as
+// degrees Celsius are not supported, and neither are numeric factors other
+// than "1", such as the 100 in "100 ms", which are rejected rather than
+// mistaken for exponents.
+
+/// A unit expression that could not be parsed, or a unit of the wrong
+/// dimensions.
+class UnitError : public std::runtime_error {
+public:
+	explicit UnitError(const std::string& what)
+		: std::runtime_error(what)
+	{}
+};
+
+/// The dimensions of a unit, and its size in SI units.
+struct ParsedUnit {
+	/// length, mass, time, current, temperature, amount and luminosity.
+	int exponents[7];
+	long double scale;
+
+	/// Whether the unit has the dimensions of Q.
+	template <class Q>
+	bool Is() const {
+		return Q::root == 1 &&
+		       exponents[0] == Q::length &&
+		       exponents[1] == Q::mass &&
+		       exponents[2] == Q::time &&
+		       exponents[3] == Q::current &&
+		       exponents[4] == Q::temperature &&
+		       exponents[5] == Q::amount &&
+		       exponents[6] == Q::luminosity;
+	}
+
+	/// \a value of this unit, as a Q.  Throws a UnitError if the unit does
+	/// not have the dimensions of Q.
+	template <class Q>
+	Q Of(long double value) const {
+		if (!Is<Q>()) {
+			throw UnitError("Unit does not have the dimensions of the quantity");
+		}
+		return Q(typename Q::type(value * scale));
+	}
+
+	ParsedUnit& operator *=(const ParsedUnit& other) {
+		for (int i = 0; i < 7; ++i) {
+			exponents[i] += other.exponents[i];
+		}
+		scale *= other.scale;
+		return *this;
+	}
+
+	/// The largest exponent Power accepts, and the largest magnitude of
+	/// any exponent it produces.
+	static constexpr int MAX_EXPONENT = 64;
+
+	/// This unit raised to the power \a n.  Throws a UnitError if \a n, or
+	/// any resulting exponent, is beyond MAX_EXPONENT in magnitude.
+	ParsedUnit Power(int n) const {
+		if (n > MAX_EXPONENT || n < -MAX_EXPONENT) {
+			throw UnitError("Unit exponent out of range");
+		}
+		ParsedUnit result = *this;
+		for (int i = 0; i < 7; ++i) {
+			long long exponent = (long long)exponents[i] * n;
+			if (exponent > MAX_EXPONENT || exponent < -MAX_EXPONENT) {
+				throw UnitError("Unit exponent out of range");
+			}
+			result.exponents[i] = int(exponent);
+		}
+		result.scale = 1;
+		long double base = scale;
+		for (int k = n < 0 ? -n : n; k != 0; k >>= 1) {
+			if (k & 1) {
+				result.scale *= base;
+			}
+			base *= base;
+		}
+		if (n < 0) {
+			result.scale = 1 / result.scale;
+		}
+		return result;
+	}
+};
+
+namespace detail {
+	namespace units {
+		/// The seven exponents of a unit, four bits each, from -8 to 7,
+		/// with length in the lowest bits.
+		typedef std::uint32_t Dimensions;
+
+		constexpr Dimensions pack(int l, int m, int t, int i, int theta, int n, int j) {
+			return Dimensions(l & 0xf) | Dimensions(m & 0xf) << 4 |
+			       Dimensions(t & 0xf) << 8 | Dimensions(i & 0xf) << 12 |
+			       Dimensions(theta & 0xf) << 16 | Dimensions(n & 0xf) << 20 |
+			       Dimensions(j & 0xf) << 24;
+		}
+
+		constexpr int unpack(Dimensions dimensions, int k) {
+			return int(((dimensions >> 4 * k) & 0xf) ^ 8) - 8;
+		}
+
+		struct Symbol {
+			const char* name;
+			int length;
+			Dimensions dimensions;
+			long double scale;
+			bool prefixable;
+		};
+
+		struct Prefix {
+			const char* name;
+			int length;
+			long double scale;
+		};
+
+		constexpr Symbol SYMBOLS[] = {
+			{"m",   1, pack(1, 0, 0, 0, 0, 0, 0),    1,       true},
+			{"g",   1, pack(0, 1, 0, 0, 0, 0, 0),    1e-3L,   true},
+			{"s",   1, pack(0, 0, 1, 0, 0, 0, 0),    1,       true},
+			{"A",   1, pack(0, 0, 0, 1, 0, 0, 0),    1,       true},
+			{"K",   1, pack(0, 0, 0, 0, 1, 0, 0),    1,       true},
+			{"mol", 3, pack(0, 0, 0, 0, 0, 1, 0),    1,       true},
+			{"cd",  2, pack(0, 0, 0, 0, 0, 0, 1),    1,       true},
+			{"N",   1, pack(1, 1, -2, 0, 0, 0, 0),   1,       true},
+			{"J",   1, pack(2, 1, -2, 0, 0, 0, 0),   1,       true},
+			{"W",   1, pack(2, 1, -3, 0, 0, 0, 0),   1,       true},
+			{"Pa",  2, pack(-1, 1, -2, 0, 0, 0, 0),  1,       true},
+			{"Hz",  2, pack(0, 0, -1, 0, 0, 0, 0),   1,       true},
+			{"C",   1, pack(0, 0, 1, 1, 0, 0, 0),    1,       true},
+			{"V",   1, pack(2, 1, -3, -1, 0, 0, 0),  1,       true},
+			{"rad", 3, pack(0, 0, 0, 0, 0, 0, 0),    1,       true},
+			{"L",   1, pack(3, 0, 0, 0, 0, 0, 0),    1e-3L,   true},
+			{"min", 3, pack(0, 0, 1, 0, 0, 0, 0),    60,      false},
+			{"h",   1, pack(0, 0, 1, 0, 0, 0, 0),    3600,    false},
+		};
+		constexpr int SYMBOL_COUNT = sizeof(SYMBOLS) / sizeof(SYMBOLS[0]);
+		constexpr int MAX_SYMBOL_LENGTH = 3;
+
+		enum PrefixIndex { YOTTA, ZETTA, EXA, PETA, TERA, GIGA, MEGA, KILO,
+				   HECTO, DECA, DECI, CENTI, MILLI, MICRO_ASCII, MICRO_SIGN,
+				   NANO, PICO, FEMTO, ATTO, ZEPTO, YOCTO, NO_PREFIX };
+
+		constexpr Prefix PREFIXES[] = {
+			{"Y", 1, 1e24L}, {"Z", 1, 1e21L}, {"E", 1, 1e18L}, {"P", 1, 1e15L},
+			{"T", 1, 1e12L}, {"G", 1, 1e9L}, {"M", 1, 1e6L}, {"k", 1, 1e3L},
+			{"h", 1, 1e2L}, {"da", 2, 1e1L}, {"d", 1, 1e-1L}, {"c", 1, 1e-2L},
+			{"m", 1, 1e-3L}, {"u", 1, 1e-6L}, {"\xc2\xb5", 2, 1e-6L},
+			{"n", 1, 1e-9L}, {"p", 1, 1e-12L}, {"f", 1, 1e-15L}, {"a", 1, 1e-18L},
+			{"z", 1, 1e-21L}, {"y", 1, 1e-24L},
+		};
+
+		// Symbols are found through a perfect hash of their bytes, with
+		// a multiplier that the compiler searches for, and prefixes by
+		// their first byte, so resolving a unit is a couple of table
+		// lookups whatever the prefix.
+
+		constexpr int HASH_BITS = 6;
+
+		constexpr std::uint32_t key(const char* name, int length) {
+			return length == 0 ? 0 :
+			       std::uint32_t(static_cast<unsigned char>(name[0])) |
+			       key(name + 1, length - 1) << 8;
+		}
+
+		constexpr std::uint32_t hash(std::uint32_t key, std::uint32_t seed) {
+			return std::uint32_t(key * (0x9e3779b1u + 2 * seed)) >> (32 - HASH_BITS);
+		}
+
+		/// Zero for no symbol, which no name has as its key.
+		constexpr std::uint32_t symbolKey(int i) {
+			return i < 0 ? 0 : key(SYMBOLS[i].name, SYMBOLS[i].length);
+		}
+
+		constexpr std::uint32_t symbolHash(int i, std::uint32_t seed) {
+			return hash(symbolKey(i), seed);
+		}
+
+		constexpr bool collides(std::uint32_t seed, int i, int j) {
+			return j < SYMBOL_COUNT &&
+			       (symbolHash(i, seed) == symbolHash(j, seed) || collides(seed, i, j + 1));
+		}
+
+		constexpr bool isPerfect(std::uint32_t seed, int i) {
+			return i == SYMBOL_COUNT || (!collides(seed, i, i + 1) && isPerfect(seed, i + 1));
+		}
+
+		constexpr std::uint32_t findSeed(std::uint32_t seed) {
+			return isPerfect(seed, 0) ? seed : findSeed(seed + 1);
+		}
+
+		constexpr std::uint32_t SEED = findSeed(0);
+
+		constexpr int symbolAt(std::uint32_t slot, int i) {
+			return i == SYMBOL_COUNT ? -1 :
+			       symbolHash(i, SEED) == slot ? i : symbolAt(slot, i + 1);
+		}
+
+		template <int... Slots>
+		struct Indices {};
+
+		template <int N, int... Slots>
+		struct MakeIndices : MakeIndices<N - 1, N - 1, Slots...> {};
+
+		template <int... Slots>
+		struct MakeIndices<0, Slots...> {
+			typedef Indices<Slots...> type;
+		};
+
+		template <class Slots>
+		struct HashTable;
+
+		/// The index into SYMBOLS of the symbol with each hash, or -1,
+		/// and its key, so that a match is a single comparison.
+		template <int... Slots>
+		struct HashTable<Indices<Slots...>> {
+			static constexpr signed char symbols[] = {
+				static_cast<signed char>(symbolAt(Slots, 0))...
+			};
+			static constexpr std::uint32_t keys[] = {
+				symbolKey(symbolAt(Slots, 0))...
+			};
+		};
+
+		template <int... Slots>
+		constexpr signed char HashTable<Indices<Slots...>>::symbols[];
+
+		template <int... Slots>
+		constexpr std::uint32_t HashTable<Indices<Slots...>>::keys[];
+
+		typedef HashTable<MakeIndices<1 << HASH_BITS>::type> SymbolTable;
+
+		inline const Symbol* find(const char* name, std::size_t length) {
+			if (length == 0 || length > MAX_SYMBOL_LENGTH) {
+				return nullptr;
+			}
+			std::uint32_t k = key(name, int(length));
+			std::uint32_t slot = hash(k, SEED);
+			return SymbolTable::keys[slot] == k ? &SYMBOLS[SymbolTable::symbols[slot]] : nullptr;
+		}
+
+		/// The longest prefix \a name could start with.
+		inline PrefixIndex prefix(const char* name, std::size_t length) {
+			switch (name[0]) {
+				case 'Y': return YOTTA;
+				case 'Z': return ZETTA;
+				case 'E': return EXA;
+				case 'P': return PETA;
+				case 'T': return TERA;
+				case 'G': return GIGA;
+				case 'M': return MEGA;
+				case 'k': return KILO;
+				case 'h': return HECTO;
+				case 'd': return length > 1 && name[1] == 'a' ? DECA : DECI;
+				case 'c': return CENTI;
+				case 'm': return MILLI;
+				case 'u': return MICRO_ASCII;
+				case 'n': return NANO;
+				case 'p': return PICO;
+				case 'f': return FEMTO;
+				case 'a': return ATTO;
+				case 'z': return ZEPTO;
+				case 'y': return YOCTO;
+				case '\xc2': return length > 1 && name[1] == '\xb5' ? MICRO_SIGN : NO_PREFIX;
+				default: return NO_PREFIX;
+			}
+		}
+
+		inline ParsedUnit unpacked(const Symbol& symbol) {
+			ParsedUnit unit;
+			for (int k = 0; k < 7; ++k) {
+				unit.exponents[k] = unpack(symbol.dimensions, k);
+			}
+			unit.scale = symbol.scale;
+			return unit;
+		}
+
+		/// Resolves a symbol, preferring an exact match over a
+		/// prefixed one, so that "mol" is not milli-"ol", nor "Pa"
+		/// peta-"a".  No symbol starts with 'a', so "da" never
+		/// needs to be retried as "d".
+		inline bool resolve(const char* name, std::size_t length, ParsedUnit& unit) {
+			if (const Symbol* symbol = find(name, length)) {
+				unit = unpacked(*symbol);
+				return true;
+			}
+			PrefixIndex index = prefix(name, length);
+			if (index == NO_PREFIX) {
+				return false;
+			}
+			std::size_t prefixLength = std::size_t(PREFIXES[index].length);
+			const Symbol* symbol = prefixLength < length ?
+				find(name + prefixLength, length - prefixLength) : nullptr;
+			if (!symbol || !symbol->prefixable) {
+				return false;
+			}
+			unit = unpacked(*symbol);
+			unit.scale *= PREFIXES[index].scale;
+			return true;
+		}
+
+		/// Superscript digits and minus, as printed by Quantity.
+		inline int superscript(const char* p, std::size_t& length) {
+			static const char* const digits[] = {
+				"\xe2\x81\xb0", "\xc2\xb9", "\xc2\xb2", "\xc2\xb3", "\xe2\x81\xb4",
+				"\xe2\x81\xb5", "\xe2\x81\xb6", "\xe2\x81\xb7", "\xe2\x81\xb8",
+				"\xe2\x81\xb9",
+			};
+			for (int i = 0; i < 10; ++i) {
+				length = std::strlen(digits[i]);
+				if (std::strncmp(p, digits[i], length) == 0) {
+					return i;
+				}
+			}
+			length = 0;
+			return -1;
+		}
+
+		constexpr const char* SUPERSCRIPT_MINUS = "\xe2\x81\xbb";
+		constexpr const char* MIDDLE_DOT = "\xc2\xb7";
+		constexpr const char* MICRO = "\xc2\xb5";
+
+		class Parser {
+		public:
+			explicit Parser(const std::string& text)
+				: text(text), p(text.c_str())
+			{}
+
+			ParsedUnit Parse() {
+				SkipSpaces();
+				ParsedUnit unit = {{0, 0, 0, 0, 0, 0, 0}, 1};
+				if (*p != '\0') {
+					unit = Expression();
+				}
+				if (*p != '\0') {
+					Fail("unexpected character");
+				}
+				return unit;
+			}
+
+		private:
+			ParsedUnit Expression() {
+				ParsedUnit unit = Factor();
+				for (;;) {
+					bool spaced = SkipSpaces();
+					if (*p == '/') {
+						++p;
+						SkipSpaces();
+						unit *= Factor().Power(-1);
+					}
+					else if (*p == '*' || *p == '.') {
+						++p;
+						SkipSpaces();
+						unit *= Factor();
+					}
+					else if (std::strncmp(p, MIDDLE_DOT, 2) == 0) {
+						p += 2;
+						SkipSpaces();
+						unit *= Factor();
+					}
+					else if (spaced && *p != '\0' && *p != ')') {
+						unit *= Factor();
+					}
+					else {
+						return unit;
+					}
+				}
+			}
+
+			ParsedUnit Factor() {
+				ParsedUnit unit = {{0, 0, 0, 0, 0, 0, 0}, 1};
+				if (*p == '(') {
+					++p;
+					SkipSpaces();
+					unit = Expression();
+					if (*p != ')') {
+						Fail("expected ')'");
+					}
+					++p;
+				}
+				else if (*p == '1') {
+					// Anything but a bare 1 is a scale, which the
+					// grammar has no place for.
+					if (p[1] >= '0' && p[1] <= '9') {
+						Fail("numeric factors are not supported");
+					}
+					++p;
+				}
+				else {
+					const char* start = p;
+					while (IsLetter()) {
+						p += std::strncmp(p, MICRO, 2) == 0 ? 2 : 1;
+					}
+					if (p == start) {
+						Fail("expected a unit");
+					}
+					if (!resolve(start, std::size_t(p - start), unit)) {
+						p = start;
+						Fail("unknown unit");
+					}
+				}
+				return unit.Power(Exponent());
+			}
+
+			int Exponent() {
+				bool negative = false;
+				std::size_t length;
+				if (*p == '^') {
+					++p;
+					negative = *p == '-';
+					p += *p == '-' || *p == '+';
+					if (*p < '0' || *p > '9') {
+						Fail("expected an exponent");
+					}
+				}
+				else if (*p == '-' && p[1] >= '0' && p[1] <= '9') {
+					negative = true;
+					++p;
+				}
+				else if (std::strncmp(p, SUPERSCRIPT_MINUS, 3) == 0) {
+					negative = true;
+					p += 3;
+					if (superscript(p, length) < 0) {
+						Fail("expected an exponent");
+					}
+				}
+
+				int exponent = 0;
+				bool found = false;
+				int digit = -1;
+				while ((*p >= '0' && *p <= '9') || (digit = superscript(p, length)) >= 0) {
+					if (*p >= '0' && *p <= '9') {
+						exponent = 10 * exponent + (*p++ - '0');
+					}
+					else {
+						exponent = 10 * exponent + digit;
+						p += length;
+					}
+					if (exponent > ParsedUnit::MAX_EXPONENT) {
+						Fail("exponent out of range");
+					}
+					found = true;
+				}
+				exponent = found ? exponent : 1;
+				return negative ? -exponent : exponent;
+			}
+
+			bool IsLetter() const {
+				return (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') ||
+				       std::strncmp(p, MICRO, 2) == 0;
+			}
+
+			bool SkipSpaces() {
+				const char* start = p;
+				while (*p == ' ') {
+					++p;
+				}
+				return p != start;
+			}
+
+			[[noreturn]] void Fail(const char* why) {
+				throw UnitError("Cannot parse unit \"" + text + "\": " + why +
+						" at offset " + std::to_string(p - text.c_str()));
+			}
+
+			const std::string& text;
+			const char* p;
+		};
+	}
+}
+
+namespace detail {
+	namespace units {
+		/// A recently parsed expression.
+		struct CachedUnit {
+			std::string text;
+			ParsedUnit unit;
+			bool valid;
+		};
+
+		constexpr std::size_t CACHE_SIZE = 64;
+
+		inline std::size_t cacheSlot(const std::string& text) {
+			std::uint32_t hash = 2166136261u;
+			for (char c : text) {
+				hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+			}
+			return hash % CACHE_SIZE;
+		}
+	}
+}
+
+/// Parses a unit expression; see the top of this file for the grammar.  An
+/// empty expression is dimensionless.  Throws a UnitError if \a text cannot
+/// be parsed.  Each thread remembers the last few dozen expressions it
+/// parsed, since files and configs tend to repeat the same few.
+inline ParsedUnit ParseUnit(const std::string& text) {
+	static thread_local detail::units::CachedUnit cache[detail::units::CACHE_SIZE];
+	detail::units::CachedUnit& entry = cache[detail::units::cacheSlot(text)];
+	if (!entry.valid || entry.text != text) {
+		entry.valid = false;
+		entry.unit = detail::units::Parser(text).Parse();
+		entry.text = text;
+		entry.valid = true;
+	}
+	return entry.unit;
+}
+
+#endif // BTUL_UNITS_H
@@ -0,0 +1,113 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_accumulator.h>
+
+#include <cmath>
+
+using namespace std;
+
+// Summing many values that are each below half an ulp of the running total
+// loses all of them with naive double summation.
+constexpr int smallCount = 1000;
+constexpr long double small = 1e-17L;
+constexpr long double expectedTotal = 1.0L + smallCount * small;
+
+template <class Summation>
+long double accumulateSmallValues() {
+	QuantityAccumulator<Energy, Summation> total;
+	total += 1_J;
+	for (int i = 0; i < smallCount; ++i) {
+		total += Energy(small);
+	}
+	return total.Total().Value();
+}
+
+TEST(AccumulatorTest, test00_naiveSummationDrifts) {
+	double naive = 1.0;
+	for (int i = 0; i < smallCount; ++i) {
+		naive += static_cast<double>(small);
+	}
+	EXPECT_EQ(1.0, naive);
+}
+
+// The nearest double to the expected total is 8e-18 away from it, so the
+// compensated policies must fold their parts together in long double.
+constexpr long double longDoubleTolerance = 1e-18L;
+
+TEST(AccumulatorTest, test01_kahan) {
+	ASSERT_GT(fabs(expectedTotal - (long double)(double)expectedTotal), longDoubleTolerance);
+	EXPECT_NEAR(expectedTotal, accumulateSmallValues<KahanSummation<>>(), longDoubleTolerance);
+}
+
+TEST(AccumulatorTest, test02_neumaier) {
+	EXPECT_NEAR(expectedTotal, accumulateSmallValues<NeumaierSummation<>>(),
+		    longDoubleTolerance);
+
+	// Kahan loses the small term when the addend dominates the sum.
+	QuantityAccumulator<Time> total;
+	total += 1_s;
+	total += Time(1e100L);
+	total += 1_s;
+	total -= Time(1e100L);
+	EXPECT_EQ(2.0L, total.Total().Value());
+}
+
+TEST(AccumulatorTest, test03_pairwise) {
+	EXPECT_NEAR(expectedTotal, accumulateSmallValues<PairwiseSummation<>>(), 1e-15L);
+}
+
+TEST(AccumulatorTest, test04_subtraction) {
+	QuantityAccumulator<Length> total;
+	total += 5_m;
+	total -= 2_m;
+	EXPECT_EQ(3.0L, total.Total().Value());
+
+	total.Reset();
+	EXPECT_EQ(0.0L, total.Total().Value());
+}
+
+template <class Summation>
+void testMerge() {
+	QuantityAccumulator<Time, Summation> whole;
+	QuantityAccumulator<Time, Summation> first;
+	QuantityAccumulator<Time, Summation> second;
+
+	for (int i = 0; i < 1001; ++i) {
+		Time t = Time(0.1L * i);
+		whole += t;
+		(i % 3 ? first : second) += t;
+	}
+
+	first.Merge(second);
+	EXPECT_NEAR(whole.Total().Value(), first.Total().Value(), 1e-11L);
+	EXPECT_NEAR(50050.0L, first.Total().Value(), 1e-9L);
+}
+
+TEST(AccumulatorTest, test05_merge) {
+	testMerge<KahanSummation<>>();
+	testMerge<NeumaierSummation<>>();
+	testMerge<PairwiseSummation<>>();
+}
@@ -0,0 +1,109 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_atomic.h>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+constexpr int threadCount = 8;
+constexpr int addsPerThread = 10000;
+
+TEST(AtomicTest, test00_loadAndStore) {
+	AtomicQuantity<Energy> energy;
+	EXPECT_TRUE(energy.is_lock_free());
+	EXPECT_EQ(0, energy.load().Value());
+
+	energy.store(5_J);
+	EXPECT_EQ(5, energy.load().Value());
+
+	Energy previous = energy.exchange(7_J);
+	EXPECT_EQ(5, previous.Value());
+	EXPECT_EQ(7, Energy(energy).Value());
+}
+
+TEST(AtomicTest, test01_compareExchange) {
+	AtomicQuantity<Time> time(2_s);
+
+	Time expected = 3_s;
+	EXPECT_FALSE(time.compare_exchange_strong(expected, 4_s));
+	EXPECT_EQ(2, expected.Value());
+
+	EXPECT_TRUE(time.compare_exchange_strong(expected, 4_s));
+	EXPECT_EQ(4, time.load().Value());
+}
+
+TEST(AtomicTest, test02_fetchAddAndSub) {
+	AtomicQuantity<Length> length(1_m);
+
+	EXPECT_EQ(1, length.fetch_add(2_m).Value());
+	EXPECT_EQ(3, length.fetch_sub(1_m).Value());
+	EXPECT_EQ(2, length.load().Value());
+
+	EXPECT_EQ(5, (length += 3_m).Value());
+	EXPECT_EQ(4, (length -= 1_m).Value());
+}
+
+TEST(AtomicTest, test03_concurrentFetchAdd) {
+	AtomicQuantity<Energy> energy;
+
+	vector<thread> threads;
+	for (int i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&] {
+			for (int j = 0; j < addsPerThread; ++j) {
+				energy.fetch_add(1_J);
+			}
+		});
+	}
+	for (thread& t : threads) {
+		t.join();
+	}
+
+	EXPECT_EQ(threadCount * addsPerThread, energy.load().Value());
+}
+
+TEST(AtomicTest, test04_shardedAccumulator) {
+	ShardedQuantityAccumulator<Time> elapsed;
+
+	vector<thread> threads;
+	for (int i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&] {
+			for (int j = 0; j < addsPerThread; ++j) {
+				elapsed += 2_s;
+				elapsed -= 1_s;
+			}
+		});
+	}
+	for (thread& t : threads) {
+		t.join();
+	}
+
+	EXPECT_EQ(threadCount * addsPerThread, elapsed.Load().Value());
+
+	elapsed.Reset();
+	EXPECT_EQ(0, elapsed.Load().Value());
+}
@@ -0,0 +1,164 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_bam.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<0, 0, 0, 0, 0, 0, 0, double, AngleFormat> FastAngle;
+
+constexpr long double pi = 3.14159265358979323846264338327950288L;
+
+// The error of actual, in units of the last place of expected.
+static double ulps(double actual, double expected) {
+	double ulp = nextafter(fabs(expected), numeric_limits<double>::infinity()) -
+		     fabs(expected);
+	return fabs(actual - expected) / ulp;
+}
+
+// The sine and cosine of a fraction of a turn, in long double.  The angle is
+// reduced exactly before it's converted to radians, since the exact angle
+// may not even be representable near the zeros of sin and cos.
+static pair<double, double> reference(long double turns) {
+	long double quarter = roundl(turns * 4);
+	long double r = (turns - quarter / 4) * 2 * pi;
+	long double s = sinl(r);
+	long double c = cosl(r);
+	switch (int(quarter) & 3) {
+		case 0:  return make_pair(double(s), double(c));
+		case 1:  return make_pair(double(c), double(-s));
+		case 2:  return make_pair(double(-s), double(-c));
+		default: return make_pair(double(-c), double(s));
+	}
+}
+
+TEST(BinaryAngleTest, test00_conversions) {
+	EXPECT_EQ(uint32_t(1) << 30, BinaryAngle32(Angle(pi / 2)).Value());
+	EXPECT_EQ(uint32_t(3) << 30, BinaryAngle32(Angle(-pi / 2)).Value());
+	EXPECT_EQ(uint32_t(1) << 31, BinaryAngle32(Angle(3 * pi)).Value());
+	EXPECT_EQ(uint64_t(1) << 62, BinaryAngle64(Angle(pi / 2)).Value());
+
+	EXPECT_EQ(uint32_t(3) << 30, BinaryAngle32::FromTurns(-0.25).Value());
+	EXPECT_EQ(0u, BinaryAngle32::FromTurns(-1e-20).Value());
+	EXPECT_EQ(0u, BinaryAngle64::FromTurns(-1e-20).Value());
+	EXPECT_EQ(0.75, BinaryAngle64::FromTurns(-0.25).Turns());
+
+	BinaryAngle32 west = BinaryAngle32::FromTurns(0.5);
+	EXPECT_NEAR(pi, west.ToAngle().Value(), 1e-15);
+	EXPECT_NEAR(-pi, west.ToSignedAngle().Value(), 1e-15);
+	EXPECT_NEAR(-pi / 2, BinaryAngle64::FromTurns(0.75).ToSignedAngle().Value(), 1e-15);
+	EXPECT_NEAR(0.5, BinaryAngle32(0.5_rad).ToAngle().Value(), 1e-9);
+}
+
+TEST(BinaryAngleTest, test01_wraparound) {
+	BinaryAngle32 heading = BinaryAngle32::FromTurns(0.75);
+	heading += BinaryAngle32::FromTurns(0.5);
+	EXPECT_EQ(BinaryAngle32::FromTurns(0.25), heading);
+
+	heading -= BinaryAngle32::FromTurns(0.5);
+	EXPECT_EQ(BinaryAngle32::FromTurns(0.75), heading);
+
+	EXPECT_EQ(BinaryAngle32::FromTurns(0.25), -heading);
+	EXPECT_EQ(BinaryAngle32::FromTurns(0.5), heading * 2u);
+	EXPECT_EQ(BinaryAngle32::FromTurns(0.5), 6u * heading);
+	EXPECT_NE(heading, -heading);
+
+	BinaryAngle64 phase;
+	BinaryAngle64 step = BinaryAngle64::FromTurns(0.1);
+	for (int i = 0; i < 1000; ++i) {
+		phase += step;
+	}
+	EXPECT_EQ(step * 1000u, phase);
+}
+
+TEST(BinaryAngleTest, test02_trig) {
+	BinaryAngle32 north = BinaryAngle32::FromTurns(0.25);
+	EXPECT_EQ(1, sin(north));
+	EXPECT_EQ(0, cos(north));
+	EXPECT_EQ(-1, cos(BinaryAngle32::FromTurns(0.5)));
+	EXPECT_EQ(-1, sin(BinaryAngle64::FromTurns(0.75)));
+
+	mt19937_64 generator(42);
+	double error = 0, fastError = 0;
+	for (int i = 0; i < 100000; ++i) {
+		BinaryAngle32 x32 = BinaryAngle32::FromBits(uint32_t(generator()));
+		BinaryAngle64 x64 = BinaryAngle64::FromBits(generator());
+		pair<double, double> r32 = reference(x32.Value() / 4294967296.0L);
+		pair<double, double> r64 = reference(x64.Value() / 18446744073709551616.0L);
+		error = fmax(error, ulps(sin(x32), r32.first));
+		error = fmax(error, ulps(cos(x32), r32.second));
+		error = fmax(error, ulps(sin(x64), r64.first));
+		error = fmax(error, ulps(cos(x64), r64.second));
+		fastError = fmax(fastError, fabs(sin<FastTrig>(x32) - r32.first));
+	}
+	EXPECT_LE(error, 1);
+	EXPECT_LE(fastError, 1e-7);
+
+	pair<double, double> sc = sincos(BinaryAngle32::FromTurns(0.3));
+	EXPECT_EQ(sin(BinaryAngle32::FromTurns(0.3)), sc.first);
+	EXPECT_EQ(cos(BinaryAngle32::FromTurns(0.3)), sc.second);
+}
+
+TEST(BinaryAngleTest, test03_spans) {
+	vector<BinaryAngle32> headings;
+	for (int i = 0; i < 1000; ++i) {
+		headings.push_back(BinaryAngle32::FromBits(uint32_t(i) * 4294967u));
+	}
+
+	vector<double> sines(headings.size());
+	vector<double> cosines(headings.size());
+	sincos(QuantitySpan<const BinaryAngle32>(headings),
+	       QuantitySpan<double>(sines),
+	       QuantitySpan<double>(cosines));
+
+	vector<FastAngle> angles(headings.size());
+	ToSignedAngles(QuantitySpan<const BinaryAngle32>(headings),
+		       QuantitySpan<FastAngle>(angles));
+
+	vector<BinaryAngle32> roundTrip(headings.size());
+	FromAngles(QuantitySpan<const FastAngle>(angles),
+		   QuantitySpan<BinaryAngle32>(roundTrip));
+
+	for (size_t i = 0; i < headings.size(); ++i) {
+		EXPECT_EQ(sin(headings[i]), sines[i]);
+		EXPECT_EQ(cos(headings[i]), cosines[i]);
+		EXPECT_DOUBLE_EQ(double(headings[i].ToSignedAngle().Value()), angles[i].Value());
+		EXPECT_EQ(headings[i], roundTrip[i]);
+	}
+
+	array<BinaryAngle64, 2> phases = {{
+		BinaryAngle64::FromTurns(0.25), BinaryAngle64::FromTurns(0.5)
+	}};
+	array<double, 2> phaseSines = sin(phases);
+	EXPECT_EQ(1, phaseSines[0]);
+	EXPECT_EQ(0, phaseSines[1]);
+}
@@ -0,0 +1,163 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_binary.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, float> SmallLength;
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+
+template <class Q>
+static string serialize(const vector<Q>& values) {
+	ostringstream stream;
+	WriteQuantities(stream, QuantitySpan<const Q>(values));
+	return stream.str();
+}
+
+TEST(BinaryTest, test00_roundTrip) {
+	vector<Length> lengths = {1_m, 2.5_km, -3_nm, 0_m};
+	string data = serialize(lengths);
+	EXPECT_EQ(sizeof(QuantityHeader) + lengths.size() * sizeof(Length), data.size());
+
+	istringstream stream(data);
+	vector<Length> copy = ReadQuantities<Length>(stream);
+	ASSERT_EQ(lengths.size(), copy.size());
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		EXPECT_EQ(lengths[i].Value(), copy[i].Value());
+	}
+
+	// Rational exponents are part of the dimensions.
+	typedef Quantity<1, 0, 0, 0, 0, 0, 0, double,
+			 DefaultQuantityFormat<1, 0, 0, 0, 0, 0, 0, 2>, 2> RootLength;
+	vector<RootLength> roots = {RootLength(2), RootLength(3)};
+	istringstream rootStream(serialize(roots));
+	vector<RootLength> rootCopy = ReadQuantities<RootLength>(rootStream);
+	ASSERT_EQ(2u, rootCopy.size());
+	EXPECT_EQ(3, rootCopy[1].Value());
+
+	// Several arrays in one stream.
+	ostringstream both;
+	WriteQuantities(both, QuantitySpan<const Length>(lengths));
+	WriteQuantities(both, QuantitySpan<const RootLength>(roots));
+	istringstream bothStream(both.str());
+	EXPECT_EQ(4u, ReadQuantities<Length>(bothStream).size());
+	EXPECT_EQ(2u, ReadQuantities<RootLength>(bothStream).size());
+}
+
+TEST(BinaryTest, test01_validation) {
+	vector<FastLength> lengths = {FastLength(1), FastLength(2)};
+	string data = serialize(lengths);
+
+	istringstream speeds(data);
+	EXPECT_THROW(ReadQuantities<FastSpeed>(speeds), DimensionMismatch);
+
+	istringstream floats(data);
+	EXPECT_THROW(ReadQuantities<SmallLength>(floats), DimensionMismatch);
+
+	istringstream truncated(data.substr(0, data.size() - 1));
+	EXPECT_THROW(ReadQuantities<FastLength>(truncated), SerializationError);
+
+	istringstream header(data.substr(0, 10));
+	EXPECT_THROW(ReadQuantities<FastLength>(header), SerializationError);
+
+	// A corrupt count must not be trusted with an allocation.
+	for (uint64_t count : {uint64_t(1) << 40, ~uint64_t(0)}) {
+		string huge = data;
+		memcpy(&huge[offsetof(QuantityHeader, count)], &count, sizeof(count));
+		istringstream hugeCount(huge);
+		EXPECT_THROW(ReadQuantities<FastLength>(hugeCount), SerializationError);
+	}
+
+	string garbage = data;
+	garbage[0] = 'X';
+	istringstream notQuantities(garbage);
+	EXPECT_THROW(ReadQuantities<FastLength>(notQuantities), SerializationError);
+
+	try {
+		istringstream stream(data);
+		ReadQuantities<FastSpeed>(stream);
+		FAIL() << "Expected a DimensionMismatch";
+	}
+	catch (const DimensionMismatch& e) {
+		EXPECT_EQ(string("Expected quantities of dimensions (1, 0, -1, 0, 0, 0, 0) / 1, "
+				 "found (1, 0, 0, 0, 0, 0, 0) / 1"), e.what());
+	}
+}
+
+TEST(BinaryTest, test02_byteOrder) {
+	// An array written on a machine of the other byte order.
+	vector<FastLength> lengths = {FastLength(1.5), FastLength(-2)};
+	string data = serialize(lengths);
+	QuantityHeader header;
+	memcpy(&header, data.data(), sizeof(header));
+	header.endianness = header.endianness == QuantityHeader::LITTLE_ENDIAN_ORDER ?
+			    QuantityHeader::BIG_ENDIAN_ORDER :
+			    QuantityHeader::LITTLE_ENDIAN_ORDER;
+	reverse(reinterpret_cast<char*>(&header.count),
+		reinterpret_cast<char*>(&header.count) + sizeof(header.count));
+	memcpy(&data[0], &header, sizeof(header));
+	for (size_t i = sizeof(header); i < data.size(); i += sizeof(double)) {
+		reverse(data.begin() + i, data.begin() + i + sizeof(double));
+	}
+
+	istringstream stream(data);
+	vector<FastLength> copy = ReadQuantities<FastLength>(stream);
+	ASSERT_EQ(2u, copy.size());
+	EXPECT_EQ(1.5, copy[0].Value());
+	EXPECT_EQ(-2, copy[1].Value());
+
+	EXPECT_THROW(ViewQuantities<FastLength>(data.data(), data.size()), SerializationError);
+}
+
+TEST(BinaryTest, test03_view) {
+	vector<FastLength> lengths(100);
+	for (size_t i = 0; i < lengths.size(); ++i) {
+		lengths[i] = FastLength(double(i));
+	}
+	string data = serialize(lengths);
+
+	// Stands in for a mapped file, which is page aligned.
+	vector<double> buffer(data.size() / sizeof(double));
+	memcpy(buffer.data(), data.data(), data.size());
+
+	QuantitySpan<const FastLength> view = ViewQuantities<FastLength>(buffer.data(), data.size());
+	ASSERT_EQ(lengths.size(), view.size());
+	EXPECT_EQ(static_cast<const void*>(buffer.data() + sizeof(QuantityHeader) / sizeof(double)),
+		  static_cast<const void*>(view.data()));
+	EXPECT_EQ(99, view[99].Value());
+
+	EXPECT_THROW(ViewQuantities<FastLength>(buffer.data(), data.size() - 8), SerializationError);
+	EXPECT_THROW(ViewQuantities<FastSpeed>(buffer.data(), data.size()), DimensionMismatch);
+}
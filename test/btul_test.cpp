@@ -217,3 +217,34 @@ TEST(ValueTest, test06_powers) {
 	EXPECT_EQ(pow(10, 2) * pow(1000, 2), a6.Value());
 }
 
+
+TEST(ValueTest, test07_rationalExponents) {
+	typedef decltype(m * s_n1) Speed;
+	typedef Quantity<1, 0, -1, 0, 0, 0, 0, long double,
+			 DefaultQuantityFormat<1, 0, -1, 0, 0, 0, 0, 2>, 2> RootSpeed;
+
+	RootSpeed r1 = RootSpeed(3);
+	static_assert(RootSpeed::length == 1 &&
+		      RootSpeed::time == -1 &&
+		      RootSpeed::root == 2,
+		      "The exponents should be 1/2 and -1/2");
+
+	// Exponents are kept in lowest terms, so squaring gives back an
+	// integral quantity.
+	Speed v1 = r1.p2();
+	EXPECT_EQ(9, v1.Value());
+
+	Speed v2 = r1 * r1;
+	EXPECT_EQ(9, v2.Value());
+
+	Length l1 = r1 * r1 * s;
+	EXPECT_EQ(9, l1.Value());
+
+	ostringstream stream;
+	stream << r1;
+	EXPECT_EQ("3 m¹⁄²/s¹⁄²", stream.str());
+
+	ostringstream inverse;
+	inverse << r1.n1();
+	EXPECT_EQ("0.333333 s¹⁄²/m¹⁄²", inverse.str());
+}
@@ -0,0 +1,135 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_chrono.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <ratio>
+#include <sstream>
+#include <type_traits>
+
+using namespace std;
+using namespace std::chrono;
+
+typedef decltype(m / s) Speed;
+typedef Quantity<0, 0, 1, 0, 0, 0, 0, double> FastTime;
+
+static_assert(FromDuration(seconds(2)).Value() == 2, "Constant conversions");
+static_assert(FromDuration<TickTime<>>(milliseconds(3)).Value().Count() == 3000000,
+	      "Exact conversions");
+
+TEST(ChronoTest, test00_durations) {
+	EXPECT_EQ(1.5L, FromDuration(milliseconds(1500)).Value());
+	EXPECT_EQ(5400, FromDuration(minutes(90)).Value());
+	EXPECT_EQ(-7200, FromDuration(hours(-2)).Value());
+	EXPECT_EQ(1e-9L, FromDuration(nanoseconds(1)).Value());
+	EXPECT_EQ(0.25L, FromDuration(duration<double>(0.25)).Value());
+	EXPECT_EQ(0.125, FromDuration<FastTime>(duration<float, milli>(125)).Value());
+
+	EXPECT_EQ(1500000, ToDuration<microseconds>(1.5_s).count());
+	EXPECT_EQ(3, ToDuration<seconds>(2.5_s).count());
+	EXPECT_EQ(-3, ToDuration<seconds>(-2.5_s).count());
+	EXPECT_EQ(2, ToDuration<seconds>(2.4999_s).count());
+	EXPECT_EQ(90, ToDuration<minutes>(FromDuration(hours(1) + minutes(30))).count());
+	typedef duration<double, milli> Milliseconds;
+	EXPECT_EQ(2.5, ToDuration<Milliseconds>(FastTime(0.0025)).count());
+
+	// Every nanosecond count of the last few centuries round-trips.
+	mt19937_64 engine(7);
+	uniform_int_distribution<int64_t> counts(-(int64_t(1) << 62), int64_t(1) << 62);
+	for (int i = 0; i < 10000; ++i) {
+		nanoseconds d(counts(engine));
+		ASSERT_EQ(d, ToDuration<nanoseconds>(FromDuration(d))) << d.count();
+		ASSERT_EQ(d, ToDuration<nanoseconds>(FromDuration<TickTime<>>(d))) << d.count();
+	}
+}
+
+TEST(ChronoTest, test01_ticks) {
+	// A million nanoseconds add up to exactly a millisecond.
+	TickTime<> sum;
+	Time floatingSum = 0_s;
+	TickTime<> step = FromDuration<TickTime<>>(nanoseconds(1));
+	for (int i = 0; i < 1000000; ++i) {
+		sum += step;
+		floatingSum += 1_ns;
+	}
+	EXPECT_EQ(1000000, sum.Value().Count());
+	EXPECT_EQ(milliseconds(1), ToDuration<milliseconds>(sum));
+	EXPECT_EQ(sum, FromDuration<TickTime<>>(milliseconds(1)));
+	EXPECT_NE(1e-3L, floatingSum.Value());
+
+	TickTime<> t = FromDuration<TickTime<>>(seconds(10));
+	EXPECT_EQ(30000000000, (3 * t).Value().Count());
+	EXPECT_EQ(5000000000, (t / 2).Value().Count());
+	EXPECT_EQ(-10000000000, (-t).Value().Count());
+	EXPECT_EQ(4, (t * 2 / t * 2).Value());
+	t *= 3;
+	EXPECT_EQ(30, FromDuration(ToDuration<seconds>(t)).Value());
+
+	// Coarser ticks round, and finer ones are exact.
+	typedef TickTime<micro> MicroTime;
+	EXPECT_EQ(2, FromDuration<MicroTime>(nanoseconds(1500)).Value().Count());
+	EXPECT_EQ(-2, FromDuration<MicroTime>(nanoseconds(-1500)).Value().Count());
+	EXPECT_EQ(1, FromDuration<MicroTime>(nanoseconds(1499)).Value().Count());
+	EXPECT_EQ(1000, ToDuration<nanoseconds>(FromDuration<MicroTime>(microseconds(1))).count());
+	EXPECT_EQ(3, FromDuration<MicroTime>(duration<double, micro>(2.5)).Value().Count());
+
+	auto now = steady_clock::now().time_since_epoch();
+	EXPECT_EQ(duration_cast<nanoseconds>(now),
+		  ToDuration<nanoseconds>(FromDuration<TickTime<>>(now)));
+}
+
+TEST(ChronoTest, test02_mixed) {
+	TickTime<> t = FromDuration<TickTime<>>(milliseconds(1500));
+	Time floating = t;
+	EXPECT_EQ(1.5L, floating.Value());
+	TickTime<> back = 2.25_s;
+	EXPECT_EQ(2250000000, back.Value().Count());
+	EXPECT_EQ(1, TickTime<>(0.5_ns).Value().Count());
+
+	auto sum = t + 1_ms;
+	static_assert(is_same<decltype(sum)::type, long double>::value, "Mixed sums are floating");
+	EXPECT_NEAR(1.501L, sum.Value(), 1e-15);
+	auto difference = t - t;
+	static_assert(is_same<decltype(difference)::type, Ticks<>>::value, "Sums of ticks are ticks");
+
+	Speed v = 3_m / t;
+	EXPECT_EQ(2, v.Value());
+	auto frequency = 1 / t;
+	EXPECT_NEAR(1 / 1.5L, frequency.Value(), 1e-18);
+	EXPECT_EQ(1.5L * 1.5L, (t * t).Value());
+	EXPECT_EQ(0.75L, (t * 0.5).Value());
+
+	EXPECT_TRUE(t < 2_s);
+	EXPECT_TRUE(t == 1.5_s);
+	EXPECT_TRUE(1_s < t);
+	EXPECT_TRUE(t >= FromDuration<TickTime<>>(seconds(1)));
+
+	ostringstream stream;
+	stream << t;
+	EXPECT_EQ("1.5 s", stream.str());
+}
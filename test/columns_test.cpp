@@ -0,0 +1,145 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_columns.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+
+class ColumnsTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		char name[] = "/tmp/btul_columns_XXXXXX";
+		int descriptor = mkstemp(name);
+		ASSERT_GE(descriptor, 0);
+		close(descriptor);
+		path = name;
+	}
+
+	void TearDown() override {
+		remove(path.c_str());
+	}
+
+	string path;
+};
+
+TEST_F(ColumnsTest, test00_roundTrip) {
+	vector<FastLength> positions(10000);
+	vector<FastSpeed> speeds(333);
+	vector<Mass> masses = {1_kg, 2_g};
+	for (size_t i = 0; i < positions.size(); ++i) {
+		positions[i] = FastLength(0.5 * i);
+	}
+	for (size_t i = 0; i < speeds.size(); ++i) {
+		speeds[i] = FastSpeed(-1.0 * i);
+	}
+
+	{
+		ColumnWriter writer(path);
+		writer.Add("position", QuantitySpan<const FastLength>(positions));
+		writer.Add("speed", QuantitySpan<const FastSpeed>(speeds));
+		writer.Add("empty", QuantitySpan<const FastSpeed>());
+		writer.Add("mass", QuantitySpan<const Mass>(masses));
+		EXPECT_THROW(writer.Add("mass", QuantitySpan<const Mass>(masses)), SerializationError);
+	}
+
+	ColumnFile file(path, AccessPattern::Sequential, true);
+	ASSERT_EQ(4u, file.Columns());
+	EXPECT_EQ("position", file.Name(0));
+	EXPECT_EQ("mass", file.Name(3));
+	EXPECT_TRUE(file.Contains("speed"));
+	EXPECT_FALSE(file.Contains("time"));
+
+	QuantitySpan<const FastLength> position = file.Column<FastLength>("position");
+	ASSERT_EQ(positions.size(), position.size());
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(position.data()) % detail::CACHE_LINE_SIZE);
+	for (size_t i = 0; i < positions.size(); ++i) {
+		ASSERT_EQ(positions[i].Value(), position[i].Value());
+	}
+
+	file.Advise("speed", AccessPattern::Random);
+	file.Prefetch("speed");
+	QuantitySpan<const FastSpeed> speed = file.Column<FastSpeed>("speed");
+	ASSERT_EQ(speeds.size(), speed.size());
+	EXPECT_EQ(-332, speed[332].Value());
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(speed.data()) % detail::CACHE_LINE_SIZE);
+
+	EXPECT_TRUE(file.Column<FastSpeed>("empty").empty());
+	EXPECT_EQ(0.002L, file.Column<Mass>("mass")[1].Value());
+	EXPECT_EQ(-1, file.Header("speed").exponents[2]);
+}
+
+TEST_F(ColumnsTest, test01_errors) {
+	vector<FastLength> positions = {FastLength(1), FastLength(2)};
+	{
+		ColumnWriter writer(path);
+		writer.Add("position", QuantitySpan<const FastLength>(positions));
+	}
+
+	ColumnFile file(path);
+	EXPECT_THROW(file.Column<FastSpeed>("position"), DimensionMismatch);
+	EXPECT_THROW(file.Column<FastLength>("speed"), SerializationError);
+
+	EXPECT_THROW(ColumnFile("/nonexistent/btul.cols"), system_error);
+
+	// An index entry too small to hold even the column's header.
+	string bytes;
+	{
+		ifstream in(path, ios::binary);
+		bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+	detail::columns::Trailer trailer;
+	memcpy(&trailer, &bytes[bytes.size() - sizeof(trailer)], sizeof(trailer));
+	detail::columns::Entry entry;
+	memcpy(&entry, &bytes[trailer.indexOffset], sizeof(entry));
+	entry.size = 8;
+	memcpy(&bytes[trailer.indexOffset], &entry, sizeof(entry));
+	{
+		ofstream out(path, ios::binary | ios::trunc);
+		out << bytes;
+	}
+	ColumnFile truncated(path);
+	EXPECT_THROW(truncated.Header("position"), SerializationError);
+	EXPECT_THROW(truncated.Column<FastLength>("position"), SerializationError);
+
+	ofstream garbage(path, ios::binary | ios::trunc);
+	garbage << string(100, 'x');
+	garbage.close();
+	EXPECT_THROW(ColumnFile file(path), SerializationError);
+}
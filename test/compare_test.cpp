@@ -0,0 +1,136 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_compare.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, float> FloatLength;
+
+TEST(CompareTest, test00_ulpDistance) {
+	double one = 1;
+	EXPECT_EQ(0u, UlpDistance(FastLength(one), FastLength(one)));
+	EXPECT_EQ(1u, UlpDistance(FastLength(one), FastLength(nextafter(one, 2.0))));
+	EXPECT_EQ(2u, UlpDistance(FastLength(nextafter(one, 0.0)),
+				  FastLength(nextafter(one, 2.0))));
+	EXPECT_EQ(0u, UlpDistance(FastLength(0.0), FastLength(-0.0)));
+
+	// The smallest subnormals on either side of zero are two apart.
+	double tiny = numeric_limits<double>::denorm_min();
+	EXPECT_EQ(2u, UlpDistance(FastLength(-tiny), FastLength(tiny)));
+
+	EXPECT_EQ(1u, UlpDistance(FloatLength(1.0f), FloatLength(nextafter(1.0f, 2.0f))));
+
+	long double big = 1e300L;
+	EXPECT_EQ(1u, UlpDistance(Length(big), Length(nextafter(big, 1e301L))));
+	EXPECT_EQ(3u, UlpDistance(Length(-numeric_limits<long double>::denorm_min()),
+				  Length(2 * numeric_limits<long double>::denorm_min())));
+	EXPECT_EQ(1u, UlpDistance(Length(numeric_limits<long double>::min()),
+				  Length(nextafter(numeric_limits<long double>::min(), 0.0L))));
+
+	double nan = numeric_limits<double>::quiet_NaN();
+	EXPECT_EQ(numeric_limits<uint64_t>::max(), UlpDistance(FastLength(nan), FastLength(nan)));
+	EXPECT_FALSE(WithinUlps(FastLength(nan), FastLength(nan), 1000));
+
+	EXPECT_TRUE(WithinUlps(FastLength(0.1 + 0.2), FastLength(0.3), 1));
+	EXPECT_FALSE(WithinUlps(FastLength(0.1 + 0.2), FastLength(0.3), 0));
+	EXPECT_TRUE(WithinUlps(1_km, 1000_m, 0));
+}
+
+TEST(CompareTest, test01_tolerance) {
+	EXPECT_TRUE(WithinTolerance(1_km, 1001_m, 0_m, 1e-3));
+	EXPECT_FALSE(WithinTolerance(1_km, 1002_m, 0_m, 1e-3));
+
+	// Near zero, only the absolute tolerance helps.
+	EXPECT_FALSE(WithinTolerance(1e-20_m, -1e-20_m, 0_m, 0.5));
+	EXPECT_TRUE(WithinTolerance(1e-20_m, -1e-20_m, 1_nm, 0.5));
+
+	EXPECT_FALSE(WithinTolerance(FastLength(numeric_limits<double>::quiet_NaN()),
+				     FastLength(0), 1_m, 1.0));
+}
+
+TEST(CompareTest, test02_within) {
+	EXPECT_TRUE(m.Within(0, m));
+	EXPECT_TRUE((1_m).Within(0.5, 1.5_m));
+	EXPECT_TRUE((1.5_m).Within(0.5, 1_m));
+	EXPECT_FALSE((1_m).Within(0.4, 1.5_m));
+	EXPECT_FALSE((1.5_m).Within(0.4, 1_m));
+}
+
+TEST(CompareTest, test03_bulk) {
+	vector<FastLength> computed;
+	vector<FastLength> expected;
+	for (int i = 0; i < 1000; ++i) {
+		double value = 1.0 + i;
+		expected.push_back(FastLength(value));
+		// Every third value is off by i % 7 ulps.
+		for (int j = 0; j < (i % 3 == 0 ? i % 7 : 0); ++j) {
+			value = nextafter(value, 1e9);
+		}
+		computed.push_back(FastLength(value));
+	}
+	computed[10] = FastLength(numeric_limits<double>::quiet_NaN());
+
+	size_t within = 0;
+	for (size_t i = 0; i < computed.size(); ++i) {
+		within += WithinUlps(computed[i], expected[i], 3);
+	}
+
+	EXPECT_EQ(within, CountWithinUlps(QuantitySpan<const FastLength>(computed),
+					  QuantitySpan<const FastLength>(expected),
+					  3));
+
+	vector<uint8_t> mask(computed.size());
+	MaskWithinUlps(QuantitySpan<const FastLength>(computed),
+		       QuantitySpan<const FastLength>(expected),
+		       3,
+		       QuantitySpan<uint8_t>(mask));
+	for (size_t i = 0; i < computed.size(); ++i) {
+		EXPECT_EQ(WithinUlps(computed[i], expected[i], 3), bool(mask[i]));
+	}
+	EXPECT_EQ(0, mask[10]);
+
+	EXPECT_EQ(999u, CountWithinTolerance(QuantitySpan<const FastLength>(computed),
+					     QuantitySpan<const FastLength>(expected),
+					     0_m, 1e-14));
+	MaskWithinTolerance(QuantitySpan<const FastLength>(computed),
+			    QuantitySpan<const FastLength>(expected),
+			    0_m, 1e-17,
+			    QuantitySpan<uint8_t>(mask));
+	EXPECT_EQ(1, mask[0]);
+	EXPECT_EQ(0, mask[3]);
+	EXPECT_EQ(1, mask[4]);
+
+	vector<Length> precise(expected.begin(), expected.end());
+	EXPECT_EQ(1000u, CountWithinUlps(QuantitySpan<const Length>(precise),
+					 QuantitySpan<const Length>(precise),
+					 0));
+}
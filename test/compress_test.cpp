@@ -0,0 +1,229 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_compress.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, float> SmallLength;
+typedef Quantity<0, 0, 0, 0, 1, 0, 0, double> FastTemperature;
+
+template <class Q>
+static vector<Q> decodeAll(const vector<char>& data) {
+	SeriesDecoder<Q> decoder(data.data(), data.size());
+	vector<Q> values(decoder.Size());
+	EXPECT_EQ(values.size(), decoder.Decode(0, values));
+	return values;
+}
+
+template <class Q>
+static bool sameBits(Q a, Q b) {
+	return memcmp(&a, &b, sizeof(Q)) == 0;
+}
+
+TEST(CompressTest, test00_bits) {
+	mt19937_64 engine(1);
+	vector<pair<uint64_t, unsigned>> written;
+	detail::compress::BitWriter writer;
+	for (int i = 0; i < 10000; ++i) {
+		unsigned n = unsigned(engine() % 65);
+		uint64_t value = n == 0 ? 0 : engine() & (~uint64_t(0) >> (64 - n));
+		writer.Write(value, n);
+		written.emplace_back(value, n);
+	}
+	vector<char> bytes;
+	writer.AppendTo(bytes);
+	EXPECT_EQ(writer.Size(), bytes.size());
+
+	detail::compress::BitReader reader(bytes.data(), bytes.data() + bytes.size());
+	for (const auto& bits : written) {
+		ASSERT_EQ(bits.first, reader.Read(bits.second)) << bits.second;
+	}
+}
+
+TEST(CompressTest, test01_values) {
+	// A slowly varying series with repeats, and every special value.
+	vector<FastTemperature> temperatures;
+	mt19937_64 engine(2);
+	normal_distribution<double> noise(0, 0.01);
+	double t = 293.15;
+	for (int i = 0; i < 5000; ++i) {
+		if (i % 3 != 0) {
+			t += std::round(noise(engine) * 1000) / 1000;
+		}
+		temperatures.push_back(FastTemperature(t));
+	}
+	for (double special : {0.0, -0.0, numeric_limits<double>::infinity(),
+			       numeric_limits<double>::quiet_NaN(), numeric_limits<double>::denorm_min(),
+			       numeric_limits<double>::max(), -1e-300}) {
+		temperatures.push_back(FastTemperature(special));
+	}
+
+	for (size_t blockSize : {1u, 7u, 1024u, 100000u}) {
+		SeriesEncoder<FastTemperature> encoder(blockSize);
+		encoder.Append(QuantitySpan<const FastTemperature>(temperatures));
+		encoder.Flush();
+		EXPECT_EQ(temperatures.size(), encoder.Size());
+		vector<FastTemperature> copy = decodeAll<FastTemperature>(encoder.Data());
+		ASSERT_EQ(temperatures.size(), copy.size());
+		for (size_t i = 0; i < copy.size(); ++i) {
+			ASSERT_TRUE(sameBits(temperatures[i], copy[i])) << blockSize << " " << i;
+		}
+		if (blockSize == 1024) {
+			EXPECT_LT(encoder.Data().size(), temperatures.size() * sizeof(double) / 2);
+		}
+	}
+
+	// Floats, and a constant series, which takes a bit per value.
+	vector<SmallLength> lengths(4096, SmallLength(1.5f));
+	SeriesEncoder<SmallLength> encoder(4096);
+	encoder.Append(QuantitySpan<const SmallLength>(lengths));
+	encoder.Flush();
+	EXPECT_EQ(sizeof(SeriesBlockHeader) + 4 + 4095 / 8 + 1, encoder.Data().size());
+	vector<SmallLength> copy = decodeAll<SmallLength>(encoder.Data());
+	ASSERT_EQ(lengths.size(), copy.size());
+	EXPECT_EQ(1.5f, copy.back().Value());
+}
+
+TEST(CompressTest, test02_times) {
+	// Samples every millisecond with some jitter, and an hour's gap.
+	mt19937_64 engine(3);
+	vector<Time> times;
+	vector<FastLength> lengths;
+	long long tick = 1000000000000ll;
+	for (int i = 0; i < 3000; ++i) {
+		tick += 1000000 + (i % 10 == 0 ? long(engine() % 2001) - 1000 : 0);
+		tick += i == 1500 ? 3600000000000ll : 0;
+		times.push_back(Time(tick * 1e-9L));
+		lengths.push_back(FastLength(0.001 * i));
+	}
+
+	SeriesEncoder<FastLength> encoder(256);
+	encoder.Append(QuantitySpan<const Time>(times), QuantitySpan<const FastLength>(lengths));
+	encoder.Flush();
+	const vector<char>& data = encoder.Data();
+	SeriesDecoder<FastLength> decoder(data.data(), data.size());
+	EXPECT_TRUE(decoder.HasTimes());
+	EXPECT_EQ(12u, decoder.Blocks());
+	ASSERT_EQ(3000u, decoder.Size());
+
+	// Decoding from the middle of a block, to past the end.
+	vector<Time> timesRead(1000);
+	vector<FastLength> lengthsRead(1000);
+	ASSERT_EQ(700u, decoder.Decode(2300, timesRead, lengthsRead));
+	for (size_t i = 0; i < 700; ++i) {
+		ASSERT_NEAR(double(times[2300 + i].Value()), double(timesRead[i].Value()), 1e-12) << i;
+		ASSERT_EQ(lengths[2300 + i].Value(), lengthsRead[i].Value()) << i;
+	}
+
+	// Only as many as fit in the shorter span.
+	vector<Time> fewTimes(10, Time(-1));
+	ASSERT_EQ(10u, decoder.Decode(100, fewTimes, lengthsRead));
+	EXPECT_EQ(lengths[109].Value(), lengthsRead[9].Value());
+	EXPECT_EQ(lengths[2310].Value(), lengthsRead[10].Value());
+	EXPECT_NEAR(double(times[109].Value()), double(fewTimes[9].Value()), 1e-12);
+
+	SeriesEncoder<FastLength> mismatched;
+	EXPECT_THROW(mismatched.Append(QuantitySpan<const Time>(fewTimes),
+				       QuantitySpan<const FastLength>(lengths)), invalid_argument);
+	mismatched.Flush();
+	EXPECT_TRUE(mismatched.Data().empty());
+
+	EXPECT_EQ(0u, decoder.Find(Time(0)));
+	EXPECT_EQ(1u, decoder.Find(times[0] + 1_us));
+	EXPECT_EQ(1200u, decoder.Find(times[1200] - 1_ns / 2));
+	EXPECT_EQ(1500u, decoder.Find(times[1500] - 1_s));
+	EXPECT_EQ(2500u, decoder.Find(times[1500] + 999.5_ms));
+	EXPECT_EQ(3000u, decoder.Find(times.back() + 1_s));
+}
+
+TEST(CompressTest, test03_streaming) {
+	// Blocks saved as they fill, and appended to each other, read back
+	// as one series.
+	SeriesEncoder<FastLength> encoder(100);
+	vector<char> saved;
+	for (int i = 0; i < 1050; ++i) {
+		encoder.Append(Time(i * 1e-3L), FastLength(i));
+		if (i % 250 == 0) {
+			saved.insert(saved.end(), encoder.Data().begin(), encoder.Data().end());
+			encoder.ClearData();
+		}
+	}
+	encoder.Flush();
+	saved.insert(saved.end(), encoder.Data().begin(), encoder.Data().end());
+
+	vector<FastLength> lengths = decodeAll<FastLength>(saved);
+	ASSERT_EQ(1050u, lengths.size());
+	for (int i = 0; i < 1050; ++i) {
+		ASSERT_EQ(i, lengths[i].Value());
+	}
+
+	EXPECT_THROW(encoder.Append(FastLength(1)), SerializationError);
+}
+
+TEST(CompressTest, test04_validation) {
+	SeriesEncoder<FastLength> encoder;
+	encoder.Append(FastLength(1));
+	encoder.Append(FastLength(2));
+	encoder.Flush();
+	vector<char> data = encoder.Data();
+
+	EXPECT_THROW(SeriesDecoder<SmallLength>(data.data(), data.size()), DimensionMismatch);
+	EXPECT_THROW(SeriesDecoder<FastTemperature>(data.data(), data.size()), DimensionMismatch);
+	EXPECT_THROW(SeriesDecoder<FastLength>(data.data(), data.size() - 1), SerializationError);
+	EXPECT_THROW(SeriesDecoder<FastLength>(data.data(), 10), SerializationError);
+
+	SeriesDecoder<FastLength> decoder(data.data(), data.size());
+	EXPECT_FALSE(decoder.HasTimes());
+	EXPECT_THROW(decoder.Find(Time(0)), SerializationError);
+
+	// Headers in the other byte order are converted.
+	SeriesBlockHeader header;
+	memcpy(&header, data.data(), sizeof(header));
+	header.endianness = header.endianness == QuantityHeader::LITTLE_ENDIAN_ORDER ?
+			    QuantityHeader::BIG_ENDIAN_ORDER : QuantityHeader::LITTLE_ENDIAN_ORDER;
+	detail::compress::swap(header.count);
+	detail::compress::swap(header.timeBytes);
+	detail::compress::swap(header.valueBytes);
+	detail::compress::swap(header.first);
+	detail::compress::swap(header.firstTick);
+	detail::compress::swap(header.resolution);
+	memcpy(&data[0], &header, sizeof(header));
+	vector<FastLength> lengths = decodeAll<FastLength>(data);
+	ASSERT_EQ(2u, lengths.size());
+	EXPECT_EQ(2, lengths[1].Value());
+
+	data[0] = 'X';
+	EXPECT_THROW(SeriesDecoder<FastLength>(data.data(), data.size()), SerializationError);
+}
@@ -0,0 +1,78 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_constants.h>
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Everything below folds at compile time.
+constexpr auto photonEnergy = constants::h * constants::c / 500_nm;
+static_assert(photonEnergy.Value() > 3.97e-19 && photonEnergy.Value() < 3.98e-19,
+	      "h c / lambda is a constant expression");
+static_assert(decltype(photonEnergy)::length == 2 &&
+	      decltype(photonEnergy)::mass == 1 &&
+	      decltype(photonEnergy)::time == -2,
+	      "h c / lambda is an energy");
+static_assert(decltype(constants::epsilon_0)::length == -3 &&
+	      decltype(constants::epsilon_0)::mass == -1 &&
+	      decltype(constants::epsilon_0)::time == 4 &&
+	      decltype(constants::epsilon_0)::current == 2,
+	      "Permittivity is A² s⁴ / (kg m³)");
+
+template <class Q>
+static string print(const Q& q) {
+	ostringstream stream;
+	stream << q;
+	return stream.str();
+}
+
+TEST(ConstantsTest, test00_derivedConstants) {
+	EXPECT_NEAR(8.314462618, constants::R.Value(), 1e-9);
+	EXPECT_NEAR(96485.33212, constants::F.Value(), 1e-5);
+	EXPECT_NEAR(1.054571817e-34, constants::hbar.Value(), 1e-43);
+	EXPECT_NEAR(5.670374419e-8, constants::sigma.Value(), 1e-17);
+	EXPECT_NEAR(483597.8484e9, constants::K_J.Value(), 1e5);
+	EXPECT_NEAR(25812.80745, constants::R_K.Value(), 1e-5);
+	EXPECT_NEAR(8.8541878128e-12, constants::epsilon_0.Value(), 1e-21);
+
+	// mu_0 = 2 alpha h / (e^2 c), to the precision of alpha.
+	auto mu_0 = 2 * constants::alpha * constants::h / (constants::e * constants::e * constants::c);
+	EXPECT_NEAR(constants::mu_0.Value(), mu_0.Value(), 1e-15);
+	// R_inf = alpha^2 m_e c / (2 h).
+	auto R_inf = constants::alpha * constants::alpha * constants::m_e * constants::c /
+		     (2 * constants::h);
+	EXPECT_NEAR(constants::R_inf.Value(), R_inf.Value(), 1e-3);
+}
+
+TEST(ConstantsTest, test01_printing) {
+	EXPECT_EQ("2.99792e+08 m/s", print(constants::c));
+	EXPECT_EQ("6.02214e+23 mol⁻¹", print(constants::N_A));
+	EXPECT_EQ("8.31446 m²·kg/(s²·K·mol)", print(constants::R));
+	EXPECT_EQ("683 s³·cd/(m²·kg)", print(constants::K_cd));
+	EXPECT_EQ("8.85419e-12 s⁴·A²/(m³·kg)", print(constants::epsilon_0));
+}
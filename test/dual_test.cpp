@@ -0,0 +1,136 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_dual.h>
+#include <btul_math.h>
+
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+typedef Dual<double, 1> D;
+typedef Dual<double, 2> D2;
+
+TEST(DualTest, test00_arithmetic) {
+	// f(x) = 3x² + 2/x - (1 - x), f'(x) = 6x - 2/x² + 1.
+	D x = D::Variable(2);
+	D f = 3 * x * x + 2 / x - (1 - x);
+	EXPECT_DOUBLE_EQ(14, f.Value());
+	EXPECT_DOUBLE_EQ(12.5, f.Tangent());
+
+	D g = x;
+	g += 1;
+	g *= x;
+	g /= 2;
+	g -= x;
+	// g(x) = (x + 1)x/2 - x, g'(x) = x - 1/2.
+	EXPECT_DOUBLE_EQ(1, g.Value());
+	EXPECT_DOUBLE_EQ(1.5, g.Tangent());
+
+	EXPECT_DOUBLE_EQ(-1, (-x).Tangent());
+	EXPECT_DOUBLE_EQ(2, (x++).Value());
+	EXPECT_DOUBLE_EQ(3, x.Value());
+	EXPECT_DOUBLE_EQ(1, x.Tangent());
+	EXPECT_DOUBLE_EQ(0, D(5).Tangent());
+
+	EXPECT_TRUE(D(1) < x);
+	EXPECT_TRUE(D::Variable(3) == x);
+}
+
+TEST(DualTest, test01_tangents) {
+	// f(x, y) = xy + y/x, ∂f/∂x = y - y/x², ∂f/∂y = x + 1/x.
+	D2 x = D2::Variable(2, 0);
+	D2 y = D2::Variable(3, 1);
+	D2 f = x * y + y / x;
+	EXPECT_DOUBLE_EQ(7.5, f.Value());
+	EXPECT_DOUBLE_EQ(2.25, f.Tangent(0));
+	EXPECT_DOUBLE_EQ(2.5, f.Tangent(1));
+}
+
+TEST(DualTest, test02_quantities) {
+	auto x = Variable(0.2_m);
+	auto energy = 0.5 * 300_N / m * x.p2();
+	Energy stored = ValueOf(energy);
+	EXPECT_NEAR(6, stored.Value(), 1e-12);
+
+	// The derivative has the quotient dimension.
+	Force restoring = Derivative(energy, x);
+	EXPECT_NEAR(60, restoring.Value(), 1e-12);
+
+	auto displacement = Variable<2>(0.2_m, 0);
+	auto stiffness = Variable<2>(300_N / m, 1);
+	auto work = 0.5 * stiffness * displacement.p2();
+	Force force = Derivative(work, displacement);
+	Area sensitivity = Derivative(work, stiffness);
+	EXPECT_NEAR(60, force.Value(), 1e-12);
+	EXPECT_NEAR(0.02, sensitivity.Value(), 1e-12);
+
+	auto time = Variable(2_s);
+	auto speed = 10_m / time;
+	Quantity<1, 0, -2, 0, 0, 0, 0> acceleration = Derivative(speed, time);
+	EXPECT_NEAR(-2.5, acceleration.Value(), 1e-12);
+
+	ostringstream stream;
+	stream << Variable(3_m);
+	EXPECT_EQ("3 + [1]ε m", stream.str());
+}
+
+TEST(DualTest, test03_math) {
+	auto x = Variable<2>(3_m, 0);
+	auto y = Variable<2>(4_m, 1);
+
+	auto r = sqrt(x.p2() + y.p2());
+	EXPECT_NEAR(5, ValueOf(r).Value(), 1e-12);
+	double dx = Derivative(r, x).Value();
+	double dy = Derivative(r, y).Value();
+	EXPECT_NEAR(0.6, dx, 1e-12);
+	EXPECT_NEAR(0.8, dy, 1e-12);
+
+	auto h = hypot(x, y);
+	EXPECT_NEAR(0.6, Derivative(h, x).Value(), 1e-12);
+	EXPECT_NEAR(0.8, Derivative(h, y).Value(), 1e-12);
+
+	EXPECT_NEAR(27, Derivative(x.p3(), x).Value(), 1e-12);
+	EXPECT_NEAR(-1.0 / 9, Derivative(x.n1(), x).Value(), 1e-12);
+	EXPECT_NEAR(1, Derivative(x.p0() * x, x).Value(), 1e-12);
+
+	auto volume = Variable(-8_m * m * m);
+	EXPECT_NEAR(1.0 / 12, Derivative(cbrt(volume), volume).Value(), 1e-12);
+	auto hypervolume = Variable(16_m * m * m * m);
+	EXPECT_NEAR(1.0 / 32, Derivative(root<4>(hypervolume), hypervolume).Value(), 1e-12);
+
+	EXPECT_NEAR(-1, Derivative(abs(x - 10_m), x).Value(), 1e-12);
+	EXPECT_NEAR(1, Derivative(max(x, y), y).Value(), 1e-12);
+	EXPECT_NEAR(0, Derivative(max(x, y), x).Value(), 1e-12);
+	EXPECT_NEAR(0, Derivative(floor(x), x).Value(), 1e-12);
+
+	// fmod(y, x) = y - x for 4 m and 3 m.
+	EXPECT_NEAR(-1, Derivative(fmod(y, x), x).Value(), 1e-12);
+	EXPECT_NEAR(1, Derivative(fmod(y, x), y).Value(), 1e-12);
+
+	auto product = fma(x, y, x * y);
+	EXPECT_NEAR(8, Derivative(product, x).Value(), 1e-12);
+}
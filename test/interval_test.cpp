@@ -0,0 +1,215 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_interval.h>
+#include <btul_math.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+typedef Interval<double> I;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, I> BoundedLength;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, I> BoundedMass;
+typedef Quantity<1, 1, -2, 0, 0, 0, 0, I> BoundedForce;
+typedef Quantity<2, 1, -2, 0, 0, 0, 0, I> BoundedEnergy;
+
+TEST(IntervalTest, test00_outwardRounding) {
+	mt19937_64 generator(1);
+	uniform_real_distribution<double> mantissa(-1, 1);
+	uniform_int_distribution<int> exponent(-1060, 1020);
+	for (int i = 0; i < 100000; ++i) {
+		double x = ldexp(mantissa(generator), exponent(generator));
+		ASSERT_LE(detail::interval::down(x), nextafter(x, -numeric_limits<double>::infinity()));
+		ASSERT_GE(detail::interval::up(x), nextafter(x, numeric_limits<double>::infinity()));
+	}
+
+	EXPECT_EQ(numeric_limits<double>::max(),
+		  detail::interval::down(numeric_limits<double>::infinity()));
+	EXPECT_EQ(-numeric_limits<double>::max(),
+		  detail::interval::up(-numeric_limits<double>::infinity()));
+}
+
+TEST(IntervalTest, test01_arithmetic) {
+	I tenth(0.1);
+	I sum = tenth + tenth + tenth;
+	EXPECT_TRUE(sum.Contains(0.30000000000000004));
+	EXPECT_LT(sum.Lower(), sum.Upper());
+	EXPECT_LT(sum.Upper() - sum.Lower(), 1e-15);
+
+	// A long double that is not a double is bracketed by its neighbours.
+	I third(1.0L / 3);
+	EXPECT_EQ(nextafter(third.Lower(), 1.0), third.Upper());
+	EXPECT_LT(static_cast<long double>(third.Lower()), 1.0L / 3);
+	EXPECT_GT(static_cast<long double>(third.Upper()), 1.0L / 3);
+
+	I product = I(-2, 3) * I(-5, 4);
+	EXPECT_TRUE(product.Contains(-15) && product.Contains(12));
+	EXPECT_GT(product.Lower(), -15.000001);
+	EXPECT_LT(product.Upper(), 12.000001);
+
+	I difference = I(1, 2) - I(0.5, 1);
+	EXPECT_TRUE(difference.Contains(0) && difference.Contains(1.5));
+
+	I quotient = I(1, 2) / I(4, 8);
+	EXPECT_TRUE(quotient.Contains(0.125) && quotient.Contains(0.5));
+	EXPECT_FALSE(quotient.Contains(0.12) || quotient.Contains(0.51));
+
+	I unbounded = I(1, 2) / I(-1, 1);
+	EXPECT_EQ(-numeric_limits<double>::infinity(), unbounded.Lower());
+	EXPECT_EQ(numeric_limits<double>::infinity(), unbounded.Upper());
+
+	// Zero times infinity is zero.
+	I zeroed = I(0, 1) * unbounded;
+	EXPECT_TRUE(zeroed.Contains(0));
+
+	EXPECT_EQ(I(-3, -1), -I(1, 3));
+	EXPECT_TRUE(I(1, 2) < I(3, 4));
+	EXPECT_FALSE(I(1, 3) < I(2, 4));
+	EXPECT_FALSE(I(1, 3) >= I(2, 4));
+
+	I counter(1);
+	counter += 2;
+	counter *= 2;
+	EXPECT_TRUE(counter.Contains(6));
+	EXPECT_TRUE((counter++).Contains(6));
+	EXPECT_TRUE(counter.Contains(7));
+}
+
+TEST(IntervalTest, test02_quantities) {
+	BoundedMass mass = I(9.99, 10.01) * kg;
+	BoundedForce weight = mass * 9.81_m / s.p2();
+	EXPECT_TRUE(weight.Value().Contains(9.99 * 9.81));
+	EXPECT_TRUE(weight.Value().Contains(10.01 * 9.81));
+
+	BoundedEnergy work = weight * I(1, 2) * m;
+	EXPECT_TRUE(work.Value().Contains(9.99 * 9.81));
+	EXPECT_TRUE(work.Value().Contains(2 * 10.01 * 9.81));
+
+	// Converting from a long double quantity widens where needed.
+	BoundedLength length = 0.1_m;
+	EXPECT_TRUE(length.Value().Contains(0.1));
+	EXPECT_TRUE(static_cast<long double>(length.Value().Lower()) <= 0.1L &&
+		    static_cast<long double>(length.Value().Upper()) >= 0.1L);
+
+	BoundedLength total = length + 2_m;
+	total -= m;
+	total *= 3;
+	total /= 3;
+	EXPECT_TRUE(total.Value().Contains(1.1));
+	EXPECT_TRUE(BoundedLength(I(1, 2)) < BoundedLength(I(3, 4)));
+
+	ostringstream stream;
+	stream << BoundedLength(I(1, 2));
+	EXPECT_EQ("[1, 2] m", stream.str());
+}
+
+TEST(IntervalTest, test03_powers) {
+	BoundedLength length(I(-1, 2));
+
+	auto area = length.p2();
+	static_assert(decltype(area)::length == 2, "p2 should square the dimensions");
+	EXPECT_EQ(0, area.Value().Lower());
+	EXPECT_TRUE(area.Value().Contains(4));
+	EXPECT_LT(area.Value().Upper(), 4.000001);
+
+	auto volume = length.p3();
+	EXPECT_TRUE(volume.Value().Contains(-1) && volume.Value().Contains(8));
+	EXPECT_GT(volume.Value().Lower(), -1.000001);
+
+	auto inverse = BoundedLength(I(2, 4)).n1();
+	EXPECT_TRUE(inverse.Value().Contains(0.25) && inverse.Value().Contains(0.5));
+
+	EXPECT_EQ(I(1), BoundedLength(I(2, 4)).p0().Value());
+}
+
+TEST(IntervalTest, test04_math) {
+	mt19937_64 generator(2);
+	uniform_real_distribution<double> mantissa(0.5, 1);
+	uniform_int_distribution<int> exponent(-1074, 1000);
+	for (int i = 0; i < 10000; ++i) {
+		double x = ldexp(mantissa(generator), exponent(generator));
+		// The sign of an fma is exact, so it checks the square root.
+		I r = sqrt(I(x));
+		ASSERT_LE(fma(r.Lower(), r.Lower(), -x), 0);
+		ASSERT_GE(fma(r.Upper(), r.Upper(), -x), 0);
+		ASSERT_LT(r.Upper() - r.Lower(), 1e-15 * r.Upper());
+
+		I c = cbrt(I(x));
+		ASSERT_LE(static_cast<long double>(c.Lower()) * c.Lower() * c.Lower(), x);
+		ASSERT_GE(static_cast<long double>(c.Upper()) * c.Upper() * c.Upper(), x);
+		ASSERT_LT(c.Upper() - c.Lower(), 1e-14 * c.Upper());
+	}
+
+	auto side = sqrt(Quantity<2, 0, 0, 0, 0, 0, 0, I>(I(4, 9)));
+	static_assert(decltype(side)::length == 1, "sqrt should halve the dimensions");
+	EXPECT_TRUE(side.Value().Contains(2) && side.Value().Contains(3));
+	EXPECT_GT(side.Value().Lower(), 1.999999);
+
+	auto odd = cbrt(Quantity<3, 0, 0, 0, 0, 0, 0, I>(I(-8, 27)));
+	EXPECT_TRUE(odd.Value().Contains(-2) && odd.Value().Contains(3));
+	EXPECT_LT(odd.Value().Upper(), 3.000001);
+
+	auto fourth = root<4>(Quantity<4, 0, 0, 0, 0, 0, 0, I>(I(-1, 16)));
+	EXPECT_EQ(0, fourth.Value().Lower());
+	EXPECT_TRUE(fourth.Value().Contains(2));
+
+	BoundedLength length(I(-3, 2));
+	EXPECT_EQ(I(0, 3), abs(length).Value());
+	EXPECT_EQ(I(-3, 1), min(length, BoundedLength(I(0, 1))).Value());
+	EXPECT_EQ(I(0, 2), max(length, BoundedLength(I(0, 1))).Value());
+	EXPECT_EQ(I(-3, 3), ceil(BoundedLength(I(-3.5, 2.5))).Value());
+
+	auto diagonal = hypot(BoundedLength(I(3)), BoundedLength(I(4)));
+	EXPECT_TRUE(diagonal.Value().Contains(5));
+	EXPECT_LT(diagonal.Value().Width(), 1e-14);
+}
+
+TEST(IntervalTest, test05_spans) {
+	vector<BoundedLength> x;
+	vector<BoundedMass> y;
+	for (int i = 0; i < 100; ++i) {
+		x.push_back(BoundedLength(I(i, i + 0.5)));
+		y.push_back(BoundedMass(I(-i, 1)));
+	}
+
+	vector<Quantity<1, 1, 0, 0, 0, 0, 0, I>> product(x.size());
+	Multiply(QuantitySpan<const BoundedLength>(x),
+		 QuantitySpan<const BoundedMass>(y),
+		 QuantitySpan<Quantity<1, 1, 0, 0, 0, 0, 0, I>>(product));
+	for (size_t i = 0; i < x.size(); ++i) {
+		EXPECT_EQ((x[i] * y[i]).Value(), product[i].Value());
+	}
+
+	vector<BoundedLength> sum(x.size());
+	Add(QuantitySpan<const BoundedLength>(x),
+	    QuantitySpan<const BoundedLength>(x),
+	    QuantitySpan<BoundedLength>(sum));
+	EXPECT_TRUE(sum[10].Value().Contains(20) && sum[10].Value().Contains(21));
+}
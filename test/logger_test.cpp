@@ -0,0 +1,113 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_logger.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, -1, 0, 0, 0, 0, double> FastSpeed;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, float> SmallMass;
+
+TEST(LoggerTest, test00_format) {
+	ostringstream stream;
+	ostringstream expected;
+	{
+		QuantityLogger logger(stream, false);
+		EXPECT_TRUE(logger.Log("speed", FastSpeed(12.5)));
+		EXPECT_TRUE(logger.Log("mass", SmallMass(0.25f)));
+		EXPECT_TRUE(logger.Log("force", 3_N));
+		EXPECT_TRUE(logger.Log(nullptr, 2_m * 3_s));
+		EXPECT_EQ("", stream.str());
+		EXPECT_EQ(4u, logger.Drain());
+		EXPECT_EQ(0u, logger.Drain());
+
+		expected << "speed " << FastSpeed(12.5) << '\n'
+			 << "mass " << SmallMass(0.25f) << '\n'
+			 << "force " << 3_N << '\n'
+			 << 2_m * 3_s << '\n';
+		EXPECT_EQ(expected.str(), stream.str());
+
+		// Whatever is left is written out on destruction.
+		logger.Log("last", 1_s);
+	}
+	EXPECT_EQ(expected.str() + "last 1 s\n", stream.str());
+}
+
+TEST(LoggerTest, test01_threads) {
+	ostringstream stream;
+	const int perThread = 20000;
+	{
+		QuantityLogger logger(stream);
+		vector<thread> threads;
+		static const char* labels[] = {"a", "b", "c", "d"};
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				for (int i = 0; i < perThread; ++i) {
+					while (!logger.Log(labels[t], FastSpeed(i))) {
+						this_thread::yield();
+					}
+				}
+			});
+		}
+		for (thread& t : threads) {
+			t.join();
+		}
+	}
+
+	// Every record, in order within each thread.
+	map<string, int> next;
+	istringstream lines(stream.str());
+	string label;
+	double value;
+	string unit;
+	while (lines >> label >> value >> unit) {
+		ASSERT_EQ(next[label], value) << label;
+		ASSERT_EQ("m/s", unit);
+		++next[label];
+	}
+	ASSERT_EQ(4u, next.size());
+	for (const auto& count : next) {
+		EXPECT_EQ(perThread, count.second) << count.first;
+	}
+}
+
+TEST(LoggerTest, test02_full) {
+	ostringstream stream;
+	QuantityLogger logger(stream, false);
+	size_t logged = 0;
+	for (int i = 0; i < 10000; ++i) {
+		logged += logger.Log("x", FastSpeed(i));
+	}
+	EXPECT_EQ(8192u, logged);
+	EXPECT_EQ(10000u - logged, logger.Dropped());
+	EXPECT_EQ(logged, logger.Drain());
+	EXPECT_TRUE(logger.Log("x", FastSpeed(1)));
+}
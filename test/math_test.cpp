@@ -0,0 +1,182 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_math.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<2, 0, 0, 0, 0, 0, 0, double> FastArea;
+
+TEST(MathTest, test00_roots) {
+	Length side = sqrt(9_m_p2);
+	EXPECT_EQ(3, side.Value());
+
+	Length edge = cbrt(27_m_p3);
+	EXPECT_NEAR(3, edge.Value(), 1e-15);
+
+	Time period = sqrt(4_s_p2);
+	EXPECT_EQ(2, period.Value());
+
+	// The root of s⁻² is Hz.
+	Frequency frequency = sqrt(16_s_n2);
+	EXPECT_EQ(4, frequency.Value());
+}
+
+TEST(MathTest, test01_dimensionPreservingFunctions) {
+	EXPECT_EQ(3, abs(-3_m).Value());
+	EXPECT_EQ(2, floor(2.5_s).Value());
+	EXPECT_EQ(3, ceil(2.5_s).Value());
+	EXPECT_EQ(3, round(2.5_s).Value());
+	EXPECT_EQ(-3, round(-2.5_s).Value());
+}
+
+TEST(MathTest, test02_binaryFunctions) {
+	Length diagonal = hypot(3_m, 4_m);
+	EXPECT_EQ(5, diagonal.Value());
+
+	Time remainder = fmod(7_s, 3_s);
+	EXPECT_EQ(1, remainder.Value());
+
+	EXPECT_EQ(2, min(2_m, 3_m).Value());
+	EXPECT_EQ(3, max(2_m, 3_m).Value());
+
+	Length notANumber = Length(numeric_limits<long double>::quiet_NaN());
+	EXPECT_EQ(2, min(notANumber, 2_m).Value());
+	EXPECT_EQ(2, max(2_m, notANumber).Value());
+}
+
+TEST(MathTest, test03_fma) {
+	Energy work = fma(2_N, 3_m, 4_J);
+	EXPECT_NEAR(10, work.Value(), 1e-15);
+
+	Area area = fma(2_m, 3_m, 1_m_p2);
+	EXPECT_EQ(7, area.Value());
+}
+
+TEST(MathTest, test04_spans) {
+	vector<FastArea> areas;
+	for (int i = 0; i < 9; ++i) {
+		areas.push_back(FastArea(i * i));
+	}
+	vector<FastLength> sides(areas.size());
+
+	sqrt(QuantitySpan<const FastArea>(areas), QuantitySpan<FastLength>(sides));
+	for (int i = 0; i < 9; ++i) {
+		EXPECT_EQ(i, sides[i].Value());
+	}
+
+	vector<FastLength> negated(sides.size());
+	for (size_t i = 0; i < sides.size(); ++i) {
+		negated[i] = -sides[i];
+	}
+	vector<FastLength> result(sides.size());
+	abs(QuantitySpan<const FastLength>(negated), QuantitySpan<FastLength>(result));
+	for (int i = 0; i < 9; ++i) {
+		EXPECT_EQ(i, result[i].Value());
+	}
+
+	negated[3] = FastLength(numeric_limits<double>::quiet_NaN());
+	min(QuantitySpan<const FastLength>(negated),
+	    QuantitySpan<const FastLength>(sides),
+	    QuantitySpan<FastLength>(result));
+	for (int i = 0; i < 9; ++i) {
+		EXPECT_EQ(i == 3 ? 3 : -i, result[i].Value());
+	}
+
+	max(QuantitySpan<const FastLength>(negated),
+	    QuantitySpan<const FastLength>(sides),
+	    QuantitySpan<FastLength>(result));
+	for (int i = 0; i < 9; ++i) {
+		EXPECT_EQ(i, result[i].Value());
+	}
+
+	vector<FastArea> products(sides.size());
+	fma(QuantitySpan<const FastLength>(sides),
+	    QuantitySpan<const FastLength>(sides),
+	    QuantitySpan<const FastArea>(areas),
+	    QuantitySpan<FastArea>(products));
+	for (int i = 0; i < 9; ++i) {
+		EXPECT_EQ(2 * i * i, products[i].Value());
+	}
+}
+
+TEST(MathTest, test05_longDoubleSpans) {
+	Area areas[] = { 1_m_p2, 4_m_p2, 9_m_p2 };
+	Length sides[3];
+	sqrt(QuantitySpan<const Area>(areas), QuantitySpan<Length>(sides));
+	EXPECT_EQ(1, sides[0].Value());
+	EXPECT_EQ(3, sides[2].Value());
+
+	Length rounded[3];
+	Length lengths[] = { 1.4_m, 1.5_m, -1.5_m };
+	floor(QuantitySpan<const Length>(lengths), QuantitySpan<Length>(rounded));
+	EXPECT_EQ(-2, rounded[2].Value());
+	round(QuantitySpan<const Length>(lengths), QuantitySpan<Length>(rounded));
+	EXPECT_EQ(1, rounded[0].Value());
+	EXPECT_EQ(2, rounded[1].Value());
+}
+
+TEST(MathTest, test06_arrays) {
+	array<FastArea, 3> areas = {{ FastArea(1), FastArea(4), FastArea(9) }};
+	array<Quantity<1, 0, 0, 0, 0, 0, 0, double>, 3> sides = sqrt(areas);
+	EXPECT_EQ(2, sides[1].Value());
+
+	array<Length, 2> x = {{ 3_m, 5_m }};
+	array<Length, 2> y = {{ 4_m, 12_m }};
+	auto diagonals = hypot(x, y);
+	EXPECT_EQ(5, diagonals[0].Value());
+	EXPECT_EQ(13, diagonals[1].Value());
+
+	array<Length, 2> smaller = min(x, y);
+	EXPECT_EQ(3, smaller[0].Value());
+	EXPECT_EQ(5, smaller[1].Value());
+}
+
+TEST(MathTest, test07_rationalRoots) {
+	// A noise density, in units of s¹⁄².
+	auto density = 2_m / sqrt(4_Hz) / m;
+	static_assert(decltype(density)::time == 1 && decltype(density)::root == 2,
+		      "The time exponent should be 1/2");
+	EXPECT_EQ(1, density.Value());
+
+	Length side = sqrt(sqrt(16_m_p2) * 4_m);
+	EXPECT_EQ(4, side.Value());
+
+	auto fourth = root<4>(81_m);
+	static_assert(decltype(fourth)::length == 1 && decltype(fourth)::root == 4,
+		      "The length exponent should be 1/4");
+	EXPECT_NEAR(3, fourth.Value(), 1e-15);
+	Length back = fourth.p4();
+	EXPECT_NEAR(81, back.Value(), 1e-13);
+
+	EXPECT_NEAR(-2, root<5>(-32_m_p5).Value(), 1e-15);
+	EXPECT_NEAR(2, cbrt(sqrt(64_m)).p6().Value() / 32, 1e-15);
+}
@@ -0,0 +1,130 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_quantized.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<-1, 1, -2, 0, 0, 0, 0, double> FastPressure;
+typedef Quantity<-1, 1, -2, 0, 0, 0, 0, float> SmallPressure;
+typedef decltype(kg / m / s / s) Pressure;
+
+template <class Array, class Q>
+static void expectAccurate(const Array& array, const vector<Q>& values) {
+	ASSERT_EQ(values.size(), array.Size());
+	typename Q::type worst = 0;
+	for (size_t i = 0; i < values.size(); ++i) {
+		typename Q::type value = values[i].Value();
+		typename Q::type error = abs(array[i].Value() - value);
+		typename Q::type ulp = nextafter(value, 2 * value) - value;
+		ASSERT_LE(error, array.Step(i / 256).Value() / 2 + ulp) << i;
+		worst = max(worst, error);
+	}
+	EXPECT_EQ(worst, array.MaxError().Value());
+
+	// Bulk decoding agrees with single accesses, from anywhere.
+	vector<Q> decoded = array.Decode();
+	for (size_t i = 0; i < values.size(); ++i) {
+		ASSERT_EQ(array[i].Value(), decoded[i].Value()) << i;
+	}
+	vector<Q> window(300);
+	ASSERT_EQ(300u, array.Decode(1001, QuantitySpan<Q>(window)));
+	for (size_t i = 0; i < window.size(); ++i) {
+		ASSERT_EQ(array[1001 + i].Value(), window[i].Value()) << i;
+	}
+}
+
+TEST(QuantizedTest, test00_roundTrip) {
+	mt19937_64 engine(1);
+	normal_distribution<double> noise(0, 50);
+	vector<FastPressure> pressures;
+	vector<SmallPressure> smallPressures;
+	vector<Pressure> longPressures;
+	double p = 101325;
+	for (int i = 0; i < 10001; ++i) {
+		p += noise(engine);
+		pressures.push_back(FastPressure(p));
+		smallPressures.push_back(SmallPressure(float(p)));
+		longPressures.push_back(Pressure(p));
+	}
+
+	QuantizedArray<FastPressure> wide(pressures);
+	expectAccurate(wide, pressures);
+	EXPECT_LT(wide.MaxError().Value(), 0.1);
+
+	QuantizedArray<FastPressure, uint8_t, 64> narrow(pressures);
+	EXPECT_EQ(157u, narrow.Blocks());
+	ASSERT_EQ(pressures.size(), narrow.Size());
+	for (size_t i = 0; i < pressures.size(); ++i) {
+		ASSERT_LE(abs((narrow[i] - pressures[i]).Value()), narrow.Step(i / 64).Value() * 0.5001);
+	}
+	vector<FastPressure> decoded = narrow.Decode();
+	for (size_t i = 0; i < pressures.size(); ++i) {
+		ASSERT_EQ(narrow[i].Value(), decoded[i].Value()) << i;
+	}
+
+	expectAccurate(QuantizedArray<SmallPressure>(smallPressures), smallPressures);
+
+	// Long double is 8 times the size of a 16 bit code, less the blocks.
+	QuantizedArray<Pressure> compact(longPressures);
+	expectAccurate(compact, longPressures);
+	EXPECT_LT(compact.Bytes() * 7, longPressures.size() * sizeof(Pressure));
+}
+
+TEST(QuantizedTest, test01_edgeCases) {
+	QuantizedArray<FastPressure> empty(vector<FastPressure>{});
+	EXPECT_TRUE(empty.Empty());
+	EXPECT_EQ(0u, empty.Decode().size());
+	EXPECT_EQ(0, empty.MaxError().Value());
+
+	// Constant blocks are exact.
+	vector<FastPressure> values(300, FastPressure(7.25));
+	values[299] = FastPressure(-3);
+	QuantizedArray<FastPressure> constant(values);
+	EXPECT_EQ(7.25, constant[0].Value());
+	EXPECT_EQ(0, constant.Step(0).Value());
+	EXPECT_EQ(-3, constant[299].Value());
+	EXPECT_NEAR(7.25, constant[298].Value(), 1e-14);
+	EXPECT_LT(constant.MaxError().Value(), 1e-14);
+
+	// The whole range of double.
+	double max = numeric_limits<double>::max();
+	vector<FastPressure> extremes = {FastPressure(-max), FastPressure(0), FastPressure(max)};
+	QuantizedArray<FastPressure> huge(extremes);
+	EXPECT_TRUE(std::isfinite(huge[1].Value()));
+	EXPECT_LE(abs(huge[1].Value()), huge.Step(0).Value());
+
+	values[5] = FastPressure(numeric_limits<double>::quiet_NaN());
+	EXPECT_THROW(constant.Assign(values), domain_error);
+	EXPECT_EQ(300u, constant.Size());
+	EXPECT_EQ(7.25, constant[5].Value());
+}
@@ -0,0 +1,168 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_queue.h>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+constexpr int itemCount = 100000;
+
+template <class Queue>
+void testSingleThreaded() {
+	Queue queue;
+	Length item;
+	EXPECT_FALSE(queue.TryPop(item));
+
+	for (int i = 0; i < 8; ++i) {
+		EXPECT_TRUE(queue.TryPush(Length(i)));
+	}
+	EXPECT_FALSE(queue.TryPush(8_m));
+
+	EXPECT_TRUE(queue.TryPop(item));
+	EXPECT_EQ(0, item.Value());
+	EXPECT_TRUE(queue.TryPush(8_m));
+
+	for (int i = 1; i <= 8; ++i) {
+		EXPECT_TRUE(queue.TryPop(item));
+		EXPECT_EQ(i, item.Value());
+	}
+	EXPECT_FALSE(queue.TryPop(item));
+}
+
+template <class Queue>
+void testBatches() {
+	Queue queue;
+	Length in[6] = { 0_m, 1_m, 2_m, 3_m, 4_m, 5_m };
+	Length out[6];
+
+	EXPECT_EQ(6u, queue.PushBatch(in));
+	EXPECT_EQ(4u, queue.PopBatch(QuantitySpan<Length>(out, 4)));
+	EXPECT_EQ(3, out[3].Value());
+
+	// Wraps around the end of the storage, and only partly fits.
+	EXPECT_EQ(6u, queue.PushBatch(in));
+	EXPECT_EQ(0u, queue.PushBatch(in));
+
+	EXPECT_EQ(6u, queue.PopBatch(out));
+	EXPECT_EQ(4, out[0].Value());
+	EXPECT_EQ(5, out[1].Value());
+	EXPECT_EQ(0, out[2].Value());
+	EXPECT_EQ(3, out[5].Value());
+
+	EXPECT_EQ(2u, queue.PopBatch(out));
+	EXPECT_EQ(0u, queue.PopBatch(out));
+}
+
+TEST(QueueTest, test00_spscSingleThreaded) {
+	testSingleThreaded<SpscQuantityQueue<Length, 8>>();
+}
+
+TEST(QueueTest, test01_spscBatches) {
+	testBatches<SpscQuantityQueue<Length, 8>>();
+}
+
+TEST(QueueTest, test02_spscConcurrent) {
+	SpscQuantityQueue<Time, 64> queue;
+
+	thread producer([&] {
+		for (int i = 0; i < itemCount; ) {
+			if (queue.TryPush(Time(i))) {
+				++i;
+			}
+			else {
+				this_thread::yield();
+			}
+		}
+	});
+
+	Time batch[16];
+	for (int expected = 0; expected < itemCount; ) {
+		size_t n = queue.PopBatch(batch);
+		for (size_t i = 0; i < n; ++i, ++expected) {
+			ASSERT_EQ(expected, batch[i].Value());
+		}
+		if (n == 0) {
+			this_thread::yield();
+		}
+	}
+	producer.join();
+}
+
+TEST(QueueTest, test03_mpscSingleThreaded) {
+	testSingleThreaded<MpscQuantityQueue<Length, 8>>();
+}
+
+TEST(QueueTest, test04_mpscBatches) {
+	testBatches<MpscQuantityQueue<Length, 8>>();
+}
+
+TEST(QueueTest, test05_mpscConcurrent) {
+	constexpr int producerCount = 4;
+	MpscQuantityQueue<Time, 64> queue;
+
+	vector<thread> producers;
+	for (int p = 0; p < producerCount; ++p) {
+		producers.emplace_back([&, p] {
+			Time batch[3];
+			for (int i = 0; i < itemCount; ) {
+				size_t n = 0;
+				for (; n < 3 && i + int(n) < itemCount; ++n) {
+					batch[n] = Time(p * itemCount + i + n);
+				}
+				size_t pushed = queue.PushBatch(QuantitySpan<const Time>(batch, n));
+				i += pushed;
+				if (pushed < n) {
+					this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// Items from each producer must arrive in the order they were pushed.
+	vector<long double> last(producerCount, -1);
+	Time batch[16];
+	for (int received = 0; received < producerCount * itemCount; ) {
+		size_t n = queue.PopBatch(batch);
+		for (size_t i = 0; i < n; ++i) {
+			int p = int(batch[i].Value()) / itemCount;
+			ASSERT_LT(last[p], batch[i].Value());
+			last[p] = batch[i].Value();
+		}
+		received += n;
+		if (n == 0) {
+			this_thread::yield();
+		}
+	}
+	for (thread& t : producers) {
+		t.join();
+	}
+
+	for (int p = 0; p < producerCount; ++p) {
+		EXPECT_EQ((p + 1) * itemCount - 1, last[p]);
+	}
+}
@@ -0,0 +1,184 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_random.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+typedef Quantity<0, 1, 0, 0, 0, 0, 0, double> FastMass;
+
+template <class Q>
+static void moments(const vector<Q>& values, double& mean, double& deviation) {
+	double sum = 0, sumOfSquares = 0;
+	for (const Q& value : values) {
+		sum += value.Value();
+		sumOfSquares += value.Value() * value.Value();
+	}
+	mean = sum / values.size();
+	deviation = sqrt(sumOfSquares / values.size() - mean * mean);
+}
+
+TEST(RandomTest, test00_philoxKnownAnswers) {
+	// The known-answer vectors of the Random123 distribution.
+	Philox4x32::Block zero = detail::random::philox(0, 0, 0, 0, 0, 0);
+	EXPECT_EQ(0x6627e8d5u, zero[0]);
+	EXPECT_EQ(0xe169c58du, zero[1]);
+	EXPECT_EQ(0xbc57ac4cu, zero[2]);
+	EXPECT_EQ(0x9b00dbd8u, zero[3]);
+
+	Philox4x32::Block ones = detail::random::philox(0xffffffff, 0xffffffff,
+							0xffffffff, 0xffffffff,
+							0xffffffff, 0xffffffff);
+	EXPECT_EQ(0x408f276du, ones[0]);
+	EXPECT_EQ(0x41c83b0eu, ones[1]);
+	EXPECT_EQ(0xa20bc7c6u, ones[2]);
+	EXPECT_EQ(0x6d5451fdu, ones[3]);
+
+	Philox4x32::Block pi = detail::random::philox(0x243f6a88, 0x85a308d3,
+						      0x13198a2e, 0x03707344,
+						      0xa4093822, 0x299f31d0);
+	EXPECT_EQ(0xd16cfe09u, pi[0]);
+	EXPECT_EQ(0x94fdccebu, pi[1]);
+	EXPECT_EQ(0x5001e420u, pi[2]);
+	EXPECT_EQ(0x24126ea1u, pi[3]);
+}
+
+TEST(RandomTest, test01_generator) {
+	Philox4x32 generator(42);
+	Philox4x32::Block first = generator[0];
+	Philox4x32::Block second = generator[1];
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(first[i], generator());
+	}
+	generator.discard(1);
+	EXPECT_EQ(second[1], generator());
+
+	// Different streams and seeds give different sequences.
+	EXPECT_NE(first, Philox4x32(42, 1)[0]);
+	EXPECT_NE(first, Philox4x32(43)[0]);
+
+	// It works with the standard distributions.
+	uniform_int_distribution<int> dice(1, 6);
+	for (int i = 0; i < 100; ++i) {
+		int roll = dice(generator);
+		EXPECT_LE(1, roll);
+		EXPECT_GE(6, roll);
+	}
+}
+
+TEST(RandomTest, test02_splitting) {
+	// Filling pieces of an array, at odd offsets and lengths, gives the
+	// same values as filling it all at once.
+	Philox4x32 generator(7, 3);
+	NormalQuantityDistribution<FastLength> distribution(1_m, 1_mm);
+
+	vector<FastLength> whole(1001);
+	distribution.Fill(generator, whole);
+
+	vector<FastLength> pieces(whole.size());
+	QuantitySpan<FastLength> span(pieces);
+	distribution.Fill(generator, span.subspan(0, 333), 0);
+	distribution.Fill(generator, span.subspan(333, 1), 333);
+	distribution.Fill(generator, span.subspan(334, 667), 334);
+
+	for (size_t i = 0; i < whole.size(); ++i) {
+		EXPECT_EQ(whole[i].Value(), pieces[i].Value()) << i;
+	}
+}
+
+TEST(RandomTest, test03_distributions) {
+	Philox4x32 generator(2014);
+	vector<FastLength> lengths(1 << 20);
+	double mean, deviation;
+
+	UniformQuantityDistribution<FastLength> uniform(2_m, 5_m);
+	uniform.Fill(generator, lengths);
+	for (const FastLength& length : lengths) {
+		ASSERT_LE(2, length.Value());
+		ASSERT_GT(5, length.Value());
+	}
+	moments(lengths, mean, deviation);
+	EXPECT_NEAR(3.5, mean, 0.01);
+	EXPECT_NEAR(3 / sqrt(12), deviation, 0.01);
+
+	NormalQuantityDistribution<FastLength> normal(10_m, 2_m);
+	normal.Fill(generator, lengths);
+	moments(lengths, mean, deviation);
+	EXPECT_NEAR(10, mean, 0.01);
+	EXPECT_NEAR(2, deviation, 0.01);
+
+	vector<FastMass> masses(1 << 20);
+	LognormalQuantityDistribution<FastMass> lognormal(3_kg, 0.25);
+	lognormal.Fill(generator, masses);
+	moments(masses, mean, deviation);
+	double expectedMean = 3 * exp(0.25 * 0.25 / 2);
+	EXPECT_NEAR(expectedMean, mean, 0.01);
+	EXPECT_NEAR(expectedMean * sqrt(exp(0.25 * 0.25) - 1), deviation, 0.01);
+
+	// Drawing one value at a time from another generator.
+	mt19937_64 engine(1);
+	NormalQuantityDistribution<Length> single(10_m, 2_m);
+	vector<Length> draws(1 << 16);
+	for (Length& draw : draws) {
+		draw = single(engine);
+	}
+	double sum = 0;
+	for (const Length& draw : draws) {
+		sum += draw.Value();
+	}
+	EXPECT_NEAR(10, sum / draws.size(), 0.05);
+}
+
+TEST(RandomTest, test04_kernels) {
+	// The vectorizable log, exp and sqrt behind the distributions.
+	mt19937_64 engine(5);
+	uniform_real_distribution<double> exponents(-40, 40);
+	double logError = 0, expError = 0, sqrtError = 0;
+	for (int i = 0; i < 100000; ++i) {
+		double x = exponents(engine);
+		double y = exp(x);
+		logError = fmax(logError, fabs(detail::random::logKernel(y) - log(y)) /
+					  fmax(fabs(log(y)), 1e-300));
+		expError = fmax(expError, fabs(detail::random::expKernel(x) - y) / y);
+		sqrtError = fmax(sqrtError, fabs(detail::random::sqrtKernel(y) - sqrt(y)) / sqrt(y));
+	}
+	EXPECT_GT(4e-16, logError);
+	EXPECT_GT(4e-16, expError);
+	EXPECT_GT(4e-16, sqrtError);
+
+	EXPECT_EQ(0, detail::random::logKernel(1.0));
+	EXPECT_EQ(1, detail::random::expKernel(0.0));
+	EXPECT_EQ(numeric_limits<double>::infinity(), detail::random::expKernel(1000));
+	EXPECT_EQ(0, detail::random::expKernel(-1000));
+	EXPECT_EQ(0, detail::random::sqrtKernel(0.0));
+	EXPECT_NEAR(-36.7368005696771, detail::random::logKernel(1.0 / 9007199254740992.0), 1e-12);
+}
@@ -0,0 +1,109 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_statistics.h>
+
+using namespace std;
+
+constexpr double tolerance = 1e-12;
+
+TEST(StatisticsTest, test00_empty) {
+	QuantityStatistics<Time> stats;
+	EXPECT_EQ(0u, stats.Count());
+	EXPECT_EQ(0, stats.Mean().Value());
+}
+
+TEST(StatisticsTest, test01_moments) {
+	QuantityStatistics<Time> stats;
+	stats += 1_s;
+	stats += 2_s;
+	stats += 3_s;
+	stats += 10_s;
+
+	EXPECT_EQ(4u, stats.Count());
+	EXPECT_NEAR(4.0, stats.Mean().Value(), tolerance);
+	EXPECT_NEAR(12.5, stats.PopulationVariance().Value(), tolerance);
+	EXPECT_NEAR(50.0 / 3, stats.SampleVariance().Value(), tolerance);
+	EXPECT_NEAR(sqrt(12.5), stats.PopulationStandardDeviation().Value(), tolerance);
+	EXPECT_NEAR(sqrt(50.0 / 3), stats.SampleStandardDeviation().Value(), tolerance);
+	EXPECT_NEAR(1.0182337649086284, stats.Skewness(), tolerance);
+	EXPECT_NEAR(-0.7696, stats.Kurtosis(), tolerance);
+	EXPECT_EQ(1, stats.Min().Value());
+	EXPECT_EQ(10, stats.Max().Value());
+}
+
+TEST(StatisticsTest, test02_dimensions) {
+	QuantityStatistics<Length> stats;
+	stats += 1_mm;
+
+	Length mean = stats.Mean();
+	Area variance = stats.PopulationVariance();
+	Length deviation = stats.PopulationStandardDeviation();
+	EXPECT_EQ(0, variance.Value());
+	EXPECT_EQ(0, deviation.Value());
+	EXPECT_NEAR(1e-3, mean.Value(), tolerance);
+
+	typedef QuantityStatistics<Length>::Variance Variance;
+	static_assert(Variance::length == 2, "variance has squared dimension");
+	static_assert(Variance::time == 0, "variance has squared dimension");
+}
+
+TEST(StatisticsTest, test03_numericalStability) {
+	// A large offset destroys the naive sum-of-squares formula.
+	QuantityStatistics<Time> stats;
+	for (int i = 0; i < 1000; ++i) {
+		stats += Time(1e9L + (i % 2 ? 1 : -1));
+	}
+	EXPECT_NEAR(1e9, stats.Mean().Value(), 1e-6);
+	EXPECT_NEAR(1.0, stats.PopulationVariance().Value(), 1e-6);
+}
+
+TEST(StatisticsTest, test04_merge) {
+	QuantityStatistics<Length> whole;
+	QuantityStatistics<Length> first;
+	QuantityStatistics<Length> second;
+	QuantityStatistics<Length> empty;
+
+	for (int i = 0; i < 100; ++i) {
+		Length x = Length(i * i * 0.01L);
+		whole += x;
+		(i < 30 ? first : second) += x;
+	}
+
+	first.Merge(second).Merge(empty);
+	EXPECT_EQ(whole.Count(), first.Count());
+	EXPECT_NEAR(whole.Mean().Value(), first.Mean().Value(), tolerance);
+	EXPECT_NEAR(whole.PopulationVariance().Value(),
+		    first.PopulationVariance().Value(),
+		    tolerance * whole.PopulationVariance().Value());
+	EXPECT_NEAR(whole.Skewness(), first.Skewness(), tolerance);
+	EXPECT_NEAR(whole.Kurtosis(), first.Kurtosis(), tolerance);
+	EXPECT_EQ(whole.Min().Value(), first.Min().Value());
+	EXPECT_EQ(whole.Max().Value(), first.Max().Value());
+
+	empty.Merge(whole);
+	EXPECT_EQ(whole.Count(), empty.Count());
+	EXPECT_EQ(whole.Mean().Value(), empty.Mean().Value());
+}
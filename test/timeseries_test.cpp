@@ -0,0 +1,142 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_timeseries.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+TEST(TimeSeriesTest, test00_push) {
+	QuantityRingBuffer<Length, 4> buffer;
+	EXPECT_TRUE(buffer.Empty());
+
+	buffer.Push(1_s, 10_m);
+	buffer.Push(2_s, 20_m);
+	EXPECT_EQ(2u, buffer.Size());
+	EXPECT_FALSE(buffer.Full());
+	EXPECT_EQ(1, buffer.TimeAt(0).Value());
+	EXPECT_EQ(20, buffer.ValueAt(1).Value());
+}
+
+TEST(TimeSeriesTest, test01_eviction) {
+	QuantityRingBuffer<Length, 3> buffer;
+	for (int i = 1; i <= 5; ++i) {
+		buffer.Push(Time(i), Length(i * 10));
+	}
+
+	EXPECT_TRUE(buffer.Full());
+	EXPECT_EQ(3u, buffer.Size());
+	EXPECT_EQ(3, buffer.TimeAt(0).Value());
+	EXPECT_EQ(30, buffer.ValueAt(0).Value());
+	EXPECT_EQ(50, buffer.ValueAt(2).Value());
+}
+
+TEST(TimeSeriesTest, test02_aggregates) {
+	QuantityRingBuffer<Temperature, 3> buffer;
+
+	buffer.Push(0_s, 5_K);
+	EXPECT_EQ(5, buffer.Min().Value());
+	EXPECT_EQ(5, buffer.Max().Value());
+
+	buffer.Push(1_s, 1_K);
+	buffer.Push(2_s, 3_K);
+	EXPECT_EQ(9, buffer.Sum().Value());
+	EXPECT_EQ(3, buffer.Mean().Value());
+	EXPECT_EQ(1, buffer.Min().Value());
+	EXPECT_EQ(5, buffer.Max().Value());
+
+	// Evicts 5 K, the maximum.
+	buffer.Push(3_s, 2_K);
+	EXPECT_EQ(6, buffer.Sum().Value());
+	EXPECT_EQ(1, buffer.Min().Value());
+	EXPECT_EQ(3, buffer.Max().Value());
+
+	// Evicts 1 K, the minimum.
+	buffer.Push(4_s, 4_K);
+	EXPECT_EQ(2, buffer.Min().Value());
+	EXPECT_EQ(4, buffer.Max().Value());
+}
+
+TEST(TimeSeriesTest, test03_slidingWindowAgainstBruteForce) {
+	constexpr size_t capacity = 16;
+	QuantityRingBuffer<Length, capacity> buffer;
+	vector<long double> history;
+
+	uint32_t state = 12345;
+	for (int i = 0; i < 500; ++i) {
+		state = state * 1664525u + 1013904223u;
+		long double value = state % 1000;
+		buffer.Push(Time(i), Length(value));
+		history.push_back(value);
+
+		auto window = history.end() - min(history.size(), capacity);
+		ASSERT_EQ(*min_element(window, history.end()), buffer.Min().Value());
+		ASSERT_EQ(*max_element(window, history.end()), buffer.Max().Value());
+	}
+}
+
+TEST(TimeSeriesTest, test04_snapshots) {
+	QuantityRingBuffer<Length, 4> buffer;
+	for (int i = 0; i < 6; ++i) {
+		buffer.Push(Time(i), Length(i));
+	}
+
+	auto values = buffer.Values();
+	auto times = buffer.Times();
+	EXPECT_EQ(4u, values.first.size() + values.second.size());
+	EXPECT_EQ(2u, values.first.size());
+	EXPECT_EQ(2, values.first[0].Value());
+	EXPECT_EQ(4, values.second[0].Value());
+	EXPECT_EQ(2, times.first[0].Value());
+
+	buffer.Linearize();
+	values = buffer.Values();
+	EXPECT_EQ(4u, values.first.size());
+	EXPECT_TRUE(values.second.empty());
+	for (size_t i = 0; i < 4; ++i) {
+		EXPECT_EQ(i + 2, values.first[i].Value());
+	}
+
+	// Aggregates survive the rotation.
+	buffer.Push(6_s, 6_m);
+	EXPECT_EQ(3, buffer.Min().Value());
+	EXPECT_EQ(6, buffer.Max().Value());
+	EXPECT_EQ(3, buffer.ValueAt(0).Value());
+}
+
+TEST(TimeSeriesTest, test05_clear) {
+	QuantityRingBuffer<Length, 2> buffer;
+	buffer.Push(0_s, 1_m);
+	buffer.Push(1_s, 2_m);
+	buffer.Clear();
+	EXPECT_TRUE(buffer.Empty());
+
+	buffer.Push(2_s, 7_m);
+	EXPECT_EQ(7, buffer.Min().Value());
+	EXPECT_EQ(7, buffer.Sum().Value());
+}
@@ -0,0 +1,197 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_trig.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+typedef Quantity<0, 0, 0, 0, 0, 0, 0, double, AngleFormat> FastAngle;
+typedef Quantity<1, 0, 0, 0, 0, 0, 0, double> FastLength;
+
+// The error of actual, in units of the last place of expected.
+static double ulps(double actual, double expected) {
+	double ulp = nextafter(fabs(expected), numeric_limits<double>::infinity()) -
+		     fabs(expected);
+	return fabs(actual - expected) / ulp;
+}
+
+static vector<double> randomAngles(double range, int count) {
+	mt19937_64 generator(42);
+	uniform_real_distribution<double> distribution(-range, range);
+	vector<double> angles(count);
+	for (double& angle : angles) {
+		angle = distribution(generator);
+	}
+	return angles;
+}
+
+TEST(TrigTest, test00_preciseAccuracy) {
+	double sinError = 0, cosError = 0, tanError = 0;
+	for (double x : randomAngles(100, 100000)) {
+		sinError = fmax(sinError, ulps(sin(FastAngle(x)), std::sin(x)));
+		cosError = fmax(cosError, ulps(cos(FastAngle(x)), std::cos(x)));
+		tanError = fmax(tanError, ulps(tan(FastAngle(x)), std::tan(x)));
+	}
+	EXPECT_LE(sinError, 1);
+	EXPECT_LE(cosError, 1);
+	EXPECT_LE(tanError, 3);
+
+	double atanError = 0;
+	vector<double> ys = randomAngles(10, 100000);
+	vector<double> xs = randomAngles(1000, 100000);
+	for (size_t i = 0; i < ys.size(); ++i) {
+		Angle a1 = atan2(Length(ys[i]), Length(xs[i]));
+		Angle a2 = atan2(Length(xs[i]), Length(ys[i]));
+		atanError = fmax(atanError, ulps(a1.Value(), std::atan2(ys[i], xs[i])));
+		atanError = fmax(atanError, ulps(a2.Value(), std::atan2(xs[i], ys[i])));
+	}
+	EXPECT_LE(atanError, 2);
+}
+
+TEST(TrigTest, test01_fastAccuracy) {
+	double error = 0;
+	for (double x : randomAngles(100, 100000)) {
+		error = fmax(error, fabs(sin<FastTrig>(FastAngle(x)) - std::sin(x)));
+		error = fmax(error, fabs(cos<FastTrig>(FastAngle(x)) - std::cos(x)));
+		error = fmax(error, fabs(atan2<FastTrig>(x * 1_m, 1_m).Value() - std::atan2(x, 1)));
+	}
+	EXPECT_LE(error, 1e-7);
+}
+
+TEST(TrigTest, test02_specialValues) {
+	EXPECT_EQ(0, sin(0_rad));
+	EXPECT_EQ(1, cos(0_rad));
+	EXPECT_EQ(1, sin(FastAngle(M_PI / 2)));
+	EXPECT_NEAR(-1, cos(FastAngle(M_PI)), 1e-16);
+	EXPECT_TRUE(std::signbit(sin(FastAngle(-0.0))));
+
+	// Beyond Limit, Payne and Hanek's reduction, and libm for non-finite values.
+	EXPECT_EQ(std::sin(1e10), sin(FastAngle(1e10)));
+	EXPECT_TRUE(std::isnan(sin(FastAngle(numeric_limits<double>::infinity()))));
+	EXPECT_TRUE(std::isnan(cos(FastAngle(numeric_limits<double>::quiet_NaN()))));
+
+	pair<double, double> sc = sincos(FastAngle(0.5));
+	EXPECT_EQ(sin(FastAngle(0.5)), sc.first);
+	EXPECT_EQ(cos(FastAngle(0.5)), sc.second);
+
+	double zero = 0;
+	EXPECT_EQ(std::atan2(zero, zero), atan2(0_m, 0_m).Value());
+	EXPECT_EQ(std::atan2(zero, -zero), atan2(0_m, -0_m).Value());
+	EXPECT_EQ(std::atan2(-zero, -zero), atan2(-0_m, -0_m).Value());
+	EXPECT_EQ(std::atan2(1.0, zero), atan2(1_s, 0_s).Value());
+	EXPECT_EQ(std::atan2(-1.0, -zero), atan2(-1_s, -0_s).Value());
+	double inf = numeric_limits<double>::infinity();
+	EXPECT_EQ(std::atan2(inf, inf), atan2(Length(inf), Length(inf)).Value());
+
+	EXPECT_NEAR(M_PI / 4, atan(m / m).Value(), 1e-16);
+}
+
+TEST(TrigTest, test03_spans) {
+	vector<double> values = randomAngles(10, 1001);
+	values.push_back(1e10);
+	vector<FastAngle> angles;
+	vector<FastLength> lengths;
+	for (double v : values) {
+		angles.push_back(FastAngle(v));
+		lengths.push_back(FastLength(v));
+	}
+
+	vector<double> sines(angles.size());
+	vector<double> cosines(angles.size());
+	vector<double> tangents(angles.size());
+	sincos(QuantitySpan<const FastAngle>(angles),
+	       QuantitySpan<double>(sines),
+	       QuantitySpan<double>(cosines));
+	tan<FastTrig>(QuantitySpan<const FastAngle>(angles), QuantitySpan<double>(tangents));
+
+	vector<FastAngle> headings(angles.size());
+	atan2(QuantitySpan<const FastLength>(lengths),
+	      QuantitySpan<const FastLength>(lengths).subspan(0, lengths.size()),
+	      QuantitySpan<FastAngle>(headings));
+
+	for (size_t i = 0; i < angles.size(); ++i) {
+		EXPECT_EQ(sin(angles[i]), sines[i]);
+		EXPECT_EQ(cos(angles[i]), cosines[i]);
+		EXPECT_EQ(tan<FastTrig>(angles[i]), tangents[i]);
+		EXPECT_EQ(atan2(lengths[i], lengths[i]).Value(), headings[i].Value());
+	}
+}
+
+TEST(TrigTest, test04_arrays) {
+	array<Angle, 3> angles = {{ 0_rad, 1_rad, 2_rad }};
+	array<double, 3> sines = sin(angles);
+	array<double, 3> cosines = cos<FastTrig>(angles);
+	for (size_t i = 0; i < angles.size(); ++i) {
+		EXPECT_EQ(sin(angles[i]), sines[i]);
+		EXPECT_EQ(cos<FastTrig>(angles[i]), cosines[i]);
+	}
+
+	array<Length, 2> ys = {{ 1_m, -1_m }};
+	array<Length, 2> xs = {{ -1_m, -1_m }};
+	array<Angle, 2> headings = atan2(ys, xs);
+	EXPECT_NEAR(3 * M_PI / 4, headings[0].Value(), 1e-15);
+	EXPECT_NEAR(-3 * M_PI / 4, headings[1].Value(), 1e-15);
+}
+
+TEST(TrigTest, test05_reduction) {
+	// Next to multiples of pi/2, where the reduced argument loses the most
+	// bits, and beyond Limit, where Payne and Hanek's reduction takes over.
+	// The expected values are correctly rounded.
+	struct Case {
+		double x, sine, cosine, tangent;
+	};
+	vector<Case> cases = {
+		{ -2915.3979825313281, -3.9614760741654893e-17, 1, -3.9614760741654893e-17 },
+		{ 1.5707963267948966, 1, 6.123233995736766e-17, 16331239353195370 },
+		{ 557.63269601218826, -1, -3.7724692239467775e-14, 26507837191943.867 },
+		{ 1570796.3267948965, -1.1159560906804355e-10, 1, -1.1159560906804355e-10 },
+		{ 1e22, -0.85220084976718879, 0.52321478539513899, -1.6287782256068988 },
+		{ 5.3193726483265414e255, 1, -4.6871659242546277e-19, -2.1334853857537039e18 },
+		{ 1e300, -0.81788191211590855, -0.57538611195754907, 1.4214488238747245 },
+	};
+	vector<FastAngle> angles;
+	for (const Case& c : cases) {
+		for (double sign : { 1.0, -1.0 }) {
+			FastAngle x(sign * c.x);
+			EXPECT_LE(ulps(sin(x), sign * c.sine), 1) << x.Value();
+			EXPECT_LE(ulps(cos(x), c.cosine), 1) << x.Value();
+			EXPECT_LE(ulps(tan(x), sign * c.tangent), 2) << x.Value();
+			angles.push_back(x);
+		}
+	}
+
+	vector<double> sines(angles.size());
+	sin(QuantitySpan<const FastAngle>(angles), QuantitySpan<double>(sines));
+	for (size_t i = 0; i < angles.size(); ++i) {
+		EXPECT_EQ(sin(angles[i]), sines[i]);
+		EXPECT_EQ(sin(angles[i]), sincos(angles[i]).first);
+	}
+}
@@ -0,0 +1,136 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_math.h>
+#include <btul_uncertain.h>
+
+#include <cmath>
+#include <sstream>
+
+using namespace std;
+
+typedef Uncertain<double> U;
+typedef CorrelatedUncertain<double> C;
+
+TEST(UncertainTest, test00_independent) {
+	U a(10, 0.3);
+	U b(5, 0.4);
+
+	U sum = a + b;
+	EXPECT_DOUBLE_EQ(15, sum.Value());
+	EXPECT_DOUBLE_EQ(0.5, sum.Deviation());
+
+	U product = a * b;
+	EXPECT_DOUBLE_EQ(50, product.Value());
+	EXPECT_DOUBLE_EQ(sqrt(1.5 * 1.5 + 4.0 * 4.0), product.Deviation());
+
+	U quotient = a / b;
+	EXPECT_DOUBLE_EQ(2, quotient.Value());
+	EXPECT_DOUBLE_EQ(sqrt(0.06 * 0.06 + 0.16 * 0.16), quotient.Deviation());
+
+	U scaled = 2 * a - 1;
+	EXPECT_DOUBLE_EQ(19, scaled.Value());
+	EXPECT_DOUBLE_EQ(0.6, scaled.Deviation());
+
+	// A measurement is treated as independent of itself.
+	EXPECT_DOUBLE_EQ(0.3 * sqrt(2.0), (a - a).Deviation());
+
+	EXPECT_DOUBLE_EQ(0.6 * 10, pow(a, 2).Deviation());
+	EXPECT_DOUBLE_EQ(0.3 / (2 * sqrt(10.0)), sqrt(a).Deviation());
+	EXPECT_DOUBLE_EQ(0.3, abs(-a).Deviation());
+
+	ostringstream stream;
+	stream << a;
+	EXPECT_EQ("10 ± 0.3", stream.str());
+}
+
+TEST(UncertainTest, test01_correlated) {
+	C a(10, 0.3);
+	C b(5, 0.4);
+
+	EXPECT_DOUBLE_EQ(0.5, (a + b).Deviation());
+	EXPECT_DOUBLE_EQ(0, (a - a).Deviation());
+	EXPECT_EQ(0u, (a - a).Dependencies());
+	EXPECT_DOUBLE_EQ(0.6, (a + a).Deviation());
+	EXPECT_DOUBLE_EQ((a * a).Deviation(), pow(a, 2).Deviation());
+
+	C c = a * b;
+	EXPECT_DOUBLE_EQ(sqrt(1.5 * 1.5 + 4.0 * 4.0), c.Deviation());
+	EXPECT_EQ(2u, c.Dependencies());
+
+	// a / (a + b) depends on a through both operands.
+	C ratio = a / (a + b);
+	double da = 5.0 / (15 * 15);
+	double db = -10.0 / (15 * 15);
+	EXPECT_NEAR(sqrt(da * da * 0.09 + db * db * 0.16), ratio.Deviation(), 1e-15);
+
+	EXPECT_DOUBLE_EQ(0.09, a.Covariance(a));
+	EXPECT_DOUBLE_EQ(0, a.Covariance(b));
+	EXPECT_DOUBLE_EQ(5 * 0.09, c.Covariance(a));
+
+	C exact(3);
+	EXPECT_EQ(0u, exact.Dependencies());
+	EXPECT_DOUBLE_EQ(0, (exact * a).Covariance(b));
+}
+
+TEST(UncertainTest, test02_quantities) {
+	Quantity<0, 1, 0, 0, 0, 0, 0, U> mass = U(2, 0.1) * kg;
+	Quantity<1, 0, -1, 0, 0, 0, 0, U> speed = U(3, 0.2) * m / s;
+	auto energy = 0.5 * mass * speed.p2();
+
+	Energy value = ValueOf(energy);
+	Energy deviation = DeviationOf(energy);
+	EXPECT_NEAR(9, value.Value(), 1e-12);
+	EXPECT_NEAR(sqrt(0.45 * 0.45 + 1.2 * 1.2), deviation.Value(), 1e-12);
+
+	auto length = Quantity<1, 0, 0, 0, 0, 0, 0, U>(U(1.5, 0.1));
+	ostringstream stream;
+	stream << length;
+	EXPECT_EQ("1.5 ± 0.1 m", stream.str());
+
+	// The factors are treated as independent, so this is not length.
+	auto side = sqrt(length * length);
+	EXPECT_NEAR(0.1 / sqrt(2.0), DeviationOf(side).Value(), 1e-12);
+}
+
+TEST(UncertainTest, test03_correlatedQuantities) {
+	Quantity<1, 0, 0, 0, 0, 0, 0, C> width(C(2, 0.01));
+	Quantity<1, 0, 0, 0, 0, 0, 0, C> height(C(3, 0.02));
+
+	auto perimeter = 2 * (width + height);
+	auto area = width * height;
+	EXPECT_NEAR(2 * sqrt(0.01 * 0.01 + 0.02 * 0.02), DeviationOf(perimeter).Value(), 1e-12);
+	EXPECT_NEAR(sqrt(0.03 * 0.03 + 0.04 * 0.04), DeviationOf(area).Value(), 1e-12);
+
+	// Both grow with either side, so they are positively correlated.
+	Quantity<3, 0, 0, 0, 0, 0, 0> covariance = Covariance(perimeter, area);
+	EXPECT_NEAR(2 * (3 * 0.01 * 0.01 + 2 * 0.02 * 0.02), covariance.Value(), 1e-12);
+
+	auto diagonal = hypot(width, height);
+	double d = sqrt(13.0);
+	EXPECT_NEAR(sqrt(pow(2 / d * 0.01, 2) + pow(3 / d * 0.02, 2)),
+		    DeviationOf(diagonal).Value(), 1e-12);
+	EXPECT_NEAR(0, DeviationOf(diagonal - hypot(width, height)).Value(), 1e-12);
+}
@@ -0,0 +1,115 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+// Also checks that btul.h and the headers built on it do without the power
+// literals.
+#define NO_POWER_LITERALS
+
+#include <btul.h>
+#include <btul_constants.h>
+#include <btul_unit_literal.h>
+#include <btul_units.h>
+
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+static_assert(is_same<UNIT_TYPE("kg*m/s^2"), decltype(kg * m / (s * s))>::value,
+	      "Same type as the operators");
+static_assert(is_same<UNIT_TYPE("kg·m·s⁻²"), UNIT_TYPE("kg m s-2")>::value,
+	      "Same type for every spelling");
+static_assert(is_same<UNIT_TYPE("J/(kg·K)"), decltype(J / (kg * K))>::value,
+	      "Parentheses");
+static_assert(is_same<UNIT_TYPE("m/m"), Quantity<0, 0, 0, 0, 0, 0, 0>>::value,
+	      "Dimensionless");
+static_assert(is_same<UNIT_TYPE(""), Quantity<0, 0, 0, 0, 0, 0, 0>>::value,
+	      "Empty");
+static_assert(is_same<UNIT_TYPE("km^2"), decltype(m.p2())>::value, "Powers");
+
+// Resolved by the compiler.
+constexpr auto speed = 90 * UNIT("km/h");
+static_assert(speed.Value() > 24.999 && speed.Value() < 25.001, "90 km/h");
+static_assert(UNIT("mmol").Value() == 1e-3L, "Prefixes");
+static_assert(UNIT("mol").Value() == 1, "Exact symbols before prefixes");
+static_assert(UNIT("Pa").Value() == 1 && UNIT("PPa").Value() == 1e15L, "Pascal, not peta");
+static_assert(UNIT("fm").Value() == 1e-15L && UNIT("EJ").Value() == 1e18L, "Every SI prefix");
+
+template <class Q>
+static void expectSame(const string& text, Q unit) {
+	ParsedUnit parsed = ParseUnit(text);
+	EXPECT_TRUE(parsed.Is<Q>()) << text;
+	EXPECT_EQ(parsed.scale, unit.Value()) << text;
+}
+
+TEST(UnitLiteralTest, test00_sameAsParseUnit) {
+	expectSame("m", UNIT("m"));
+	expectSame("kg", UNIT("kg"));
+	expectSame("g", UNIT("g"));
+	expectSame("mmol", UNIT("mmol"));
+	expectSame("cd", UNIT("cd"));
+	expectSame("hPa", UNIT("hPa"));
+	expectSame("dam", UNIT("dam"));
+	expectSame("um", UNIT("um"));
+	expectSame("\xc2\xb5m", UNIT("\xc2\xb5m"));
+	expectSame("h", UNIT("h"));
+	expectSame("min", UNIT("min"));
+	expectSame("mL", UNIT("mL"));
+	expectSame("kV", UNIT("kV"));
+	expectSame("", UNIT(""));
+	expectSame("km/h", UNIT("km/h"));
+	expectSame("m s^-2", UNIT("m s^-2"));
+	expectSame("m*s-2", UNIT("m*s-2"));
+	expectSame("m/s2", UNIT("m/s2"));
+	expectSame("m/s/s", UNIT("m/s/s"));
+	expectSame("J/(kg.K)", UNIT("J/(kg.K)"));
+	expectSame("1/s", UNIT("1/s"));
+	expectSame("(km/h)^2", UNIT("(km/h)^2"));
+	expectSame(" cm^+3 ", UNIT(" cm^+3 "));
+	expectSame("m²·kg/(s²·K·mol)", UNIT("m²·kg/(s²·K·mol)"));
+	expectSame("s⁻¹⁰", UNIT("s⁻¹⁰"));
+}
+
+TEST(UnitLiteralTest, test01_sameAsOperators) {
+	EXPECT_EQ((km / s).Value(), UNIT("km/s").Value());
+	EXPECT_EQ(km.p2().Value(), UNIT("km^2").Value());
+	EXPECT_EQ(kg.Value(), UNIT("kg").Value());
+	// The literals in btul.h scale by 10^-9 in double precision, and
+	// ParseUnit and UNIT in long double.
+	EXPECT_DOUBLE_EQ((1 / ns).Value(), UNIT("1/ns").Value());
+	Force f = 2 * UNIT("kN");
+	EXPECT_EQ(2000, f.Value());
+	EXPECT_EQ(constants::g_n.Value(), (9.80665L * UNIT("m/s^2")).Value());
+}
+
+TEST(UnitLiteralTest, test02_errors) {
+	// UNIT() fails to compile exactly where the parser throws, which can
+	// be checked by running it.
+	using detail::unitliteral::parse;
+	EXPECT_THROW(parse("10 m"), UnitError);
+	EXPECT_THROW(parse("100 ms"), UnitError);
+	EXPECT_THROW(parse("furlong"), UnitError);
+	EXPECT_THROW(parse("m^65"), UnitError);
+	EXPECT_EQ(-1, parse("1/s").time);
+}
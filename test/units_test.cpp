@@ -0,0 +1,204 @@
+/* The MIT License (MIT)
+
+Copyright (c) 2014 Isaac Supeene
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <gtest/gtest.h>
+
+#include <btul.h>
+#include <btul_units.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+typedef decltype(m / s) Speed;
+typedef decltype(m / s_p2) Acceleration;
+typedef decltype(J / (kg * K)) SpecificHeat;
+
+static void expectUnit(const string& text,
+		       int l, int m, int t, int i, int theta, int n, int j,
+		       long double scale)
+{
+	ParsedUnit unit = ParseUnit(text);
+	int expected[] = {l, m, t, i, theta, n, j};
+	for (int k = 0; k < 7; ++k) {
+		EXPECT_EQ(expected[k], unit.exponents[k]) << text << ", exponent " << k;
+	}
+	EXPECT_NEAR(1, unit.scale / scale, 1e-15) << text;
+}
+
+TEST(UnitsTest, test00_symbolsAndPrefixes) {
+	expectUnit("m", 1, 0, 0, 0, 0, 0, 0, 1);
+	expectUnit("kg", 0, 1, 0, 0, 0, 0, 0, 1);
+	expectUnit("g", 0, 1, 0, 0, 0, 0, 0, 1e-3L);
+	expectUnit("mol", 0, 0, 0, 0, 0, 1, 0, 1);
+	expectUnit("mmol", 0, 0, 0, 0, 0, 1, 0, 1e-3L);
+	expectUnit("cd", 0, 0, 0, 0, 0, 0, 1, 1);
+	expectUnit("Pa", -1, 1, -2, 0, 0, 0, 0, 1);
+	expectUnit("hPa", -1, 1, -2, 0, 0, 0, 0, 100);
+	expectUnit("dam", 1, 0, 0, 0, 0, 0, 0, 10);
+	expectUnit("um", 1, 0, 0, 0, 0, 0, 0, 1e-6L);
+	expectUnit("\xc2\xb5m", 1, 0, 0, 0, 0, 0, 0, 1e-6L);
+	expectUnit("h", 0, 0, 1, 0, 0, 0, 0, 3600);
+	expectUnit("min", 0, 0, 1, 0, 0, 0, 0, 60);
+	expectUnit("mL", 3, 0, 0, 0, 0, 0, 0, 1e-6L);
+	expectUnit("kV", 2, 1, -3, -1, 0, 0, 0, 1e3L);
+	expectUnit("PJ", 2, 1, -2, 0, 0, 0, 0, 1e15L);
+	expectUnit("EJ", 2, 1, -2, 0, 0, 0, 0, 1e18L);
+	expectUnit("Ym", 1, 0, 0, 0, 0, 0, 0, 1e24L);
+	expectUnit("fm", 1, 0, 0, 0, 0, 0, 0, 1e-15L);
+	expectUnit("am", 1, 0, 0, 0, 0, 0, 0, 1e-18L);
+	expectUnit("zmol", 0, 0, 0, 0, 0, 1, 0, 1e-21L);
+	expectUnit("ys", 0, 0, 1, 0, 0, 0, 0, 1e-24L);
+	expectUnit("PPa", -1, 1, -2, 0, 0, 0, 0, 1e15L);
+	expectUnit("aPa", -1, 1, -2, 0, 0, 0, 0, 1e-18L);
+	expectUnit("", 0, 0, 0, 0, 0, 0, 0, 1);
+}
+
+TEST(UnitsTest, test01_expressions) {
+	expectUnit("km/h", 1, 0, -1, 0, 0, 0, 0, 1000.0L / 3600);
+	expectUnit("m/s^2", 1, 0, -2, 0, 0, 0, 0, 1);
+	expectUnit("m s^-2", 1, 0, -2, 0, 0, 0, 0, 1);
+	expectUnit("m*s-2", 1, 0, -2, 0, 0, 0, 0, 1);
+	expectUnit("m/s2", 1, 0, -2, 0, 0, 0, 0, 1);
+	expectUnit("m/s/s", 1, 0, -2, 0, 0, 0, 0, 1);
+	expectUnit("J/(kg.K)", 2, 0, -2, 0, -1, 0, 0, 1);
+	expectUnit("1/s", 0, 0, -1, 0, 0, 0, 0, 1);
+	expectUnit("(km/h)^2", 2, 0, -2, 0, 0, 0, 0, 1e6L / (3600.0L * 3600));
+	expectUnit("cm^3", 3, 0, 0, 0, 0, 0, 0, 1e-6L);
+}
+
+TEST(UnitsTest, test02_roundTripsPrintedUnits) {
+	// Whatever Quantity prints, ParseUnit reads back.
+	ostringstream stream;
+	stream << (3 * J / (kg * K));
+	string printed = stream.str();
+	string units = printed.substr(printed.find(' ') + 1);
+	EXPECT_TRUE(ParseUnit(units).Is<SpecificHeat>()) << units;
+
+	EXPECT_TRUE(ParseUnit("m\xc2\xb7s\xe2\x81\xbb\xc2\xb2").Is<Acceleration>());
+	EXPECT_TRUE(ParseUnit("m\xc2\xb2\xc2\xb7kg/(s\xc2\xb2\xc2\xb7K\xc2\xb7mol)").Is<
+		decltype(m_p2 * kg / (s_p2 * K * mol))>());
+}
+
+TEST(UnitsTest, test03_conversion) {
+	ParsedUnit kmh = ParseUnit("km/h");
+	EXPECT_TRUE(kmh.Is<Speed>());
+	EXPECT_FALSE(kmh.Is<Acceleration>());
+	EXPECT_NEAR(25, kmh.Of<Speed>(90).Value(), 1e-15);
+	EXPECT_THROW(kmh.Of<Acceleration>(90), UnitError);
+}
+
+TEST(UnitsTest, test04_errors) {
+	EXPECT_THROW(ParseUnit("furlong"), UnitError);
+	EXPECT_THROW(ParseUnit("kmin"), UnitError);
+	EXPECT_THROW(ParseUnit("m/"), UnitError);
+	EXPECT_THROW(ParseUnit("(m"), UnitError);
+	EXPECT_THROW(ParseUnit("m^"), UnitError);
+	EXPECT_THROW(ParseUnit("m)"), UnitError);
+	EXPECT_THROW(ParseUnit("m^65"), UnitError);
+	EXPECT_THROW(ParseUnit("m^-99999999999999999999"), UnitError);
+	EXPECT_THROW(ParseUnit("m\xc2\xb9\xe2\x81\x84\xc2\xb2"), UnitError);	// m¹⁄²
+	EXPECT_THROW(ParseUnit("(m^8)^9"), UnitError);
+	EXPECT_NO_THROW(ParseUnit("(m^8)^8"));
+
+	// Scales are not units, and must not be read as exponents of 1.
+	EXPECT_THROW(ParseUnit("10"), UnitError);
+	EXPECT_THROW(ParseUnit("100 ms"), UnitError);
+	EXPECT_THROW(ParseUnit("10 m"), UnitError);
+	EXPECT_THROW(ParseUnit("m/10"), UnitError);
+	EXPECT_THROW(ParseUnit("2 m"), UnitError);
+	EXPECT_TRUE(ParseUnit("1^2/s").Is<decltype(1 / s)>());
+
+	ParsedUnit km = ParseUnit("km");
+	EXPECT_DOUBLE_EQ(1e192, double(km.Power(64).scale));
+	EXPECT_DOUBLE_EQ(1e-192, double(km.Power(-64).scale));
+	EXPECT_THROW(km.Power(65), UnitError);
+
+	try {
+		ParseUnit("kg/fathom");
+		FAIL() << "Expected a UnitError";
+	}
+	catch (const UnitError& e) {
+		EXPECT_EQ(string("Cannot parse unit \"kg/fathom\": unknown unit at offset 3"), e.what());
+	}
+}
+
+TEST(UnitsTest, test05_everyPrefixedSymbol) {
+	using namespace detail::units;
+	for (const Symbol& symbol : SYMBOLS) {
+		for (int k = 0; k < 7; ++k) {
+			EXPECT_EQ(unpacked(symbol).exponents[k], unpack(symbol.dimensions, k));
+		}
+		expectUnit(symbol.name,
+			   unpack(symbol.dimensions, 0), unpack(symbol.dimensions, 1),
+			   unpack(symbol.dimensions, 2), unpack(symbol.dimensions, 3),
+			   unpack(symbol.dimensions, 4), unpack(symbol.dimensions, 5),
+			   unpack(symbol.dimensions, 6), symbol.scale);
+		for (const Prefix& prefix : PREFIXES) {
+			string name = string(prefix.name) + symbol.name;
+			ParsedUnit unit;
+			bool resolved = resolve(name.data(), name.size(), unit);
+			if (!symbol.prefixable) {
+				// Except where the prefix and symbol spell another
+				// symbol.
+				EXPECT_EQ(find(name.data(), name.size()) != nullptr, resolved) << name;
+				continue;
+			}
+			ASSERT_TRUE(resolved) << name;
+			EXPECT_EQ(symbol.scale * prefix.scale, unit.scale) << name;
+			EXPECT_EQ(symbol.dimensions, pack(unit.exponents[0], unit.exponents[1],
+							  unit.exponents[2], unit.exponents[3],
+							  unit.exponents[4], unit.exponents[5],
+							  unit.exponents[6])) << name;
+		}
+	}
+
+	ParsedUnit unit;
+	for (const char* name : {"", "x", "k", "da", "\xc2\xb5", "kmin", "mh", "Pam", "mmol2",
+				 "P", "a", "Emin", "yh"}) {
+		EXPECT_FALSE(resolve(name, strlen(name), unit)) << name;
+	}
+	EXPECT_EQ(-8, unpack(pack(-8, 7, 0, 0, 0, 0, 0), 0));
+	EXPECT_EQ(7, unpack(pack(-8, 7, 0, 0, 0, 0, 0), 1));
+}
+
+TEST(UnitsTest, test06_cache) {
+	// The same expression, over and over, and enough different ones to
+	// evict each other, all parse the same as without the cache.
+	for (int i = 0; i < 3; ++i) {
+		for (int n = 1; n < 200; ++n) {
+			string text = "m^" + to_string(n % 10) + "/s" + to_string(n / 10);
+			ParsedUnit cached = ParseUnit(text);
+			ParsedUnit parsed = detail::units::Parser(text).Parse();
+			for (int k = 0; k < 7; ++k) {
+				ASSERT_EQ(parsed.exponents[k], cached.exponents[k]) << text;
+			}
+			ASSERT_EQ(parsed.scale, cached.scale) << text;
+		}
+	}
+
+	// Errors are not cached.
+	EXPECT_THROW(ParseUnit("kg/fathom"), UnitError);
+	EXPECT_THROW(ParseUnit("kg/fathom"), UnitError);
+}